@@ -59,100 +59,117 @@ SYNFIG_LAYER_SET_CVS_ID(CurveWarp,"$Id$");
 
 /* === P R O C E D U R E S ================================================= */
 
-inline float calculate_distance(const std::vector<synfig::BLinePoint>& bline)
-{
-	std::vector<synfig::BLinePoint>::const_iterator iter,next,ret;
-	std::vector<synfig::BLinePoint>::const_iterator end(bline.end());
+namespace {
 
-	float dist(0);
+//! Keeps track of the closest segment while CurveIndex visits the candidates
+/*!	Segments are visited out of order, so ties are resolved in favour of
+**	the earliest segment of the bline, as a linear search would. */
+struct ClosestSegment
+{
+	const std::vector<etl::hermite<Vector> > &segments;
+	const Point &p;
+	bool fast;
 
-	if (bline.empty()) return dist;
+	int best;
+	float dist;
+	float best_pos;
 
-	next=bline.begin();
-	iter=next++;
+	ClosestSegment(const std::vector<etl::hermite<Vector> > &segments, const Point &p, bool fast):
+		segments(segments),p(p),fast(fast),best(-1),dist(100000000000.0),best_pos(0) { }
 
-	for(;next!=end;iter=next++)
+	void check(int i, float thisdist, float pos)
 	{
-		// Setup the curve
-		etl::hermite<Vector> curve(iter->get_vertex(), next->get_vertex(), iter->get_tangent2(), next->get_tangent1());
-		dist+=curve.length();
+		if(thisdist<dist || (thisdist==dist && i<best))
+		{
+			best=i;
+			dist=thisdist;
+			best_pos=pos;
+		}
 	}
 
-	return dist;
-}
-
-std::vector<synfig::BLinePoint>::const_iterator
-find_closest_to_bline(bool fast, const std::vector<synfig::BLinePoint>& bline,const Point& p,float& t, float& len, bool& extreme)
-{
-	std::vector<synfig::BLinePoint>::const_iterator iter,next,ret;
-	std::vector<synfig::BLinePoint>::const_iterator end(bline.end());
-
-	ret=bline.end();
-	float dist(100000000000.0);
-	next=bline.begin();
-	float best_pos(0), best_len(0);
-	etl::hermite<Vector> best_curve;
-	iter=next++;
-	Point bp;
-	float total_len(0);
-	bool first = true, last = false;
-	extreme = false;
-
-	for(;next!=end;iter=next++)
+	Real operator()(int i)
 	{
-		// Setup the curve
-		etl::hermite<Vector> curve(iter->get_vertex(), next->get_vertex(), iter->get_tangent2(), next->get_tangent1());
-		float thisdist(0);
-		last = false;
+		const etl::hermite<Vector> &curve(segments[i]);
 
 		if (fast)
 		{
-#define POINT_CHECK(x) bp=curve(x);	thisdist=(bp-p).mag_squared(); if(thisdist<dist) { extreme = (first&&x<0.01); ret=iter; best_len = total_len; dist=thisdist; best_curve=curve; last=true; best_pos=x;}
+#define POINT_CHECK(x) check(i,(curve(x)-p).mag_squared(),x)
 			POINT_CHECK(0.0001);  POINT_CHECK((1.0/6)); POINT_CHECK((2.0/6)); POINT_CHECK((3.0/6));
 			POINT_CHECK((4.0/6)); POINT_CHECK((5.0/6)); POINT_CHECK(0.9999);
+#undef POINT_CHECK
 		}
 		else
 		{
 			float pos = curve.find_closest(fast, p);
-			thisdist=(curve(pos)-p).mag_squared();
-			if(thisdist<dist)
-			{
-				extreme = (first && pos == 0);
-				ret=iter;
-				dist=thisdist;
-				best_pos = pos;
-				best_curve = curve;
-				best_len = total_len;
-				last = true;
-			}
+			check(i,(curve(pos)-p).mag_squared(),pos);
 		}
-		total_len += curve.length();
-		first = false;
-	}
 
-	t = best_pos;
-	if (fast)
-	{
-		len = best_len + best_curve.find_distance(0,best_curve.find_closest(fast, p));
-		if (last && t > .99) extreme = true;
+		return dist;
 	}
-	else
-	{
-		len = best_len + best_curve.find_distance(0,best_pos);
-		if (last && t == 1) extreme = true;
-	}
-	return ret;
-}
+};
+
+};
 
 /* === M E T H O D S ======================================================= */
 
 inline void
 CurveWarp::sync()
 {
-	curve_length_=calculate_distance(bline);
+	segments.clear();
+	segment_offset.clear();
+
+	std::vector<Rect> bounds;
+	float dist(0);
+
+	for(int i=0;i+1<(int)bline.size();i++)
+	{
+		// Setup the curve
+		etl::hermite<Vector> curve(bline[i].get_vertex(), bline[i+1].get_vertex(), bline[i].get_tangent2(), bline[i+1].get_tangent1());
+
+		Rect r;
+		Bound(r,curve);
+
+		segments.push_back(curve);
+		segment_offset.push_back(dist);
+		bounds.push_back(r);
+
+		dist+=curve.length();
+	}
+
+	curve_length_=dist;
+	segment_index.build(bounds);
 	perp_ = (end_point - start_point).perp().norm();
 }
 
+std::vector<synfig::BLinePoint>::const_iterator
+CurveWarp::find_closest(const Point &p, float &t, float &len, bool &extreme)const
+{
+	ClosestSegment closest(segments,p,fast);
+	segment_index.find_closest(p,closest);
+
+	t = closest.best_pos;
+	len = 0;
+	extreme = false;
+
+	if(closest.best<0)
+		return bline.end();
+
+	const etl::hermite<Vector> &best_curve(segments[closest.best]);
+	const bool first(closest.best==0), last(closest.best+1==(int)segments.size());
+
+	if (fast)
+	{
+		len = segment_offset[closest.best] + best_curve.find_distance(0,best_curve.find_closest(fast, p));
+		extreme = (first && t < 0.01) || (last && t > .99);
+	}
+	else
+	{
+		len = segment_offset[closest.best] + best_curve.find_distance(0,t);
+		extreme = (first && t == 0) || (last && t == 1);
+	}
+	return bline.begin()+closest.best;
+}
+
 CurveWarp::CurveWarp():
 	origin(0,0),
 	perp_width(1),
@@ -203,7 +220,7 @@ CurveWarp::transform(const Point &point_, Real *dist, Real *along, int quality)c
 		std::vector<synfig::BLinePoint>::const_iterator iter,next;
 
 		// Figure out the BLinePoint we will be using,
-		next=find_closest_to_bline(fast,bline,point,t,len,extreme);
+		next=find_closest(point,t,len,extreme);
 
 		iter=next++;
 		if(next==bline.end()) next=bline.begin();
@@ -34,6 +34,8 @@
 #include <synfig/vector.h>
 #include <synfig/layer.h>
 #include <synfig/blinepoint.h>
+#include <synfig/curve_helper.h>
+#include <ETL/hermite>
 
 /* === M A C R O S ========================================================= */
 
@@ -60,8 +62,17 @@ private:
 	Vector perp_;
 	bool fast;
 
+	//! The curve of every segment of the bline
+	std::vector<etl::hermite<Vector> > segments;
+	//! Length of the bline before the start of each segment
+	std::vector<float> segment_offset;
+	//! Spatial index over \a segments, rebuilt whenever the bline changes
+	CurveIndex segment_index;
+
 	void sync();
 
+	std::vector<synfig::BLinePoint>::const_iterator find_closest(const Point &p, float &t, float &len, bool &extreme)const;
+
 public:
 	CurveWarp();
 
@@ -247,3 +247,10 @@ Import::set_time(Context context, Time time, const Point &pos)const
 
 	context.set_time(time,pos);
 }
+
+bool
+Import::is_time_dependent_vfunc()const
+{
+	// image sequences and movies pick a new frame in set_time()
+	return (importer && importer->is_animated()) || Layer_Bitmap::is_time_dependent_vfunc();
+}
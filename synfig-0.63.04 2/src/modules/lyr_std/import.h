@@ -65,6 +65,9 @@ public:
 	virtual void set_time(synfig::Context context, synfig::Time time)const;
 
 	virtual void set_time(synfig::Context context, synfig::Time time, const synfig::Point &point)const;
+
+protected:
+	virtual bool is_time_dependent_vfunc()const;
 };
 
 /* === E N D =============================================================== */
@@ -33,6 +33,7 @@
 #endif
 
 #include "insideout.h"
+#include "resample.h"
 
 #include <synfig/string.h>
 #include <synfig/time.h>
@@ -104,6 +105,27 @@ InsideOut::get_color(Context context, const Point &p)const
 	return context.get_color(invpos+origin);
 }
 
+class InsideOut_Map
+{
+	const InsideOut &layer;
+public:
+	InsideOut_Map(const InsideOut &x):layer(x) { }
+
+	bool operator()(const Point &pos, Point &src)const
+	{
+		const Point p(pos-layer.origin);
+		const Real inv_mag(p.inv_mag());
+		src=p*inv_mag*inv_mag+layer.origin;
+		return true;
+	}
+};
+
+bool
+InsideOut::accelerated_render(Context context,Surface *surface,int quality, const RendDesc &renddesc, ProgressCallback *cb)const
+{
+	return inverse_map_render(context,surface,quality,renddesc,InsideOut_Map(*this),cb);
+}
+
 class InsideOut_Trans : public Transform
 {
 	etl::handle<const InsideOut> layer;
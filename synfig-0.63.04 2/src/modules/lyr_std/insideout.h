@@ -43,11 +43,13 @@ using namespace synfig;
 using namespace std;
 using namespace etl;
 class InsideOut_Trans;
+class InsideOut_Map;
 
 class InsideOut : public Layer
 {
 	SYNFIG_LAYER_MODULE_EXT
 	friend class InsideOut_Trans;
+	friend class InsideOut_Map;
 
 private:
 
@@ -59,6 +61,7 @@ public:
 	virtual bool set_param(const String &param, const ValueBase &value);
 	virtual ValueBase get_param(const String &param)const;
 	virtual Color get_color(Context context, const Point &pos)const;
+	virtual bool accelerated_render(Context context,Surface *surface,int quality, const RendDesc &renddesc, ProgressCallback *cb)const;
 	synfig::Layer::Handle hit_check(synfig::Context context, const synfig::Point &point)const;
 	virtual Vocab get_param_vocab()const;
 	virtual etl::handle<synfig::Transform> get_transform()const;
@@ -33,6 +33,7 @@
 #endif
 
 #include "julia.h"
+#include "resample.h"
 
 #include <synfig/string.h>
 #include <synfig/time.h>
@@ -206,7 +207,7 @@ Julia::get_param(const String & param)const
 }
 
 Color
-Julia::get_color(Context context, const Point &pos)const
+Julia::color_func(Context context, const Point &pos, const Color *under, const ContextSampler *sampler)const
 {
 	Real
 		cr, ci,
@@ -258,9 +259,9 @@ Julia::get_color(Context context, const Point &pos)const
 				ret=ocolor;
 			else
 				if(distort_outside)
-					ret=context.get_color(Point(zr,zi));
+					ret=sampler?(*sampler)(Point(zr,zi)):context.get_color(Point(zr,zi));
 				else
-					ret=context.get_color(pos);
+					ret=under?*under:context.get_color(pos);
 
 			if(invert_outside)
 				ret=~ret;
@@ -284,9 +285,9 @@ Julia::get_color(Context context, const Point &pos)const
 		ret=icolor;
 	else
 		if(distort_inside)
-			ret=context.get_color(Point(zr,zi));
+			ret=sampler?(*sampler)(Point(zr,zi)):context.get_color(Point(zr,zi));
 		else
-			ret=context.get_color(pos);
+			ret=under?*under:context.get_color(pos);
 
 	if(invert_inside)
 		ret=~ret;
@@ -300,6 +301,72 @@ Julia::get_color(Context context, const Point &pos)const
 	return ret;
 }
 
+Color
+Julia::get_color(Context context, const Point &pos)const
+{
+	return color_func(context,pos,0);
+}
+
+bool
+Julia::accelerated_render(Context context,Surface *surface,int quality, const RendDesc &renddesc, ProgressCallback *cb)const
+{
+	SuperCallback stageone(cb,0,2500,10000);
+	SuperCallback stagetwo(cb,2500,5000,10000);
+
+	// The context is rendered as is when some pixels show it undistorted
+	const bool use_under((!solid_inside && !distort_inside) || (!solid_outside && !distort_outside));
+
+	if(use_under)
+	{
+		if(!context.accelerated_render(surface,quality,renddesc,&stageone))
+			return false;
+	}
+	else
+		surface->set_wh(renddesc.get_w(),renddesc.get_h());
+
+	// Distorted pixels show the context at the last value of z, which
+	// stays within a radius of 2 inside the set, and within 4 plus the
+	// seed just outside of it
+	ContextSampler sampler(context,quality);
+	const bool use_sampler((!solid_inside && distort_inside) || (!solid_outside && distort_outside));
+
+	if(use_sampler)
+	{
+		Real reach(2);
+		if(!solid_outside && distort_outside)
+			reach=4+seed.mag();
+
+		if(!sampler.render(renddesc,Point(-reach,-reach),Point(reach,reach),&stagetwo))
+			return false;
+	}
+
+	int x,y;
+
+	Surface::pen pen(surface->begin());
+	const Real pw(renddesc.get_pw()),ph(renddesc.get_ph());
+	Point pos;
+	Point tl(renddesc.get_tl());
+	const int w(surface->get_w());
+	const int h(surface->get_h());
+
+	for(y=0,pos[1]=tl[1];y<h;y++,pen.inc_y(),pen.dec_x(x),pos[1]+=ph)
+	{
+		for(x=0,pos[0]=tl[0];x<w;x++,pen.inc_x(),pos[0]+=pw)
+		{
+			const Color under(pen.get_value());
+			pen.put_value(color_func(context,pos,use_under?&under:0,use_sampler?&sampler:0));
+		}
+		if(cb && !cb->amount_complete(5000+y*5000/h,10000))
+			return false;
+	}
+
+	// Mark our progress as finished
+	if(cb && !cb->amount_complete(10000,10000))
+		return false;
+
+	return true;
+}
+
 Layer::Vocab
 Julia::get_param_vocab()const
 {
@@ -44,6 +44,8 @@ using namespace synfig;
 using namespace std;
 using namespace etl;
 
+class ContextSampler;
+
 class Julia : public synfig::Layer
 {
 	SYNFIG_LAYER_MODULE_EXT
@@ -73,6 +75,10 @@ private:
 	bool smooth_outside;
 	bool broken;
 
+	//! Colors \a pos, taking the undistorted context color from \a under if given
+	/*!	Distorted context colors are taken from \a sampler if given */
+	synfig::Color color_func(synfig::Context context, const synfig::Point &pos, const synfig::Color *under, const ContextSampler *sampler=0)const;
+
 public:
 	Julia();
 
@@ -81,6 +87,7 @@ public:
 	virtual ValueBase get_param(const synfig::String &param)const;
 
 	virtual Color get_color(synfig::Context context, const synfig::Point &pos)const;
+	virtual bool accelerated_render(synfig::Context context,synfig::Surface *surface,int quality, const synfig::RendDesc &renddesc, synfig::ProgressCallback *cb)const;
 
 	virtual Vocab get_param_vocab()const;
 };
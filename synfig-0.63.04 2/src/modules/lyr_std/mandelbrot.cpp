@@ -33,6 +33,7 @@
 #endif
 
 #include "mandelbrot.h"
+#include "resample.h"
 
 #include <synfig/string.h>
 #include <synfig/time.h>
@@ -299,7 +300,7 @@ Mandelbrot::get_param_vocab()const
 }
 
 Color
-Mandelbrot::get_color(Context context, const Point &pos)const
+Mandelbrot::color_func(Context context, const Point &pos, const Color *under, const ContextSampler *sampler)const
 {
 	Real
 		cr, ci,
@@ -355,9 +356,9 @@ Mandelbrot::get_color(Context context, const Point &pos)const
 			else
 			{
 				if(distort_outside)
-					ret=context.get_color(Point(pos[0]+zr,pos[1]+zi));
+					ret=sampler?(*sampler)(Point(pos[0]+zr,pos[1]+zi)):context.get_color(Point(pos[0]+zr,pos[1]+zi));
 				else
-					ret=context.get_color(pos);
+					ret=under?*under:context.get_color(pos);
 
 				if(invert_outside)
 					ret=~ret;
@@ -380,9 +381,9 @@ Mandelbrot::get_color(Context context, const Point &pos)const
 	else
 	{
 		if(distort_inside)
-			ret=context.get_color(Point(pos[0]+zr,pos[1]+zi));
+			ret=sampler?(*sampler)(Point(pos[0]+zr,pos[1]+zi)):context.get_color(Point(pos[0]+zr,pos[1]+zi));
 		else
-			ret=context.get_color(pos);
+			ret=under?*under:context.get_color(pos);
 
 		if(invert_inside)
 			ret=~ret;
@@ -393,3 +394,71 @@ Mandelbrot::get_color(Context context, const Point &pos)const
 
 	return ret;
 }
+
+Color
+Mandelbrot::get_color(Context context, const Point &pos)const
+{
+	return color_func(context,pos,0);
+}
+
+bool
+Mandelbrot::accelerated_render(Context context,Surface *surface,int quality, const RendDesc &renddesc, ProgressCallback *cb)const
+{
+	SuperCallback stageone(cb,0,2500,10000);
+	SuperCallback stagetwo(cb,2500,5000,10000);
+
+	// The context is rendered as is when some pixels show it undistorted
+	const bool use_under((!solid_inside && !distort_inside) || (!solid_outside && !distort_outside));
+
+	if(use_under)
+	{
+		if(!context.accelerated_render(surface,quality,renddesc,&stageone))
+			return false;
+	}
+	else
+		surface->set_wh(renddesc.get_w(),renddesc.get_h());
+
+	// Distorted pixels show the context offset by the last value of z,
+	// which stays within the bailout radius inside the set and can reach
+	// the square of it, plus the point itself, just outside of it
+	ContextSampler sampler(context,quality);
+	const bool use_sampler((!solid_inside && distort_inside) || (!solid_outside && distort_outside));
+
+	if(use_sampler)
+	{
+		const Point rtl(renddesc.get_tl()), rbr(renddesc.get_br());
+		Real reach(sqrt(bailout));
+		if(!solid_outside && distort_outside)
+			reach=bailout+std::max(rtl.mag(),rbr.mag());
+
+		const Vector margin(rtl[0]<rbr[0]?reach:-reach,rtl[1]<rbr[1]?reach:-reach);
+		if(!sampler.render(renddesc,rtl-margin,rbr+margin,&stagetwo))
+			return false;
+	}
+
+	int x,y;
+
+	Surface::pen pen(surface->begin());
+	const Real pw(renddesc.get_pw()),ph(renddesc.get_ph());
+	Point pos;
+	Point tl(renddesc.get_tl());
+	const int w(surface->get_w());
+	const int h(surface->get_h());
+
+	for(y=0,pos[1]=tl[1];y<h;y++,pen.inc_y(),pen.dec_x(x),pos[1]+=ph)
+	{
+		for(x=0,pos[0]=tl[0];x<w;x++,pen.inc_x(),pos[0]+=pw)
+		{
+			const Color under(pen.get_value());
+			pen.put_value(color_func(context,pos,use_under?&under:0,use_sampler?&sampler:0));
+		}
+		if(cb && !cb->amount_complete(5000+y*5000/h,10000))
+			return false;
+	}
+
+	// Mark our progress as finished
+	if(cb && !cb->amount_complete(10000,10000))
+		return false;
+
+	return true;
+}
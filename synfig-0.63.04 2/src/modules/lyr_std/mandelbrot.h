@@ -44,6 +44,8 @@ using namespace synfig;
 using namespace std;
 using namespace etl;
 
+class ContextSampler;
+
 class Mandelbrot : public Layer
 {
 	SYNFIG_LAYER_MODULE_EXT
@@ -72,12 +74,17 @@ private:
 	Gradient gradient_inside;
 	Gradient gradient_outside;
 
+	//! Colors \a pos, taking the undistorted context color from \a under if given
+	/*!	Distorted context colors are taken from \a sampler if given */
+	Color color_func(Context context, const Point &pos, const Color *under, const ContextSampler *sampler=0)const;
+
 public:
 	Mandelbrot();
 
 	virtual bool set_param(const String &param, const ValueBase &value);
 	virtual ValueBase get_param(const String &param)const;
 	virtual Color get_color(Context context, const Point &pos)const;
+	virtual bool accelerated_render(Context context,Surface *surface,int quality, const RendDesc &renddesc, ProgressCallback *cb)const;
 	virtual Vocab get_param_vocab()const;
 };
 
@@ -0,0 +1,344 @@
+/* === S Y N F I G ========================================================= */
+/*!	\file lyr_std/resample.h
+**	\brief Shared rendering of distortions through an inverse mapping
+**
+**	$Id$
+**
+**	\legal
+**	This package is free software; you can redistribute it and/or
+**	modify it under the terms of the GNU General Public License as
+**	published by the Free Software Foundation; either version 2 of
+**	the License, or (at your option) any later version.
+**
+**	This package is distributed in the hope that it will be useful,
+**	but WITHOUT ANY WARRANTY; without even the implied warranty of
+**	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+**	General Public License for more details.
+**	\endlegal
+*/
+/* ========================================================================= */
+
+/* === S T A R T =========================================================== */
+
+#ifndef __SYNFIG_LYR_STD_RESAMPLE_H
+#define __SYNFIG_LYR_STD_RESAMPLE_H
+
+/* === H E A D E R S ======================================================= */
+
+#include <cmath>
+#include <algorithm>
+#include <synfig/context.h>
+#include <synfig/renddesc.h>
+#include <synfig/surface.h>
+#include <synfig/color.h>
+#include <synfig/vector.h>
+#include <synfig/general.h>
+#include <synfig/parallel.h>
+#include <vector>
+#include <utility>
+#include <ETL/misc>
+
+/* === M A C R O S ========================================================= */
+
+/* === T Y P E D E F S ===================================================== */
+
+/* === C L A S S E S & S T R U C T S ======================================= */
+
+//! Samples \a source at pixel position (\a u,\a v), interpolating according to \a quality
+inline synfig::Color
+resample(const synfig::Surface &source, float u, float v, int quality)
+{
+	if(quality <= 4)	// cubic
+		return source.cubic_sample(u,v);
+	else if(quality <= 5) // cosine
+		return source.cosine_sample(u,v);
+	else if(quality <= 6) // linear
+		return source.linear_sample(u,v);
+	else				// nearest
+		return source[std::min(etl::round_to_int(v),source.get_h()-1)][std::min(etl::round_to_int(u),source.get_w()-1)];
+}
+
+//! Colors of a context, sampled from a render of part of it
+/*!	Layers which show the context at arbitrary points render the area
+**	those points fall in once with render(), and then ask for colors
+**	like they would of Context::get_color(). Points which fall outside
+**	of the rendered area are still asked of the context directly. */
+class ContextSampler
+{
+	synfig::Context context;
+	int quality;
+	synfig::Surface source;
+	synfig::Real inv_pw, inv_ph;
+	synfig::Point tl;
+
+public:
+	ContextSampler(synfig::Context context, int quality):
+		context(context),
+		quality(quality),
+		inv_pw(0),
+		inv_ph(0)
+	{ }
+
+	//! Renders the rectangle from \a a to \a b at the pixel size of \a renddesc
+	/*!	Like inverse_map_render(), the rendered area is limited to the
+	**	window and one window's size around it on each side. */
+	bool render(const synfig::RendDesc &renddesc, const synfig::Point &a, const synfig::Point &b, synfig::ProgressCallback *cb=0)
+	{
+		const int w(renddesc.get_w()), h(renddesc.get_h());
+		const synfig::Real pw(renddesc.get_pw()),ph(renddesc.get_ph());
+		const synfig::Point rtl(renddesc.get_tl());
+
+		const synfig::Real xa((a[0]-rtl[0])/pw), xb((b[0]-rtl[0])/pw);
+		const synfig::Real ya((a[1]-rtl[1])/ph), yb((b[1]-rtl[1])/ph);
+		const int nl(std::max(-w,(int)floor(std::min(xa,xb))-2)), nr(std::min(2*w,(int)ceil(std::max(xa,xb))+3));
+		const int nt(std::max(-h,(int)floor(std::min(ya,yb))-2)), nb(std::min(2*h,(int)ceil(std::max(ya,yb))+3));
+
+		if(nl>=nr || nt>=nb)
+			return true;
+
+		synfig::RendDesc desc(renddesc);
+		desc.set_subwindow(nl,nt,nr-nl,nb-nt);
+		if(!context.accelerated_render(&source,quality,desc,cb))
+			return false;
+
+		inv_pw=1.0/desc.get_pw();
+		inv_ph=1.0/desc.get_ph();
+		tl=desc.get_tl();
+		return true;
+	}
+
+	synfig::Color operator()(const synfig::Point &pos)const
+	{
+		const float u((pos[0]-tl[0])*inv_pw), v((pos[1]-tl[1])*inv_ph);
+
+		if(!(u >= 0 && u < source.get_w() && v >= 0 && v < source.get_h()))
+			return context.get_color(pos);
+		return resample(source,u,v,quality);
+	}
+};
+
+//! Resamples the rows of inverse_map_sample() which come out of its source
+/*!	Pixels which map outside of the source can only be asked of the
+**	context, which may not be done from other threads, so they are
+**	listed in \a misses by row for the calling thread to fill in. */
+template < typename F >
+class InverseMapSampleRows : public synfig::RowTask
+{
+public:
+	typedef std::vector<std::pair<int,synfig::Point> > MissList;
+
+private:
+	synfig::Surface &surface;
+	int quality;
+	const synfig::RendDesc &renddesc;
+	const synfig::Surface &source;
+	const synfig::RendDesc &source_desc;
+	const F &map;
+	std::vector<MissList> &misses;
+
+public:
+	InverseMapSampleRows(synfig::Surface &surface, int quality, const synfig::RendDesc &renddesc,
+						 const synfig::Surface &source, const synfig::RendDesc &source_desc, const F &map,
+						 std::vector<MissList> &misses):
+		surface(surface),
+		quality(quality),
+		renddesc(renddesc),
+		source(source),
+		source_desc(source_desc),
+		map(map),
+		misses(misses)
+	{ }
+
+	virtual void rows(int begin, int end)
+	{
+		const int w(renddesc.get_w());
+		const synfig::Real pw(renddesc.get_pw()),ph(renddesc.get_ph());
+		const synfig::Point tl(renddesc.get_tl());
+
+		const int sw(source.get_w()), sh(source.get_h());
+		const synfig::Real inv_spw(1.0/source_desc.get_pw()), inv_sph(1.0/source_desc.get_ph());
+		const synfig::Point stl(source_desc.get_tl());
+
+		int x,y;
+		synfig::Point pos,src;
+		for(y=begin,pos[1]=tl[1]+y*ph;y<end;y++,pos[1]+=ph)
+		{
+			synfig::Color *row(surface[y]);
+			for(x=0,pos[0]=tl[0];x<w;x++,pos[0]+=pw)
+			{
+				if(!map(pos,src))
+				{
+					row[x]=synfig::Color::alpha();
+					continue;
+				}
+
+				const float u((src[0]-stl[0])*inv_spw), v((src[1]-stl[1])*inv_sph);
+
+				if(!(u >= 0 && u < sw && v >= 0 && v < sh))
+					misses[y].push_back(std::make_pair(x,src));
+				else
+					row[x]=resample(source,u,v,quality);
+			}
+		}
+	}
+};
+
+//! Fills \a surface by pulling every pixel of \a renddesc out of \a source through \a map
+/*!	\a map is called as \c map(pos,src) for the position of every pixel
+**	and stores in \a src the point of the context which that pixel shows,
+**	returning false if the pixel is to be left transparent instead. It
+**	is called from several threads at once, so it must be const.
+**	\a source must hold a render of the context for \a source_desc; points
+**	which fall outside of it are asked of the context with get_color()
+**	once the rows are done. \a cb is told about the progress through
+**	those points. */
+template < typename F >
+bool
+inverse_map_sample(synfig::Context context, synfig::Surface *surface, int quality, const synfig::RendDesc &renddesc,
+				   const synfig::Surface &source, const synfig::RendDesc &source_desc, const F &map, synfig::ProgressCallback *cb=0)
+{
+	const int w(renddesc.get_w()), h(renddesc.get_h());
+
+	surface->set_wh(w,h);
+
+	typedef typename InverseMapSampleRows<F>::MissList MissList;
+	std::vector<MissList> misses(h);
+	InverseMapSampleRows<F> rows(*surface,quality,renddesc,source,source_desc,map,misses);
+	synfig::parallel_rows(rows,h);
+
+	// Anything that didn't fit in the rendered area is asked for directly
+	int y;
+	for(y=0;y<h;y++)
+	{
+		const MissList &list(misses[y]);
+		for(typename MissList::const_iterator iter=list.begin();iter!=list.end();++iter)
+			(*surface)[y][iter->first]=context.get_color(iter->second);
+		if((y&31)==0 && cb && !cb->amount_complete(y,h))
+			return false;
+	}
+
+	return true;
+}
+
+//! Finds the area which the rows of inverse_map_render() map into
+/*!	The bounds of each row are kept apart, so the rows can be split
+**	between threads and the bounds put together afterwards. */
+template < typename F >
+class InverseMapBoundsRows : public synfig::RowTask
+{
+public:
+	struct Bounds
+	{
+		bool found;
+		synfig::Real minx, miny, maxx, maxy;
+
+		Bounds(): found(false), minx(0), miny(0), maxx(0), maxy(0) { }
+
+		void expand(synfig::Real x, synfig::Real y)
+		{
+			if(!found)
+			{
+				minx=maxx=x;
+				miny=maxy=y;
+				found=true;
+			}
+			minx=std::min(minx,x); maxx=std::max(maxx,x);
+			miny=std::min(miny,y); maxy=std::max(maxy,y);
+		}
+	};
+
+private:
+	const synfig::RendDesc &renddesc;
+	const F &map;
+	std::vector<Bounds> &bounds;
+
+public:
+	InverseMapBoundsRows(const synfig::RendDesc &renddesc, const F &map, std::vector<Bounds> &bounds):
+		renddesc(renddesc),
+		map(map),
+		bounds(bounds)
+	{ }
+
+	virtual void rows(int begin, int end)
+	{
+		const int w(renddesc.get_w()), h(renddesc.get_h());
+		const synfig::Real pw(renddesc.get_pw()),ph(renddesc.get_ph());
+		const synfig::Point tl(renddesc.get_tl());
+
+		int x,y;
+		synfig::Point pos,src;
+		for(y=begin,pos[1]=tl[1]+y*ph;y<end;y++,pos[1]+=ph)
+			for(x=0,pos[0]=tl[0];x<w;x++,pos[0]+=pw)
+			{
+				if(!map(pos,src))
+					continue;
+
+				const synfig::Real xs((src[0]-tl[0])/pw), ys((src[1]-tl[1])/ph);
+
+				if(!(xs >= -w && xs < 2*w && ys >= -h && ys < 2*h))
+					continue;
+
+				bounds[y].expand(xs,ys);
+			}
+	}
+};
+
+//! Renders a distortion of the context through the inverse mapping \a map
+/*!	The area of the context which the pixels of \a renddesc map into is
+**	rendered once, with a margin for the interpolation kernel, and then
+**	resampled by inverse_map_sample(), so that the context is only asked
+**	for single colors where the mapping leaves that area. See
+**	inverse_map_sample() for what \a map has to provide. Pixels near a
+**	singularity may map arbitrarily far away, so the rendered area is
+**	limited to the window and one window's size around it on each side. */
+template < typename F >
+bool
+inverse_map_render(synfig::Context context, synfig::Surface *surface, int quality, const synfig::RendDesc &renddesc,
+				   const F &map, synfig::ProgressCallback *cb=0)
+{
+	synfig::SuperCallback stageone(cb,0,5000,10000);
+	synfig::SuperCallback stagetwo(cb,5000,10000,10000);
+
+	// Find the area of the context our pixels map into, in pixels
+	// relative to the top left corner of our own window
+	typedef typename InverseMapBoundsRows<F>::Bounds Bounds;
+	const int h(renddesc.get_h());
+	std::vector<Bounds> row_bounds(h);
+	InverseMapBoundsRows<F> rows(renddesc,map,row_bounds);
+	synfig::parallel_rows(rows,h);
+
+	Bounds bounds;
+	int y;
+	for(y=0;y<h;y++)
+		if(row_bounds[y].found)
+		{
+			bounds.expand(row_bounds[y].minx,row_bounds[y].miny);
+			bounds.expand(row_bounds[y].maxx,row_bounds[y].maxy);
+		}
+
+	synfig::Surface source;
+	synfig::RendDesc desc(renddesc);
+
+	if(bounds.found)
+	{
+		const int nl((int)floor(bounds.minx)-2), nt((int)floor(bounds.miny)-2);
+		const int nw((int)ceil(bounds.maxx)+3-nl), nh((int)ceil(bounds.maxy)+3-nt);
+
+		desc.set_subwindow(nl,nt,nw,nh);
+		if(!context.accelerated_render(&source,quality,desc,&stageone))
+			return false;
+	}
+
+	if(!inverse_map_sample(context,surface,quality,renddesc,source,desc,map,&stagetwo))
+		return false;
+
+	// Mark our progress as finished
+	if(cb && !cb->amount_complete(10000,10000))
+		return false;
+
+	return true;
+}
+
+/* === E N D =============================================================== */
+
+#endif
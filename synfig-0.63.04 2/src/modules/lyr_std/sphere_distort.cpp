@@ -32,6 +32,7 @@
 #endif
 
 #include "sphere_distort.h"
+#include "resample.h"
 #include <synfig/string.h>
 #include <synfig/time.h>
 #include <synfig/context.h>
@@ -323,6 +324,20 @@ Layer_SphereDistort::get_color(Context context, const Point &pos)const
 	return context.get_color(point);
 }
 
+class synfig::Spherize_Map
+{
+	const Layer_SphereDistort &layer;
+public:
+	Spherize_Map(const Layer_SphereDistort &x):layer(x) { }
+
+	bool operator()(const Point &pos, Point &src)const
+	{
+		bool clipped;
+		src=sphtrans(pos,layer.center,layer.radius,layer.percent,layer.type,clipped);
+		return !(layer.clip && clipped);
+	}
+};
+
 #if 1
 bool Layer_SphereDistort::accelerated_render(Context context,Surface *surface,int quality, const RendDesc &renddesc, ProgressCallback *cb)const
 {
@@ -481,56 +496,7 @@ bool Layer_SphereDistort::accelerated_render(Context context,Surface *surface,in
 	}
 
 	//now distort and check to make sure we aren't overshooting our bounds here
-	int w = renddesc.get_w(), h = renddesc.get_h();
-	surface->set_wh(w,h);
-
-	Point sample = tl, sub = tl, trans(0,0);
-	float xs = 0,ys = 0;
-	int y=0,x=0;
-	Real invpw = 1/pw, invph = 1/ph;
-	Surface::pen	p = surface->begin();
-
-	Point rtl = r.get_tl();
-
-	//synfig::warning("Spherize: About to transform");
-
-	for(y = 0; y < h; ++y, sample[1] += ph, p.inc_y())
-	{
-		sub = sample;
-		for(x = 0; x < w; ++x, sub[0] += pw, p.inc_x())
-		{
-			bool clipped;
-			trans=sphtrans(sub,center,radius,percent,type,clipped);
-			if(clip && clipped)
-			{
-				p.put_value(Color::alpha());
-				continue;
-			}
-
-			xs = (trans[0]-rtl[0])*invpw;
-			ys = (trans[1]-rtl[1])*invph;
-
-			if(!(xs >= 0 && xs < nw && ys >= 0 && ys < nh))
-			{
-				//synfig::warning("Spherize: we failed to account for %f,%f",xs,ys);
-				p.put_value(context.get_color(trans));//Color::alpha());
-				continue;
-			}
-
-			//sample at that pixel location based on the quality
-			if(quality <= 4)	// cubic
-				p.put_value(background.cubic_sample(xs,ys));
-			else if(quality <= 5) // cosine
-				p.put_value(background.cosine_sample(xs,ys));
-			else if(quality <= 6) // linear
-				p.put_value(background.linear_sample(xs,ys));
-			else				// nearest
-				p.put_value(background[round_to_int(ys)][round_to_int(xs)]);
-		}
-		p.dec_x(w);
-	}
-
-	return true;
+	return inverse_map_sample(context,surface,quality,renddesc,background,r,Spherize_Map(*this));
 }
 #endif
 
@@ -40,11 +40,13 @@
 namespace synfig
 {
 class Spherize_Trans;
+class Spherize_Map;
 
 class Layer_SphereDistort : public Layer
 {
 	SYNFIG_LAYER_MODULE_EXT
 	friend class Spherize_Trans;
+	friend class Spherize_Map;
 
 private:
 
@@ -62,6 +62,10 @@ public:
 
 	virtual void set_time(synfig::Context context, synfig::Time time)const;
 	virtual bool accelerated_render(synfig::Context context,synfig::Surface *surface,int quality, const synfig::RendDesc &renddesc, synfig::ProgressCallback *cb)const;
+
+protected:
+	//! Holds the time of the layers under it
+	virtual bool is_time_dependent_vfunc()const { return true; }
 };
 
 /* === E N D =============================================================== */
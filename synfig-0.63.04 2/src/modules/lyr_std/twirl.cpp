@@ -40,6 +40,7 @@
 #include <synfig/valuenode.h>
 #include <synfig/transform.h>
 #include "twirl.h"
+#include "resample.h"
 
 #endif
 
@@ -198,51 +199,21 @@ Twirl::get_transform()const
 	return new Twirl_Trans(this);
 }
 
-/*
-bool
-Twirl::accelerated_render(Context context,Surface *surface,int quality, const RendDesc &renddesc, ProgressCallback *cb)const
+class Twirl_Map
 {
-	SuperCallback supercb(cb,0,9500,10000);
-
-	if(get_amount()==1.0 && get_blend_method()==Color::BLEND_STRAIGHT)
-	{
-		surface->set_wh(renddesc.get_w(),renddesc.get_h());
-	}
-	else
-	{
-		if(!context.accelerated_render(surface,quality,renddesc,&supercb))
-			return false;
-		if(get_amount()==0)
-			return true;
-	}
-
-
-	int x,y;
-
-	Surface::pen pen(surface->begin());
-	const Real pw(renddesc.get_pw()),ph(renddesc.get_ph());
-	Point pos;
-	Point tl(renddesc.get_tl());
-	const int w(surface->get_w());
-	const int h(surface->get_h());
+	const Twirl &layer;
+public:
+	Twirl_Map(const Twirl &x):layer(x) { }
 
-	if(get_amount()==1.0 && get_blend_method()==Color::BLEND_STRAIGHT)
+	bool operator()(const Point &pos, Point &src)const
 	{
-		for(y=0,pos[1]=tl[1];y<h;y++,pen.inc_y(),pen.dec_x(x),pos[1]+=ph)
-			for(x=0,pos[0]=tl[0];x<w;x++,pen.inc_x(),pos[0]+=pw)
-				pen.put_value(color_func(pos));
+		src=layer.distort(pos);
+		return true;
 	}
-	else
-	{
-		for(y=0,pos[1]=tl[1];y<h;y++,pen.inc_y(),pen.dec_x(x),pos[1]+=ph)
-			for(x=0,pos[0]=tl[0];x<w;x++,pen.inc_x(),pos[0]+=pw)
-				pen.put_value(Color::blend(color_func(pos),pen.get_value(),get_amount(),get_blend_method()));
-	}
-
-	// Mark our progress as finished
-	if(cb && !cb->amount_complete(10000,10000))
-		return false;
+};
 
-	return true;
+bool
+Twirl::accelerated_render(Context context,Surface *surface,int quality, const RendDesc &renddesc, ProgressCallback *cb)const
+{
+	return inverse_map_render(context,surface,quality,renddesc,Twirl_Map(*this),cb);
 }
-*/
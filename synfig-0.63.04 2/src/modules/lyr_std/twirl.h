@@ -41,11 +41,13 @@
 
 /* === C L A S S E S & S T R U C T S ======================================= */
 class Twirl_Trans;
+class Twirl_Map;
 
 class Twirl : public synfig::Layer_Composite
 {
 	SYNFIG_LAYER_MODULE_EXT
 	friend class Twirl_Trans;
+	friend class Twirl_Map;
 
 private:
 
@@ -70,7 +72,7 @@ public:
 
 	virtual synfig::Color get_color(synfig::Context context, const synfig::Point &pos)const;
 
-	//virtual bool accelerated_render(synfig::Context context,synfig::Surface *surface,int quality, const synfig::RendDesc &renddesc, synfig::ProgressCallback *cb)const;
+	virtual bool accelerated_render(synfig::Context context,synfig::Surface *surface,int quality, const synfig::RendDesc &renddesc, synfig::ProgressCallback *cb)const;
 
 	synfig::Layer::Handle hit_check(synfig::Context context, const synfig::Point &point)const;
 
@@ -34,6 +34,7 @@
 #endif
 
 #include "warp.h"
+#include "resample.h"
 #include <synfig/string.h>
 #include <synfig/time.h>
 #include <synfig/context.h>
@@ -479,6 +480,21 @@ Warp::get_color(Context context, const Point &p)const
 		return Color::alpha();
 }
 
+class Warp_Map
+{
+	const Warp &layer;
+	const Rect &clip_rect;
+public:
+	Warp_Map(const Warp &x, const Rect &clip_rect):layer(x),clip_rect(clip_rect) { }
+
+	bool operator()(const Point &pos, Point &src)const
+	{
+		src=layer.transform_forward(pos);
+		const float z(layer.transform_backward_z(src));
+		return clip_rect.is_inside(src) && z>0 && z<layer.horizon;
+	}
+};
+
 //#define ACCEL_WARP_IS_BROKEN 1
 
 bool
@@ -674,123 +690,14 @@ Warp::accelerated_render(Context context,Surface *surface,int quality, const Ren
 		return true;
 	}
 
-	// Recalculate the pixel widths for the src renddesc
-	src_pw=(desc.get_w())/(desc.get_br()[0]-desc.get_tl()[0]);
-	src_ph=(desc.get_h())/(desc.get_br()[1]-desc.get_tl()[1]);
-
-
 	Surface source;
 	source.set_wh(desc.get_w(),desc.get_h());
 
 	if(!context.accelerated_render(&source,quality,desc,&stageone))
 		return false;
 
-	surface->set_wh(renddesc.get_w(),renddesc.get_h());
-	surface->clear();
-
-	Surface::pen pen(surface->begin());
-
-	if(quality<=4)
-	{
-		// CUBIC
-		int x,y;
-		float u,v;
-		Point point,tmp;
-		for(y=0,point[1]=renddesc.get_tl()[1];y<surface->get_h();y++,pen.inc_y(),pen.dec_x(x),point[1]+=1.0/ph)
-		{
-			for(x=0,point[0]=renddesc.get_tl()[0];x<surface->get_w();x++,pen.inc_x(),point[0]+=1.0/pw)
-			{
-				tmp=transform_forward(point);
-				const float z(transform_backward_z(tmp));
-				if(!clip_rect.is_inside(tmp) || !(z>0 && z<horizon))
-				{
-					(*surface)[y][x]=Color::alpha();
-					continue;
-				}
-
-				u=(tmp[0]-tl[0])*src_pw;
-				v=(tmp[1]-tl[1])*src_ph;
-
-				if(u<0 || v<0 || u>=source.get_w() || v>=source.get_h() || isnan(u) || isnan(v))
-					(*surface)[y][x]=context.get_color(tmp);
-				else
-					(*surface)[y][x]=source.cubic_sample(u,v);
-			}
-			if((y&31)==0 && cb)
-			{
-				if(!stagetwo.amount_complete(y,surface->get_h()))
-					return false;
-			}
-		}
-	}
-	else
-	if(quality<=6)
-	{
-		// INTERPOLATION_LINEAR
-		int x,y;
-		float u,v;
-		Point point,tmp;
-		for(y=0,point[1]=renddesc.get_tl()[1];y<surface->get_h();y++,pen.inc_y(),pen.dec_x(x),point[1]+=1.0/ph)
-		{
-			for(x=0,point[0]=renddesc.get_tl()[0];x<surface->get_w();x++,pen.inc_x(),point[0]+=1.0/pw)
-			{
-				tmp=transform_forward(point);
-				const float z(transform_backward_z(tmp));
-				if(!clip_rect.is_inside(tmp) || !(z>0 && z<horizon))
-				{
-					(*surface)[y][x]=Color::alpha();
-					continue;
-				}
-
-				u=(tmp[0]-tl[0])*src_pw;
-				v=(tmp[1]-tl[1])*src_ph;
-
-				if(u<0 || v<0 || u>=source.get_w() || v>=source.get_h() || isnan(u) || isnan(v))
-					(*surface)[y][x]=context.get_color(tmp);
-				else
-					(*surface)[y][x]=source.linear_sample(u,v);
-			}
-			if((y&31)==0 && cb)
-			{
-				if(!stagetwo.amount_complete(y,surface->get_h()))
-					return false;
-			}
-		}
-	}
-	else
-	{
-		// NEAREST_NEIGHBOR
-		int x,y;
-		float u,v;
-		Point point,tmp;
-		for(y=0,point[1]=renddesc.get_tl()[1];y<surface->get_h();y++,pen.inc_y(),pen.dec_x(x),point[1]+=1.0/ph)
-		{
-			for(x=0,point[0]=renddesc.get_tl()[0];x<surface->get_w();x++,pen.inc_x(),point[0]+=1.0/pw)
-			{
-				tmp=transform_forward(point);
-				const float z(transform_backward_z(tmp));
-				if(!clip_rect.is_inside(tmp) || !(z>0 && z<horizon))
-				{
-					(*surface)[y][x]=Color::alpha();
-					continue;
-				}
-
-				u=(tmp[0]-tl[0])*src_pw;
-				v=(tmp[1]-tl[1])*src_ph;
-
-				if(u<0 || v<0 || u>=source.get_w() || v>=source.get_h() || isnan(u) || isnan(v))
-					(*surface)[y][x]=context.get_color(tmp);
-				else
-					//pen.set_value(source[v][u]);
-					(*surface)[y][x]=source[floor_to_int(v)][floor_to_int(u)];
-			}
-			if((y&31)==0 && cb)
-			{
-				if(!stagetwo.amount_complete(y,surface->get_h()))
-					return false;
-			}
-		}
-	}
+	if(!inverse_map_sample(context,surface,quality,renddesc,source,desc,Warp_Map(*this,clip_rect),&stagetwo))
+		return false;
 
 #endif
 
@@ -44,11 +44,13 @@ using namespace synfig;
 using namespace std;
 using namespace etl;
 class Warp_Trans;
+class Warp_Map;
 
 class Warp : public Layer
 {
 	SYNFIG_LAYER_MODULE_EXT
 	friend class Warp_Trans;
+	friend class Warp_Map;
 private:
 
 	Point src_tl,src_br,dest_tl,dest_tr,dest_bl,dest_br;
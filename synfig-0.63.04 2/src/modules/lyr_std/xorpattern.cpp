@@ -93,12 +93,9 @@ XORPattern::get_param(const String & param)const
 	return Layer_Composite::get_param(param);
 }
 
-Color
-XORPattern::get_color(Context context, const Point &point)const
+inline Color
+XORPattern::color_func(const Point &point)const
 {
-	if(get_amount()==0.0)
-		return context.get_color(point);
-
 	unsigned int a=(unsigned int)floor((point[0]-origin[0])/size[0]), b=(unsigned int)floor((point[1]-origin[1])/size[1]);
 	unsigned char rindex=(a^b);
 	unsigned char gindex=(a^(~b))*4;
@@ -109,6 +106,17 @@ XORPattern::get_color(Context context, const Point &point)const
 				(Color::value_type)bindex/(Color::value_type)255.0,
 				1.0);
 
+	return color;
+}
+
+Color
+XORPattern::get_color(Context context, const Point &point)const
+{
+	if(get_amount()==0.0)
+		return context.get_color(point);
+
+	const Color color(color_func(point));
+
 	if(get_amount() == 1 && get_blend_method() == Color::BLEND_STRAIGHT)
 		return color;
 	else
@@ -116,6 +124,53 @@ XORPattern::get_color(Context context, const Point &point)const
 
 }
 
+bool
+XORPattern::accelerated_render(Context context,Surface *surface,int quality, const RendDesc &renddesc, ProgressCallback *cb)const
+{
+	SuperCallback supercb(cb,0,9500,10000);
+
+	if(get_amount()==1.0 && get_blend_method()==Color::BLEND_STRAIGHT)
+	{
+		surface->set_wh(renddesc.get_w(),renddesc.get_h());
+	}
+	else
+	{
+		if(!context.accelerated_render(surface,quality,renddesc,&supercb))
+			return false;
+		if(get_amount()==0)
+			return true;
+	}
+
+
+	int x,y;
+
+	Surface::pen pen(surface->begin());
+	const Real pw(renddesc.get_pw()),ph(renddesc.get_ph());
+	Point pos;
+	Point tl(renddesc.get_tl());
+	const int w(surface->get_w());
+	const int h(surface->get_h());
+
+	if(get_amount()==1.0 && get_blend_method()==Color::BLEND_STRAIGHT)
+	{
+		for(y=0,pos[1]=tl[1];y<h;y++,pen.inc_y(),pen.dec_x(x),pos[1]+=ph)
+			for(x=0,pos[0]=tl[0];x<w;x++,pen.inc_x(),pos[0]+=pw)
+				pen.put_value(color_func(pos));
+	}
+	else
+	{
+		for(y=0,pos[1]=tl[1];y<h;y++,pen.inc_y(),pen.dec_x(x),pos[1]+=ph)
+			for(x=0,pos[0]=tl[0];x<w;x++,pen.inc_x(),pos[0]+=pw)
+				pen.put_value(Color::blend(color_func(pos),pen.get_value(),get_amount(),get_blend_method()));
+	}
+
+	// Mark our progress as finished
+	if(cb && !cb->amount_complete(10000,10000))
+		return false;
+
+	return true;
+}
+
 Layer::Vocab
 XORPattern::get_param_vocab()const
 {
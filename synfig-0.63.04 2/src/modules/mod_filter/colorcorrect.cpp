@@ -38,9 +38,17 @@
 #include <synfig/surface.h>
 #include <synfig/value.h>
 #include <synfig/valuenode.h>
+#include <synfig/parallel.h>
+#include <vector>
+#include <algorithm>
 
 #endif
 
+/* === M A C R O S ========================================================= */
+
+//! Number of steps over [0,1] in the per-channel correction tables
+#define COLORCORRECT_TABLE_SIZE		4096
+
 /* === U S I N G =========================================================== */
 
 using namespace etl;
@@ -73,7 +81,7 @@ Layer_ColorCorrect::Layer_ColorCorrect():
 }
 
 inline Color
-Layer_ColorCorrect::correct_color(const Color &in)const
+Layer_ColorCorrect::adjust_color(const Color &in)const
 {
 	Color ret(in);
 	Real brightness((this->brightness-0.5)*this->contrast+0.5);
@@ -156,6 +164,14 @@ Layer_ColorCorrect::correct_color(const Color &in)const
 			ret.set_b(0);
 	}
 
+	return ret;
+}
+
+inline Color
+Layer_ColorCorrect::correct_color(const Color &in)const
+{
+	Color ret(adjust_color(in));
+
 	// Return the color, adjusting the hue if necessary
 	if(!!hue_adjust)
 		return ret.rotate_uv(hue_adjust);
@@ -235,6 +251,99 @@ Layer_ColorCorrect::get_color(Context context, const Point &pos)const
 	return correct_color(context.get_color(pos));
 }
 
+namespace synfig {
+
+//! Corrects the rows of a surface through tables of the correction of a layer
+class ColorCorrectRows : public RowTask
+{
+	const Layer_ColorCorrect &layer;
+	Surface *surface;
+
+	std::vector<float> table[3];
+	float min_value;
+	float hue[3][3];
+	bool rotate;
+
+public:
+	ColorCorrectRows(const Layer_ColorCorrect &layer, Surface *surface):
+		layer(layer),
+		surface(surface)
+	{
+		// Everything but the hue works on each channel on its own, so it
+		// is tabulated over [0,1] for every channel. Values outside of the
+		// table, and those below its first step where a gamma curve may be
+		// too steep to interpolate, are corrected directly.
+		int i,c;
+		for(c=0;c<3;c++)
+			table[c].resize(COLORCORRECT_TABLE_SIZE+1);
+		for(i=0;i<=COLORCORRECT_TABLE_SIZE;i++)
+		{
+			const Color value(layer.adjust_color(Color((float)i/COLORCORRECT_TABLE_SIZE)));
+			table[0][i]=value.get_r();
+			table[1][i]=value.get_g();
+			table[2][i]=value.get_b();
+		}
+		min_value=1.0f/COLORCORRECT_TABLE_SIZE;
+
+		// The hue adjustment is a rotation of the chromanance, which is
+		// linear in the channels, so it is taken through a matrix found
+		// by rotating the primaries
+		const Color r(Color(1,0,0).rotate_uv(layer.hue_adjust));
+		const Color g(Color(0,1,0).rotate_uv(layer.hue_adjust));
+		const Color b(Color(0,0,1).rotate_uv(layer.hue_adjust));
+		hue[0][0]=r.get_r(); hue[0][1]=g.get_r(); hue[0][2]=b.get_r();
+		hue[1][0]=r.get_g(); hue[1][1]=g.get_g(); hue[1][2]=b.get_g();
+		hue[2][0]=r.get_b(); hue[2][1]=g.get_b(); hue[2][2]=b.get_b();
+		rotate=!!layer.hue_adjust;
+	}
+
+	virtual void rows(int begin, int end)
+	{
+		const int w(surface->get_w());
+		int x,y,i,c;
+
+		for(y=begin;y<end;y++)
+		{
+			Color *row((*surface)[y]);
+			for(x=0;x<w;x++)
+			{
+				const Color in(row[x]);
+				float value[3] = { in.get_r(), in.get_g(), in.get_b() };
+
+				if(value[0]>=min_value && value[0]<=1.0f &&
+				   value[1]>=min_value && value[1]<=1.0f &&
+				   value[2]>=min_value && value[2]<=1.0f)
+				{
+					for(c=0;c<3;c++)
+					{
+						const float f(value[c]*COLORCORRECT_TABLE_SIZE);
+						i=std::min((int)f,COLORCORRECT_TABLE_SIZE-1);
+						value[c]=table[c][i]+(table[c][i+1]-table[c][i])*(f-i);
+					}
+				}
+				else
+				{
+					const Color out(layer.adjust_color(in));
+					value[0]=out.get_r();
+					value[1]=out.get_g();
+					value[2]=out.get_b();
+				}
+
+				if(rotate)
+					row[x]=Color(
+						hue[0][0]*value[0]+hue[0][1]*value[1]+hue[0][2]*value[2],
+						hue[1][0]*value[0]+hue[1][1]*value[1]+hue[1][2]*value[2],
+						hue[2][0]*value[0]+hue[2][1]*value[1]+hue[2][2]*value[2],
+						in.get_a());
+				else
+					row[x]=Color(value[0],value[1],value[2],in.get_a());
+			}
+		}
+	}
+};
+
+}; // END of namespace synfig
+
 bool
 Layer_ColorCorrect::accelerated_render(Context context,Surface *surface,int quality, const RendDesc &renddesc, ProgressCallback *cb)const
 {
@@ -247,9 +356,19 @@ Layer_ColorCorrect::accelerated_render(Context context,Surface *surface,int qual
 
 	Surface::pen pen(surface->begin());
 
-	for(y=0;y<renddesc.get_h();y++,pen.inc_y(),pen.dec_x(x))
-		for(x=0;x<renddesc.get_w();x++,pen.inc_x())
-			pen.put_value(correct_color(pen.get_value()));
+	// Filling the tables costs about as much as correcting that many
+	// pixels, so small surfaces are corrected directly
+	if(renddesc.get_w()*renddesc.get_h() < COLORCORRECT_TABLE_SIZE)
+	{
+		for(y=0;y<renddesc.get_h();y++,pen.inc_y(),pen.dec_x(x))
+			for(x=0;x<renddesc.get_w();x++,pen.inc_x())
+				pen.put_value(correct_color(pen.get_value()));
+	}
+	else
+	{
+		ColorCorrectRows rows(*this,surface);
+		parallel_rows(rows,renddesc.get_h());
+	}
 
 	// Mark our progress as finished
 	if(cb && !cb->amount_complete(10000,10000))
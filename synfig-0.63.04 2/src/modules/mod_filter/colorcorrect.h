@@ -44,6 +44,8 @@ class Layer_ColorCorrect : public Layer
 {
 	SYNFIG_LAYER_MODULE_EXT
 
+	friend class ColorCorrectRows;
+
 private:
 
 	Angle hue_adjust;
@@ -53,6 +55,9 @@ private:
 
 	Gamma gamma;
 
+	//! Applies gamma, exposure, contrast and brightness to \a in
+	Color adjust_color(const Color &in)const;
+
 	Color correct_color(const Color &in)const;
 
 public:
@@ -52,8 +52,12 @@ using namespace etl;
 float
 Halftone::operator()(const Point &point, const float& luma, float supersample)const
 {
-	float halftone(mask(point));
+	return shade(mask(point),luma,supersample);
+}
 
+float
+Halftone::shade(float halftone, const float& luma, float supersample)const
+{
 	if(supersample>=0.5f)
 		supersample=0.4999999999f;
 
@@ -83,22 +87,27 @@ Halftone::operator()(const Point &point, const float& luma, float supersample)co
 	return 0.0f;
 }
 
+Point
+Halftone::rotate(const Point &point)const
+{
+	const float	a(Angle::sin(-angle).get()),	b(Angle::cos(-angle).get());
+	const float	u(point[0]-origin[0]),v(point[1]-origin[1]);
+
+	return Point(b*u-a*v,a*u+b*v);
+}
+
 float
 Halftone::mask(synfig::Point point)const
+{
+	return mask_rotated(rotate(point));
+}
+
+float
+Halftone::mask_rotated(const synfig::Point &point)const
 {
 	float radius1;
 	float radius2;
 
-	point-=origin;
-
-	{
-		const float	a(Angle::sin(-angle).get()),	b(Angle::cos(-angle).get());
-		const float	u(point[0]),v(point[1]);
-
-		point[0]=b*u-a*v;
-		point[1]=a*u+b*v;
-	}
-
 	if(type==TYPE_STRIPE)
 	{
 		Point pnt(fmod(point[0],size[0]),fmod(point[1],size[1]));
@@ -52,8 +52,20 @@ public:
 	synfig::Vector size;
 	synfig::Angle angle;
 
+	//! Takes \a point into the frame of the screen, rotated by \a angle about \a origin
+	/*!	The mapping is affine, so a row of pixels maps onto a row of
+	**	evenly spaced points and renderers can step along it instead of
+	**	rotating every sample. */
+	synfig::Point rotate(const synfig::Point &point)const;
+
+	//! The value of the screen at a point already taken through rotate()
+	float mask_rotated(const synfig::Point &point)const;
+
 	float mask(synfig::Point point)const;
 
+	//! Coverage of the dots for screen value \a mask and \a intensity
+	float shade(float mask, const float& intensity, float supersample=0)const;
+
 	float operator()(const synfig::Point &point, const float& intensity, float supersample=0)const;
 };
 
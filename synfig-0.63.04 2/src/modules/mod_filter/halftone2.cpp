@@ -41,6 +41,7 @@
 #include <synfig/surface.h>
 #include <synfig/value.h>
 #include <synfig/valuenode.h>
+#include <synfig/parallel.h>
 
 #endif
 
@@ -81,7 +82,13 @@ Halftone2::Halftone2():
 inline Color
 Halftone2::color_func(const Point &point, float supersample,const Color& color)const
 {
-	const float amount(halftone(point,color.get_y(),supersample));
+	return shade_color(halftone.mask(point),supersample,color);
+}
+
+inline Color
+Halftone2::shade_color(float mask, float supersample,const Color& color)const
+{
+	const float amount(halftone.shade(mask,color.get_y(),supersample));
 	Color halfcolor;
 
 	if(amount<=0.0f)
@@ -190,6 +197,47 @@ Halftone2::get_color(Context context, const Point &point)const
 		return Color::blend(color,undercolor,get_amount(),get_blend_method());
 }
 
+//! Screens the rows of a surface through a Halftone2 layer
+class Halftone2Rows : public RowTask
+{
+	const Halftone2 &layer;
+	Surface *surface;
+	Point origin;
+	Vector dx, dy;
+	float supersample_size;
+
+public:
+	Halftone2Rows(const Halftone2 &layer, Surface *surface, const Point &origin, const Vector &dx, const Vector &dy, float supersample_size):
+		layer(layer),
+		surface(surface),
+		origin(origin),
+		dx(dx),
+		dy(dy),
+		supersample_size(supersample_size)
+	{ }
+
+	virtual void rows(int begin, int end)
+	{
+		const int w(surface->get_w());
+		const bool solid(layer.is_solid_color());
+		Point row(origin+dy*begin), pos;
+		int x,y;
+
+		for(y=begin;y<end;y++,row+=dy)
+		{
+			Color *pixel((*surface)[y]);
+			for(x=0,pos=row;x<w;x++,pos+=dx)
+			{
+				const Color shaded(layer.shade_color(layer.halftone.mask_rotated(pos),supersample_size,pixel[x]));
+				if(solid)
+					pixel[x]=shaded;
+				else
+					pixel[x]=Color::blend(shaded,pixel[x],layer.get_amount(),layer.get_blend_method());
+			}
+		}
+	}
+};
+
 bool
 Halftone2::accelerated_render(Context context,Surface *surface,int quality, const RendDesc &renddesc, ProgressCallback *cb)const
 {
@@ -202,43 +250,17 @@ Halftone2::accelerated_render(Context context,Surface *surface,int quality, cons
 
 	const Real pw(renddesc.get_pw()),ph(renddesc.get_ph());
 	const Point tl(renddesc.get_tl());
-	const int w(surface->get_w());
 	const int h(surface->get_h());
 	const float supersample_size(abs(pw/(halftone.size).mag()));
 
-	Surface::pen pen(surface->begin());
-	Point pos;
-	int x,y;
+	// Walk the rotated frame of the screen alongside the pixels,
+	// rather than rotating every sample on its own
+	const Point origin(halftone.rotate(tl));
+	const Vector dx(halftone.rotate(tl+Vector(pw,0))-origin);
+	const Vector dy(halftone.rotate(tl+Vector(0,ph))-origin);
 
-	if(is_solid_color())
-	{
-		for(y=0,pos[1]=tl[1];y<h;y++,pen.inc_y(),pen.dec_x(x),pos[1]+=ph)
-			for(x=0,pos[0]=tl[0];x<w;x++,pen.inc_x(),pos[0]+=pw)
-				pen.put_value(
-					color_func(
-						pos,
-						supersample_size,
-						pen.get_value()
-					)
-				);
-	}
-	else
-	{
-		for(y=0,pos[1]=tl[1];y<h;y++,pen.inc_y(),pen.dec_x(x),pos[1]+=ph)
-			for(x=0,pos[0]=tl[0];x<w;x++,pen.inc_x(),pos[0]+=pw)
-				pen.put_value(
-					Color::blend(
-				 		color_func(
-							pos,
-							supersample_size,
-							pen.get_value()
-						),
-						pen.get_value(),
-						get_amount(),
-						get_blend_method()
-					)
-				);
-	}
+	Halftone2Rows rows(*this,surface,origin,dx,dy,supersample_size);
+	parallel_rows(rows,h);
 
 	// Mark our progress as finished
 	if(cb && !cb->amount_complete(10000,10000))
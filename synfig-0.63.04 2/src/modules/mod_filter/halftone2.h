@@ -45,6 +45,8 @@ class Halftone2 : public synfig::Layer_Composite
 {
 	SYNFIG_LAYER_MODULE_EXT
 
+	friend class Halftone2Rows;
+
 private:
 
 	Halftone halftone;
@@ -53,6 +55,9 @@ private:
 
 	synfig::Color color_func(const synfig::Point &x, float supersample,const synfig::Color &under_color)const;
 
+	//! color_func() for a screen value already looked up with Halftone::mask()
+	synfig::Color shade_color(float mask, float supersample,const synfig::Color &under_color)const;
+
 	float calc_supersample(const synfig::Point &x, float pw,float ph)const;
 
 	//float halftone_func(synfig::Point x)const;
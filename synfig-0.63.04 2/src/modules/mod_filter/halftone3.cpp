@@ -41,6 +41,7 @@
 #include <synfig/surface.h>
 #include <synfig/value.h>
 #include <synfig/valuenode.h>
+#include <synfig/parallel.h>
 
 #endif
 
@@ -196,6 +197,13 @@ Halftone3::sync()
 
 inline Color
 Halftone3::color_func(const Point &point, float supersample,const Color& in_color)const
+{
+	const float mask[3] = { tone[0].mask(point), tone[1].mask(point), tone[2].mask(point) };
+	return shade_color(mask,supersample,in_color);
+}
+
+inline Color
+Halftone3::shade_color(const float mask[3], float supersample,const Color& in_color)const
 {
 	Color halfcolor;
 
@@ -209,9 +217,9 @@ Halftone3::color_func(const Point &point, float supersample,const Color& in_colo
 		chan[2]=inverse_matrix[2][0]*(1.0f-in_color.get_r())+inverse_matrix[2][1]*(1.0f-in_color.get_g())+inverse_matrix[2][2]*(1.0f-in_color.get_b());
 
 		halfcolor=Color::white();
-		halfcolor-=(~color[0])*tone[0](point,chan[0],supersample);
-		halfcolor-=(~color[1])*tone[1](point,chan[1],supersample);
-		halfcolor-=(~color[2])*tone[2](point,chan[2],supersample);
+		halfcolor-=(~color[0])*tone[0].shade(mask[0],chan[0],supersample);
+		halfcolor-=(~color[1])*tone[1].shade(mask[1],chan[1],supersample);
+		halfcolor-=(~color[2])*tone[2].shade(mask[2],chan[2],supersample);
 
 		halfcolor.set_a(in_color.get_a());
 	}
@@ -222,9 +230,9 @@ Halftone3::color_func(const Point &point, float supersample,const Color& in_colo
 		chan[2]=inverse_matrix[2][0]*in_color.get_r()+inverse_matrix[2][1]*in_color.get_g()+inverse_matrix[2][2]*in_color.get_b();
 
 		halfcolor=Color::black();
-		halfcolor+=color[0]*tone[0](point,chan[0],supersample);
-		halfcolor+=color[1]*tone[1](point,chan[1],supersample);
-		halfcolor+=color[2]*tone[2](point,chan[2],supersample);
+		halfcolor+=color[0]*tone[0].shade(mask[0],chan[0],supersample);
+		halfcolor+=color[1]*tone[1].shade(mask[1],chan[1],supersample);
+		halfcolor+=color[2]*tone[2].shade(mask[2],chan[2],supersample);
 
 		halfcolor.set_a(in_color.get_a());
 	}
@@ -353,6 +361,61 @@ Halftone3::get_color(Context context, const Point &point)const
 		return Color::blend(color,undercolor,get_amount(),get_blend_method());
 }
 
+//! Screens the rows of a surface through a Halftone3 layer
+class Halftone3Rows : public RowTask
+{
+	const Halftone3 &layer;
+	Surface *surface;
+	Point origin[3];
+	Vector dx[3], dy[3];
+	float supersample_size;
+
+public:
+	Halftone3Rows(const Halftone3 &layer, Surface *surface, const Point origin[3], const Vector dx[3], const Vector dy[3], float supersample_size):
+		layer(layer),
+		surface(surface),
+		supersample_size(supersample_size)
+	{
+		for(int i=0;i<3;i++)
+		{
+			this->origin[i]=origin[i];
+			this->dx[i]=dx[i];
+			this->dy[i]=dy[i];
+		}
+	}
+
+	virtual void rows(int begin, int end)
+	{
+		const int w(surface->get_w());
+		const bool solid(layer.is_solid_color());
+		Point row[3], pos[3];
+		float mask[3];
+		int x,y,i;
+
+		for(i=0;i<3;i++)
+			row[i]=origin[i]+dy[i]*begin;
+
+		for(y=begin;y<end;y++)
+		{
+			for(i=0;i<3;i++)
+				pos[i]=row[i], row[i]+=dy[i];
+
+			Color *pixel((*surface)[y]);
+			for(x=0;x<w;x++)
+			{
+				for(i=0;i<3;i++)
+					mask[i]=layer.tone[i].mask_rotated(pos[i]), pos[i]+=dx[i];
+
+				const Color shaded(layer.shade_color(mask,supersample_size,pixel[x]));
+				if(solid)
+					pixel[x]=shaded;
+				else
+					pixel[x]=Color::blend(shaded,pixel[x],layer.get_amount(),layer.get_blend_method());
+			}
+		}
+	}
+};
+
 bool
 Halftone3::accelerated_render(Context context,Surface *surface,int quality, const RendDesc &renddesc, ProgressCallback *cb)const
 {
@@ -365,44 +428,24 @@ Halftone3::accelerated_render(Context context,Surface *surface,int quality, cons
 
 	const Real pw(renddesc.get_pw()),ph(renddesc.get_ph());
 	const Point tl(renddesc.get_tl());
-	const int w(surface->get_w());
 	const int h(surface->get_h());
 	const float supersample_size(abs(pw/(tone[0].size).mag()));
 
-	Surface::pen pen(surface->begin());
-	Point pos;
-	int x,y;
-
-	if(is_solid_color())
-	{
-		for(y=0,pos[1]=tl[1];y<h;y++,pen.inc_y(),pen.dec_x(x),pos[1]+=ph)
-			for(x=0,pos[0]=tl[0];x<w;x++,pen.inc_x(),pos[0]+=pw)
-				pen.put_value(
-					color_func(
-						pos,
-						supersample_size,
-						pen.get_value()
-					)
-				);
-	}
-	else
+	// Walk the rotated frame of each screen alongside the pixels,
+	// rather than rotating every sample on its own
+	Point row[3];
+	Vector dx[3], dy[3];
+	int i;
+	for(i=0;i<3;i++)
 	{
-		for(y=0,pos[1]=tl[1];y<h;y++,pen.inc_y(),pen.dec_x(x),pos[1]+=ph)
-			for(x=0,pos[0]=tl[0];x<w;x++,pen.inc_x(),pos[0]+=pw)
-				pen.put_value(
-					Color::blend(
-				 		color_func(
-							pos,
-							supersample_size,
-							pen.get_value()
-						),
-						pen.get_value(),
-						get_amount(),
-						get_blend_method()
-					)
-				);
+		row[i]=tone[i].rotate(tl);
+		dx[i]=tone[i].rotate(tl+Vector(pw,0))-row[i];
+		dy[i]=tone[i].rotate(tl+Vector(0,ph))-row[i];
 	}
 
+	Halftone3Rows rows(*this,surface,row,dx,dy,supersample_size);
+	parallel_rows(rows,h);
+
 	// Mark our progress as finished
 	if(cb && !cb->amount_complete(10000,10000))
 		return false;
@@ -45,6 +45,8 @@ class Halftone3 : public synfig::Layer_Composite
 {
 	SYNFIG_LAYER_MODULE_EXT
 
+	friend class Halftone3Rows;
+
 private:
 
 	synfig::Vector size;
@@ -56,6 +58,9 @@ private:
 
 	synfig::Color color_func(const synfig::Point &x, float supersample,const synfig::Color &under_color)const;
 
+	//! color_func() for the screen values already looked up with Halftone::mask()
+	synfig::Color shade_color(const float mask[3], float supersample,const synfig::Color &under_color)const;
+
 	float calc_supersample(const synfig::Point &x, float pw,float ph)const;
 
 	//float halftone_func(synfig::Point x)const;
@@ -42,12 +42,16 @@
 #include <synfig/value.h>
 #include <synfig/valuenode.h>
 #include <synfig/transform.h>
+#include <synfig/parallel.h>
 #include <ETL/misc>
 
 #endif
 
 /* === M A C R O S ========================================================= */
 
+//! Most passes the logarithmic blur will take, which is 2^N samples per pixel
+#define RADIALBLUR_MAX_PASSES	20
+
 /* === G L O B A L S ======================================================= */
 
 SYNFIG_LAYER_INIT(RadialBlur);
@@ -59,6 +63,89 @@ SYNFIG_LAYER_SET_CVS_ID(RadialBlur,"$Id$");
 
 /* === P R O C E D U R E S ================================================= */
 
+//! Pixel (\a x,\a y) of \a surface, or transparent if it lies outside of it
+static inline Color
+pixel(const Surface &surface, int x, int y)
+{
+	if(x<0 || y<0 || x>=surface.get_w() || y>=surface.get_h())
+		return Color::alpha();
+	return surface[y][x];
+}
+
+//! One pass of the logarithmic radial blur
+/*!	Every pixel of \a dest is set to the same pixel of \a src mixed with
+**	weight \a weight of the point \a scale of the way out from \a center
+**	towards it, both in pixels of \a src. Colors are expected to be
+**	premultiplied. The rows of \a dest only read \a src, so they are
+**	split between threads. */
+class RadialBlurPass : public RowTask
+{
+	Surface &dest;
+	const Surface &src;
+	Point center;
+	Real scale;
+	float weight;
+
+public:
+	RadialBlurPass(Surface &dest, const Surface &src, const Point &center, Real scale, float weight):
+		dest(dest),
+		src(src),
+		center(center),
+		scale(scale),
+		weight(weight)
+	{ }
+
+	virtual void rows(int begin, int end)
+	{
+		const int w(src.get_w());
+		int x,y;
+
+		for(y=begin;y<end;y++)
+		{
+			const Real v(center[1]+(y-center[1])*scale);
+			const int v0((int)floor(v));
+			const float fv(v-v0);
+
+			for(x=0;x<w;x++)
+			{
+				const Real u(center[0]+(x-center[0])*scale);
+				const int u0((int)floor(u));
+				const float fu(u-u0);
+
+				const Color sample(
+					(pixel(src,u0,v0)*(1.0f-fu)+pixel(src,u0+1,v0)*fu)*(1.0f-fv)+
+					(pixel(src,u0,v0+1)*(1.0f-fu)+pixel(src,u0+1,v0+1)*fu)*fv);
+
+				dest[y][x]=src[y][x]*(1.0f-weight)+sample*weight;
+			}
+		}
+	}
+};
+
+//! Averages \a surface along the rays towards \a center in \a passes passes
+/*!	Pass \a k mixes each pixel with the one \a ratio^(2^k) of the way out
+**	from \a center, so that after all of them every pixel is the weighted
+**	sum of the 2^passes samples \a ratio^j of the way out, for j from 0 up.
+**	Sample j is given a weight proportional to \a falloff^j, which is what
+**	lets the geometric spacing of the samples stand for an even one. */
+static void
+radial_blur_passes(Surface &surface, const Point &center, Real ratio, Real falloff, int passes)
+{
+	Surface tmp(surface.get_w(),surface.get_h());
+	Surface *src(&surface), *dest(&tmp);
+
+	Real scale(ratio), weight(falloff);
+	for(int k=0;k<passes;k++,scale*=scale,weight*=weight)
+	{
+		RadialBlurPass pass(*dest,*src,center,scale,weight/(1.0+weight));
+		parallel_rows(pass,src->get_h());
+		std::swap(src,dest);
+	}
+
+	if(src!=&surface)
+		surface=*src;
+}
+
 /* === M E T H O D S ======================================================= */
 
 /* === E N T R Y P O I N T ================================================= */
@@ -192,6 +279,72 @@ RadialBlur::accelerated_render(Context context,Surface *surface,int quality, con
 	apen.set_alpha(get_amount());
 	apen.set_blend_method(get_blend_method());
 
+	// A blur which stops short of its origin can be taken in passes of
+	// successively doubled reach, each of which only mixes two samples,
+	// so that the cost grows with the log of its length. Each pass has
+	// to run over all of tmp_surface, though, since later passes read
+	// the earlier ones at points outside of our tile.
+	if(size>0 && size<1)
+	{
+		const Real end(1.0-size);
+		const Point center((origin[0]-tmp_surface_tl[0])/pw, (origin[1]-tmp_surface_tl[1])/ph);
+		const Point offset((tl[0]-tmp_surface_tl[0])/pw, (tl[1]-tmp_surface_tl[1])/ph);
+
+		// the samples have to be no more than a pixel apart where they
+		// are sparsest, which is at the far corner of the tile
+		Real reach(0);
+		for(y=0;y<=1;y++)
+			for(x=0;x<=1;x++)
+			{
+				const Vector v(offset[0]+x*(w-1)-center[0], offset[1]+y*(h-1)-center[1]);
+				reach=max(reach,max(abs(v[0]),abs(v[1])));
+			}
+		int passes(1);
+		while(passes<RADIALBLUR_MAX_PASSES && (Real)(1<<passes)<-log(end)*reach)
+			passes++;
+
+		const int samples(1<<passes);
+		const Real ratio(pow(end,1.0/samples));
+
+		// work on premultiplied colors
+		Surface::value_prep_type cooker;
+		Surface even(tmp_surface_width,tmp_surface_height);
+		for(y=0;y<tmp_surface_height;y++)
+			for(x=0;x<tmp_surface_width;x++)
+				even[y][x]=cooker.cook(tmp_surface[y][x]);
+
+		// A sample j stands for a stretch of the ray ratio^j long, so
+		// giving it a weight of ratio^j spreads the weight evenly along
+		// the ray. Fading out weighs each point by how far it is from
+		// the end of the blur, (t-end), which is the difference between
+		// a blur weighted ratio^2j and one weighted ratio^j.
+		Surface weighted;
+		if(fade_out)
+			weighted=even;
+
+		radial_blur_passes(even,center,ratio,ratio,passes);
+		if(fade_out)
+			radial_blur_passes(weighted,center,ratio,ratio*ratio,passes);
+
+		const Real sum1((1.0-pow(ratio,samples))/(1.0-ratio));
+		const Real sum2((1.0-pow(ratio,2*samples))/(1.0-ratio*ratio));
+		const float a(fade_out?sum2/(sum2-end*sum1):0), b(fade_out?-end*sum1/(sum2-end*sum1):1);
+
+		const int ox(round_to_int(offset[0])), oy(round_to_int(offset[1]));
+		for(y=0;y<h;y++,apen.inc_y(),apen.dec_x(x))
+			for(x=0;x<w;x++,apen.inc_x())
+			{
+				Color pool(even[y+oy][x+ox]*b);
+				if(fade_out)
+					pool+=weighted[y+oy][x+ox]*a;
+				apen.put_value(cooker.uncook(pool));
+			}
+
+		if(cb && !cb->amount_complete(10000,10000)) return false;
+
+		return true;
+	}
+
 /*
 	int steps(5);
 
@@ -84,6 +84,7 @@ Advanced_Outline::Advanced_Outline()
 	dash_enabled_=false;
 	old_version=false;
 	fast_=false;
+	needs_sync_=true;
 	clear();
 
 	vector<BLinePoint> bline_point_list;
@@ -128,6 +129,7 @@ void
 Advanced_Outline::sync()
 {
 	clear();
+	needs_sync_=false;
 	if (!bline_.get_list().size())
 	{
 		synfig::warning(string("Advanced_Outline::sync():")+N_("No vertices in bline " + string("\"") + get_description() + string("\"")));
@@ -1029,6 +1031,19 @@ Advanced_Outline::sync()
 bool
 Advanced_Outline::set_param(const String & param, const ValueBase &value)
 {
+	// Width point placement depends on the whole bline, so any change
+	// rebuilds the shape; a held pose skips the rebuild altogether
+	if(	param=="bline" && !bline_is_equal_to(bline_,value))
+		needs_sync_=true;
+	else if((param=="wplist" || param=="dilist") &&
+		(get_param(param)!=value || get_param(param).get_loop()!=value.get_loop()))
+		needs_sync_=true;
+	else if((param=="cusp_type" || param=="start_tip" || param=="end_tip" ||
+		 param=="width" || param=="expand" || param=="smoothness" ||
+		 param=="homogeneous" || param=="dash_offset" || param=="dash_enabled" ||
+		 param=="fast") && get_param(param)!=value)
+		needs_sync_=true;
+
 	if(param=="bline" && value.get_type()==ValueBase::TYPE_LIST)
 	{
 		bline_=value;
@@ -1069,14 +1084,16 @@ Advanced_Outline::set_param(const String & param, const ValueBase &value)
 void
 Advanced_Outline::set_time(Context context, Time time)const
 {
-	const_cast<Advanced_Outline*>(this)->sync();
+	if(needs_sync_)
+		const_cast<Advanced_Outline*>(this)->sync();
 	context.set_time(time);
 }
 
 void
 Advanced_Outline::set_time(Context context, Time time, Vector pos)const
 {
-	const_cast<Advanced_Outline*>(this)->sync();
+	if(needs_sync_)
+		const_cast<Advanced_Outline*>(this)->sync();
 	context.set_time(time,pos);
 }
 
@@ -64,6 +64,8 @@ private:
 	bool dash_enabled_;
 	bool old_version;
 	bool fast_;
+	//! Set when a parameter affecting the shape changes, cleared by sync()
+	bool needs_sync_;
 
 public:
 	enum CuspType
@@ -75,6 +77,8 @@ public:
 
 	Advanced_Outline();
 	//! Updates the polygon data to match the parameters.
+	/*! Only called by set_time() when a parameter affecting
+	**	the shape has changed since the last call. */
 	void sync();
 	virtual bool set_param(const String & param, const synfig::ValueBase &value);
 	virtual ValueBase get_param(const String & param)const;
@@ -133,6 +133,71 @@ Point line_intersection(
 
 /* === M E T H O D S ======================================================= */
 
+bool
+Outline::SegmentSamples::matches(const Point &p1, const Point &p2, const Vector &t1, const Vector &t2, float w1, float w2, bool homogeneous)const
+{
+	return valid
+		&& this->p1==p1 && this->p2==p2
+		&& this->t1==t1 && this->t2==t2
+		&& this->w1==w1 && this->w2==w2
+		&& this->homogeneous==homogeneous;
+}
+
+void
+Outline::SegmentSamples::build(const Point &p1, const Point &p2, const Vector &t1, const Vector &t2, float w1, float w2, bool homogeneous)
+{
+	this->p1=p1; this->p2=p2;
+	this->t1=t1; this->t2=t2;
+	this->w1=w1; this->w2=w2;
+	this->homogeneous=homogeneous;
+	valid=true;
+
+	side_a.clear();
+	side_b.clear();
+
+	// Setup the curve
+	hermite<Vector> curve(p1,p2,t1,t2);
+	const derivative< hermite<Vector> > deriv(curve);
+
+	start_tangent=deriv(CUSP_TANGENT_ADJUST);
+
+	// Make the outline
+	if(homogeneous)
+	{
+		const float length(curve.length());
+		float dist(0);
+		Point lastpoint;
+		for(float n=0.0f;n<0.999999f;n+=1.0f/SAMPLES)
+		{
+			const Vector d(deriv(n>CUSP_TANGENT_ADJUST?n:CUSP_TANGENT_ADJUST).perp().norm());
+			const Vector p(curve(n));
+
+			if(n)
+				dist+=(p-lastpoint).mag();
+
+			const float w(((w2-w1)*(dist/length)+w1));
+
+			side_a.push_back(p+d*w);
+			side_b.push_back(p-d*w);
+
+			lastpoint=p;
+		}
+	}
+	else
+		for(float n=0.0f;n<0.999999f;n+=1.0f/SAMPLES)
+		{
+			const Vector d(deriv(n>CUSP_TANGENT_ADJUST?n:CUSP_TANGENT_ADJUST).perp().norm());
+			const Vector p(curve(n));
+			const float w(((w2-w1)*n+w1));
+
+			side_a.push_back(p+d*w);
+			side_b.push_back(p-d*w);
+		}
+	end_tangent=deriv(1.0-CUSP_TANGENT_ADJUST);
+	side_a.push_back(curve(1.0)+end_tangent.perp().norm()*w2);
+	side_b.push_back(curve(1.0)-end_tangent.perp().norm()*w2);
+}
+
 
 Outline::Outline()
 {
@@ -176,6 +241,7 @@ void
 Outline::sync()
 {
 	clear();
+	needs_sync=false;
 
 	if (!bline.get_list().size())
 	{
@@ -198,6 +264,8 @@ Outline::sync()
 	const vector<synfig::BLinePoint> bline_(bline.get_list().begin(),bline.get_list().end());
 #define bline bline_
 
+	segment_samples.resize(bline.size());
+
 	vector<BLinePoint>::const_iterator
 		iter,
 		next(bline.begin());
@@ -251,27 +319,22 @@ Outline::sync()
 				continue;
 		}
 
-		// Setup the curve
-		hermite<Vector> curve(
-			iter->get_vertex(),
-			next->get_vertex(),
-			iter_t,
-			next_t
-		);
-
 		const float
 			iter_w((iter->get_width()*width)*0.5f+expand),
 			next_w((next->get_width()*width)*0.5f+expand);
 
-		const derivative< hermite<Vector> > deriv(curve);
+		// Only resample the segment if its control points changed
+		SegmentSamples &samples(segment_samples[next-bline.begin()]);
+		if(!samples.matches(iter->get_vertex(),next->get_vertex(),iter_t,next_t,iter_w,next_w,homogeneous_width))
+			samples.build(iter->get_vertex(),next->get_vertex(),iter_t,next_t,iter_w,next_w,homogeneous_width);
 
 		if (first)
-			first_tangent = deriv(CUSP_TANGENT_ADJUST);
+			first_tangent = samples.start_tangent;
 
 		// Make cusps as necessary
 		if(!first && sharp_cusps && split_flag && (!prev_t.is_equal_to(iter_t) || iter_t.is_equal_to(Vector::zero())) && !last_tangent.is_equal_to(Vector::zero()))
 		{
-			Vector curr_tangent(deriv(CUSP_TANGENT_ADJUST));
+			Vector curr_tangent(samples.start_tangent);
 
 			const Vector t1(last_tangent.perp().norm());
 			const Vector t2(curr_tangent.perp().norm());
@@ -306,41 +369,9 @@ Outline::sync()
 			}
 		}
 
-		// Make the outline
-		if(homogeneous_width)
-		{
-			const float length(curve.length());
-			float dist(0);
-			Point lastpoint;
-			for(float n=0.0f;n<0.999999f;n+=1.0f/SAMPLES)
-			{
-				const Vector d(deriv(n>CUSP_TANGENT_ADJUST?n:CUSP_TANGENT_ADJUST).perp().norm());
-				const Vector p(curve(n));
-
-				if(n)
-					dist+=(p-lastpoint).mag();
-
-				const float w(((next_w-iter_w)*(dist/length)+iter_w));
-
-				side_a.push_back(p+d*w);
-				side_b.push_back(p-d*w);
-
-				lastpoint=p;
-			}
-		}
-		else
-			for(float n=0.0f;n<0.999999f;n+=1.0f/SAMPLES)
-			{
-				const Vector d(deriv(n>CUSP_TANGENT_ADJUST?n:CUSP_TANGENT_ADJUST).perp().norm());
-				const Vector p(curve(n));
-				const float w(((next_w-iter_w)*n+iter_w));
-
-				side_a.push_back(p+d*w);
-				side_b.push_back(p-d*w);
-			}
-		last_tangent=deriv(1.0-CUSP_TANGENT_ADJUST);
-		side_a.push_back(curve(1.0)+last_tangent.perp().norm()*next_w);
-		side_b.push_back(curve(1.0)-last_tangent.perp().norm()*next_w);
+		side_a.insert(side_a.end(),samples.side_a.begin(),samples.side_a.end());
+		side_b.insert(side_b.end(),samples.side_b.begin(),samples.side_b.end());
+		last_tangent=samples.end_tangent;
 
 		first=false;
 	}
@@ -694,6 +725,10 @@ Outline::set_param(const String & param, const ValueBase &value)
 		//if(value.get_contained_type()!=ValueBase::TYPE_BLINEPOINT)
 		//	return false;
 
+		// A held pose gives back the same list every frame
+		if(!bline_is_equal_to(bline,value))
+			needs_sync=true;
+
 		bline=value;
 
 		return true;
@@ -749,6 +784,11 @@ Outline::set_param(const String & param, const ValueBase &value)
 	}
 	*/
 
+	if(	(param=="width" || param=="expand" || param=="sharp_cusps" ||
+		 param=="round_tip[0]" || param=="round_tip[1]" || param=="homogeneous_width") &&
+		get_param(param)!=value)
+		needs_sync=true;
+
 	IMPORT(round_tip[0]);
 	IMPORT(round_tip[1]);
 	IMPORT(sharp_cusps);
@@ -766,14 +806,16 @@ Outline::set_param(const String & param, const ValueBase &value)
 void
 Outline::set_time(Context context, Time time)const
 {
-	const_cast<Outline*>(this)->sync();
+	if(needs_sync)
+		const_cast<Outline*>(this)->sync();
 	context.set_time(time);
 }
 
 void
 Outline::set_time(Context context, Time time, Vector pos)const
 {
-	const_cast<Outline*>(this)->sync();
+	if(needs_sync)
+		const_cast<Outline*>(this)->sync();
 	context.set_time(time,pos);
 }
 
@@ -48,6 +48,28 @@ class Outline : public synfig::Layer_Polygon
 	SYNFIG_LAYER_MODULE_EXT
 private:
 
+	//! The tessellated sides of a single BLine segment
+	/*!	sync() keeps one of these for each segment and only
+	**	resamples the segments whose control points changed. */
+	struct SegmentSamples
+	{
+		Point p1, p2;
+		Vector t1, t2;
+		float w1, w2;
+		bool homogeneous;
+		bool valid;
+
+		Vector start_tangent;
+		Vector end_tangent;
+		std::vector<Point> side_a;
+		std::vector<Point> side_b;
+
+		SegmentSamples(): valid(false) { }
+
+		bool matches(const Point &p1, const Point &p2, const Vector &t1, const Vector &t2, float w1, float w2, bool homogeneous)const;
+		void build(const Point &p1, const Point &p2, const Vector &t1, const Vector &t2, float w1, float w2, bool homogeneous);
+	};
+
 	synfig::ValueBase bline;
 
 	std::vector<synfig::Segment> segment_list;
@@ -70,11 +92,16 @@ private:
 
 	bool homogeneous_width;
 
+	//! Sample cache indexed by the BLinePoint that ends each segment
+	std::vector<SegmentSamples> segment_samples;
+
 public:
 
 	Outline();
 
 	//! Updates the polygon data to match the parameters.
+	/*! Only called by set_time() when a parameter affecting
+	**	the shape has changed since the last call. */
 	void sync();
 
 	virtual bool set_param(const String & param, const synfig::ValueBase &value);
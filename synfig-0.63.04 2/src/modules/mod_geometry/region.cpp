@@ -70,6 +70,12 @@ SYNFIG_LAYER_SET_CVS_ID(Region,"$Id$");
 
 /* === M E T H O D S ======================================================= */
 
+static inline bool
+same_segment(const Segment &a, const Segment &b)
+{
+	return a.p1==b.p1 && a.t1==b.t1 && a.p2==b.p2 && a.t2==b.t2;
+}
+
 /* === E N T R Y P O I N T ================================================= */
 
 Region::Region()
@@ -89,11 +95,14 @@ Region::Region()
 	bline_point_list[1].set_width(1.0f);
 	bline_point_list[2].set_width(1.0f);
 	bline=bline_point_list;
+	needs_sync=true;
 }
 
 void
 Region::sync()
 {
+	needs_sync=false;
+
 	if(bline.get_contained_type()==ValueBase::TYPE_BLINEPOINT)
 		segment_list=convert_bline_to_segment_list(bline);
 	else if(bline.get_contained_type()==ValueBase::TYPE_SEGMENT)
@@ -119,6 +128,7 @@ Region::sync()
 	vector<Point> vector_list;
 
 	vector<Segment>::const_iterator iter=segment_list.begin();
+	vector<Segment>::size_type i=0;
 	//Vector							last = iter->p1;
 
 	//make sure the shape has a clean slate for writing
@@ -127,7 +137,8 @@ Region::sync()
 	//and start off at the first point
 	//move_to(last[0],last[1]);
 
-	for(;iter!=segment_list.end();++iter)
+	segment_points.resize(segment_list.size());
+	for(;iter!=segment_list.end();++iter,++i)
 	{
 		//connect them with a line if they aren't already joined
 		/*if(iter->p1 != last)
@@ -142,22 +153,30 @@ Region::sync()
 
 		last = iter->p2;*/
 
-		if(iter->t1.is_equal_to(Vector(0,0)) && iter->t2.is_equal_to(Vector(0,0)))
+		// Reuse the samples of segments which haven't moved
+		vector<Point> &points(segment_points[i]);
+		if(i>=sampled_segments.size() || !same_segment(*iter,sampled_segments[i]))
 		{
-			vector_list.push_back(iter->p2);
-		}
-		else
-		{
-			curve.p1()=iter->p1;
-			curve.t1()=iter->t1;
-			curve.p2()=iter->p2;
-			curve.t2()=iter->t2;
-			curve.sync();
-
-			for(n=0.0;n<1.0;n+=1.0/SAMPLES)
-				vector_list.push_back(curve(n));
+			points.clear();
+			if(iter->t1.is_equal_to(Vector(0,0)) && iter->t2.is_equal_to(Vector(0,0)))
+			{
+				points.push_back(iter->p2);
+			}
+			else
+			{
+				curve.p1()=iter->p1;
+				curve.t1()=iter->t1;
+				curve.p2()=iter->p2;
+				curve.t2()=iter->t2;
+				curve.sync();
+
+				for(n=0.0;n<1.0;n+=1.0/SAMPLES)
+					points.push_back(curve(n));
+			}
 		}
+		vector_list.insert(vector_list.end(),points.begin(),points.end());
 	}
+	sampled_segments=segment_list;
 
 	//add the starting point onto the end so it actually fits the shape, so we can be extra awesome...
 	if(!looped)
@@ -190,6 +209,10 @@ Region::set_param(const String & param, const ValueBase &value)
 		//if(value.get_contained_type()!=ValueBase::TYPE_BLINEPOINT)
 		//	return false;
 
+		// A held pose gives back the same list every frame
+		if(!bline_is_equal_to(bline,value))
+			needs_sync=true;
+
 		bline=value;
 
 		return true;
@@ -241,13 +264,15 @@ Region::get_param_vocab()const
 void
 Region::set_time(Context context, Time time)const
 {
-	const_cast<Region*>(this)->sync();
+	if(needs_sync)
+		const_cast<Region*>(this)->sync();
 	context.set_time(time);
 }
 
 void
 Region::set_time(Context context, Time time, Vector pos)const
 {
-	const_cast<Region*>(this)->sync();
+	if(needs_sync)
+		const_cast<Region*>(this)->sync();
 	context.set_time(time,pos);
 }
@@ -52,10 +52,19 @@ class Region : protected synfig::Layer_Polygon//Shape
 private:
 	synfig::ValueBase bline;
 	std::vector<synfig::Segment> segment_list;
+
+	//! Set when \a bline changes, cleared by sync()
+	bool needs_sync;
+
+	//! The segments tessellated by the last sync()
+	std::vector<synfig::Segment> sampled_segments;
+	//! The points sampled for each of \a sampled_segments
+	std::vector<std::vector<synfig::Point> > segment_points;
 public:
 	Region();
 
 	//! Updates the polygon data to match the parameters.
+	/*! Only resamples the segments which differ from the previous call. */
 	void sync();
 
 	virtual bool set_param(const String & param, const synfig::ValueBase &value);
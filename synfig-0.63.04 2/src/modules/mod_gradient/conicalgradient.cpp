@@ -130,7 +130,7 @@ ConicalGradient::get_param_vocab()const
 }
 
 inline Color
-ConicalGradient::color_func(const Point &pos, float supersample)const
+ConicalGradient::color_func(const Point &pos, float supersample, const GradientTable *table)const
 {
 	const Point centered(pos-center);
 	Angle::rot a=Angle::tan(-centered[1],centered[0]).mod();
@@ -190,7 +190,7 @@ ConicalGradient::color_func(const Point &pos, float supersample)const
 		return pool.demult_alpha();
 	}
 
-	return gradient(dist,supersample);
+	return table ? (*table)(dist,supersample) : gradient(dist,supersample);
 }
 
 float
@@ -252,13 +252,20 @@ ConicalGradient::accelerated_render(Context context,Surface *surface,int quality
 	const int w(surface->get_w());
 	const int h(surface->get_h());
 
+	// The supersample width shrinks away from the center, so the
+	// narrowest one needed is found at the farthest corner
+	const Point br(renddesc.get_br());
+	const Point corner(abs(tl[0]-center[0])>abs(br[0]-center[0]) ? tl[0] : br[0],
+					   abs(tl[1]-center[1])>abs(br[1]-center[1]) ? tl[1] : br[1]);
+	const GradientTable table(gradient,quality<9 ? calc_supersample(corner,pw,ph) : 0,w*h);
+
 	if(get_amount()==1.0 && get_blend_method()==Color::BLEND_STRAIGHT)
 	{
 		if(quality<9)
 		{
 			for(y=0,pos[1]=tl[1];y<h;y++,pen.inc_y(),pen.dec_x(x),pos[1]+=ph)
 				for(x=0,pos[0]=tl[0];x<w;x++,pen.inc_x(),pos[0]+=pw)
-					pen.put_value(color_func(pos,calc_supersample(pos,pw,ph)));
+					pen.put_value(color_func(pos,calc_supersample(pos,pw,ph),&table));
 		}
 		else
 		{
@@ -273,7 +280,7 @@ ConicalGradient::accelerated_render(Context context,Surface *surface,int quality
 		{
 			for(y=0,pos[1]=tl[1];y<h;y++,pen.inc_y(),pen.dec_x(x),pos[1]+=ph)
 				for(x=0,pos[0]=tl[0];x<w;x++,pen.inc_x(),pos[0]+=pw)
-					pen.put_value(Color::blend(color_func(pos,calc_supersample(pos,pw,ph)),pen.get_value(),get_amount(),get_blend_method()));
+					pen.put_value(Color::blend(color_func(pos,calc_supersample(pos,pw,ph),&table),pen.get_value(),get_amount(),get_blend_method()));
 		}
 		else
 		{
@@ -76,87 +76,40 @@ inline float calculate_distance(const synfig::BLinePoint& a,const synfig::BLineP
 #endif
 }
 
-inline float calculate_distance(const std::vector<synfig::BLinePoint>& bline, bool bline_loop)
-{
-	std::vector<synfig::BLinePoint>::const_iterator iter,next,ret;
-	std::vector<synfig::BLinePoint>::const_iterator end(bline.end());
-
-	float dist(0);
-
-	if (bline.empty()) return dist;
-
-	next=bline.begin();
-
-	if(bline_loop)
-		iter=--bline.end();
-	else
-		iter=next++;
-
-	for(;next!=end;iter=next++)
-	{
-		// Setup the curve
-		etl::hermite<Vector> curve(
-			iter->get_vertex(),
-			next->get_vertex(),
-			iter->get_tangent2(),
-			next->get_tangent1());
-
-//		dist+=calculate_distance(*iter,*next);
-		dist+=curve.length();
-	}
-
-	return dist;
-}
+namespace {
 
-std::vector<synfig::BLinePoint>::const_iterator
-find_closest(bool fast, const std::vector<synfig::BLinePoint>& bline,const Point& p,float& t,bool loop=false,float *bline_dist_ret=0)
+//! Keeps track of the closest segment while CurveIndex visits the candidates
+/*!	Segments are visited out of order, so ties are resolved in favour of
+**	the earliest segment of the bline, as a linear search would. */
+struct ClosestSegment
 {
-	std::vector<synfig::BLinePoint>::const_iterator iter,next,ret;
-	std::vector<synfig::BLinePoint>::const_iterator end(bline.end());
-
-	ret=bline.end();
-	float dist(100000000000.0);
+	const std::vector<etl::hermite<Vector> > &segments;
+	const Point &p;
+	bool fast;
 
-	next=bline.begin();
+	int best;
+	float dist;
+	float best_pos;
 
-	float best_bline_dist(0);
-	float best_bline_len(0);
-	float total_bline_dist(0);
-	float best_pos(0);
-	etl::hermite<Vector> best_curve;
+	ClosestSegment(const std::vector<etl::hermite<Vector> > &segments, const Point &p, bool fast):
+		segments(segments),p(p),fast(fast),best(-1),dist(100000000000.0),best_pos(0) { }
 
-	if(loop)
-		iter=--bline.end();
-	else
-		iter=next++;
-
-	Point bp;
-
-	for(;next!=end;iter=next++)
+	void check(int i, float thisdist)
 	{
-		// Setup the curve
-		etl::hermite<Vector> curve(
-			iter->get_vertex(),
-			next->get_vertex(),
-			iter->get_tangent2(),
-			next->get_tangent1());
-
-		/*
-		const float t(curve.find_closest(p,6,0.01,0.99));
-		bp=curve(t);if((bp-p).mag_squared()<dist) { ret=iter; dist=(bp-p).mag_squared(); ret_t=t; }
-		*/
-
-		float thisdist(0);
-		float len(0);
-		if(bline_dist_ret)
+		if(thisdist<dist || (thisdist==dist && i<best))
 		{
-			//len=calculate_distance(*iter,*next);
-			len=curve.length();
+			best=i;
+			dist=thisdist;
 		}
+	}
+
+	Real operator()(int i)
+	{
+		const etl::hermite<Vector> &curve(segments[i]);
 
 		if (fast)
 		{
-#define POINT_CHECK(x) bp=curve(x);	thisdist=(bp-p).mag_squared(); if(thisdist<dist) { ret=iter; dist=thisdist; best_bline_dist=total_bline_dist; best_bline_len=len; best_curve=curve; }
+#define POINT_CHECK(x) check(i,(curve(x)-p).mag_squared())
 			POINT_CHECK(0.0001);
 			POINT_CHECK((1.0/6.0));
 			POINT_CHECK((2.0/6.0));
@@ -164,44 +117,88 @@ find_closest(bool fast, const std::vector<synfig::BLinePoint>& bline,const Point
 			POINT_CHECK((4.0/6.0));
 			POINT_CHECK((5.0/6.0));
 			POINT_CHECK(0.9999);
+#undef POINT_CHECK
 		}
 		else
 		{
 			float pos = curve.find_closest(fast, p);
-			thisdist=(curve(pos)-p).mag_squared();
-			if(thisdist<dist)
-			{
-				ret=iter;
-				dist=thisdist;
-				best_bline_dist=total_bline_dist;
-				best_bline_len=len;
-				best_curve=curve;
-				best_pos = pos;
-			}
+			const int prev(best);
+			check(i,(curve(pos)-p).mag_squared());
+			if(best!=prev)
+				best_pos=pos;
 		}
 
-		total_bline_dist+=len;
+		return dist;
 	}
+};
 
-	t = best_pos;
+};
 
-	if(bline_dist_ret)
+/* === M E T H O D S ======================================================= */
+
+inline void
+CurveGradient::sync()
+{
+	segments.clear();
+	segment_vertex.clear();
+	segment_offset.clear();
+
+	std::vector<Rect> bounds;
+	float dist(0);
+
+	if(!bline.empty())
 	{
-		//! \todo is this a redundant call to find_closest()?
-		// note bline_dist_ret is null except when 'perpendicular' is true
-		*bline_dist_ret=best_bline_dist+best_curve.find_distance(0,best_curve.find_closest(fast, p));
-//		*bline_dist_ret=best_bline_dist+best_curve.find_closest(fast, p)*best_bline_len;
+		const int count(bline.size());
+
+		// when looped, the closing segment is searched first
+		for(int i=(bline_loop ? -1 : 0);i+1<count;i++)
+		{
+			const BLinePoint &iter(bline[i<0 ? count-1 : i]);
+			const BLinePoint &next(bline[i+1]);
+
+			// Setup the curve
+			etl::hermite<Vector> curve(
+				iter.get_vertex(),
+				next.get_vertex(),
+				iter.get_tangent2(),
+				next.get_tangent1());
+
+			Rect r;
+			Bound(r,curve);
+
+			segments.push_back(curve);
+			segment_vertex.push_back(i<0 ? count-1 : i);
+			segment_offset.push_back(dist);
+			bounds.push_back(r);
+
+			dist+=curve.length();
+		}
 	}
 
-	return ret;
+	curve_length_=dist;
+	segment_index.build(bounds);
 }
 
-/* === M E T H O D S ======================================================= */
-
-inline void
-CurveGradient::sync()
+std::vector<synfig::BLinePoint>::const_iterator
+CurveGradient::find_closest(const Point &p, float &t, float *bline_dist_ret)const
 {
-	curve_length_=calculate_distance(bline, bline_loop);
+	ClosestSegment closest(segments,p,fast);
+	segment_index.find_closest(p,closest);
+
+	t = closest.best_pos;
+
+	if(closest.best<0)
+		return bline.end();
+
+	if(bline_dist_ret)
+	{
+		const etl::hermite<Vector> &best_curve(segments[closest.best]);
+		//! \todo is this a redundant call to find_closest()?
+		// note bline_dist_ret is null except when 'perpendicular' is true
+		*bline_dist_ret=segment_offset[closest.best]+best_curve.find_distance(0,best_curve.find_closest(fast, p));
+	}
+
+	return bline.begin()+segment_vertex[closest.best];
 }
 
 
@@ -265,12 +262,12 @@ CurveGradient::color_func(const Point &point_, int quality, float supersample)co
 		// Taking into account looping.
 		if(perpendicular)
 		{
-			next=find_closest(fast,bline,point,t,bline_loop,&perp_dist);
+			next=find_closest(point,t,&perp_dist);
 			perp_dist/=curve_length_;
 		}
 		else					// not perpendicular
 		{
-			next=find_closest(fast,bline,point,t,bline_loop);
+			next=find_closest(point,t);
 		}
 
 		iter=next++;
@@ -34,6 +34,8 @@
 #include <synfig/layer_composite.h>
 #include <synfig/gradient.h>
 #include <synfig/blinepoint.h>
+#include <synfig/curve_helper.h>
+#include <ETL/hermite>
 
 /* === M A C R O S ========================================================= */
 
@@ -63,8 +65,19 @@ private:
 	bool perpendicular;
 	bool fast;
 
+	//! The curve of every segment of the bline, in the order they are searched
+	std::vector<etl::hermite<Vector> > segments;
+	//! Index into \a bline of the vertex each segment starts from
+	std::vector<int> segment_vertex;
+	//! Length of the bline before the start of each segment
+	std::vector<float> segment_offset;
+	//! Spatial index over \a segments, rebuilt whenever the bline changes
+	CurveIndex segment_index;
+
 	void sync();
 
+	std::vector<synfig::BLinePoint>::const_iterator find_closest(const Point &p, float &t, float *bline_dist_ret=0)const;
+
 	synfig::Color color_func(const synfig::Point &x, int quality=10, float supersample=0)const;
 
 	float calc_supersample(const synfig::Point &x, float pw,float ph)const;
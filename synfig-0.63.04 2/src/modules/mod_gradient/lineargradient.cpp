@@ -85,8 +85,12 @@ LinearGradient::LinearGradient():
 inline Color
 LinearGradient::color_func(const Point &point, float supersample)const
 {
-	Real dist(point*diff-p1*diff);
+	return gradient_func(point*diff-p1*diff,supersample);
+}
 
+inline Color
+LinearGradient::gradient_func(Real dist, float supersample, const GradientTable *table)const
+{
 	if(loop)
 		dist-=floor(dist);
 
@@ -118,7 +122,7 @@ LinearGradient::color_func(const Point &point, float supersample)const
 			return pool.demult_alpha();
 		}
 	}
-	return gradient(dist,supersample);
+	return table ? (*table)(dist,supersample) : gradient(dist,supersample);
 }
 
 float
@@ -249,17 +253,29 @@ LinearGradient::accelerated_render(Context context,Surface *surface,int quality,
 	const int w(surface->get_w());
 	const int h(surface->get_h());
 
+	// The supersample width is the same for every pixel, and the distance
+	// along the gradient grows by the same amount from one pixel to the next
+	const float supersample(calc_supersample(tl,pw,ph));
+	const GradientTable table(gradient,supersample,w*h);
+	const Real dx(pw*diff[0]);
+
 	if(get_amount()==1.0 && get_blend_method()==Color::BLEND_STRAIGHT)
 	{
 		for(y=0,pos[1]=tl[1];y<h;y++,pen.inc_y(),pen.dec_x(x),pos[1]+=ph)
-			for(x=0,pos[0]=tl[0];x<w;x++,pen.inc_x(),pos[0]+=pw)
-				pen.put_value(color_func(pos,calc_supersample(pos,pw,ph)));
+		{
+			const Real row(Point(tl[0],pos[1])*diff-p1*diff);
+			for(x=0;x<w;x++,pen.inc_x())
+				pen.put_value(gradient_func(row+x*dx,supersample,&table));
+		}
 	}
 	else
 	{
 		for(y=0,pos[1]=tl[1];y<h;y++,pen.inc_y(),pen.dec_x(x),pos[1]+=ph)
-			for(x=0,pos[0]=tl[0];x<w;x++,pen.inc_x(),pos[0]+=pw)
-				pen.put_value(Color::blend(color_func(pos,calc_supersample(pos,pw,ph)),pen.get_value(),get_amount(),get_blend_method()));
+		{
+			const Real row(Point(tl[0],pos[1])*diff-p1*diff);
+			for(x=0;x<w;x++,pen.inc_x())
+				pen.put_value(Color::blend(gradient_func(row+x*dx,supersample,&table),pen.get_value(),get_amount(),get_blend_method()));
+		}
 	}
 
 	// Mark our progress as finished
@@ -60,6 +60,9 @@ private:
 
 	synfig::Color color_func(const synfig::Point &x, float supersample=0)const;
 
+	//! The color at distance \a dist along the gradient, looked up in \a table if given
+	synfig::Color gradient_func(synfig::Real dist, float supersample, const synfig::GradientTable *table=0)const;
+
 	float calc_supersample(const synfig::Point &x, float pw,float ph)const;
 
 public:
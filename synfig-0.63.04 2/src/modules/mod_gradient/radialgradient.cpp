@@ -140,7 +140,7 @@ RadialGradient::get_param_vocab()const
 }
 
 inline Color
-RadialGradient::color_func(const Point &point, float supersample)const
+RadialGradient::color_func(const Point &point, float supersample, const GradientTable *table)const
 {
 	Real dist((point-center).mag()/radius);
 
@@ -175,7 +175,7 @@ RadialGradient::color_func(const Point &point, float supersample)const
 		}
 	}
 
-	return gradient(dist,supersample);
+	return table ? (*table)(dist,supersample) : gradient(dist,supersample);
 }
 
 
@@ -236,17 +236,20 @@ RadialGradient::accelerated_render(Context context,Surface *surface,int quality,
 	const int w(surface->get_w());
 	const int h(surface->get_h());
 
+	// The supersample width is the same for every pixel
+	const GradientTable table(gradient,calc_supersample(tl,pw,ph),w*h);
+
 	if(get_amount()==1.0 && get_blend_method()==Color::BLEND_STRAIGHT)
 	{
 		for(y=0,pos[1]=tl[1];y<h;y++,pen.inc_y(),pen.dec_x(x),pos[1]+=ph)
 			for(x=0,pos[0]=tl[0];x<w;x++,pen.inc_x(),pos[0]+=pw)
-				pen.put_value(color_func(pos,calc_supersample(pos,pw,ph)));
+				pen.put_value(color_func(pos,calc_supersample(pos,pw,ph),&table));
 	}
 	else
 	{
 		for(y=0,pos[1]=tl[1];y<h;y++,pen.inc_y(),pen.dec_x(x),pos[1]+=ph)
 			for(x=0,pos[0]=tl[0];x<w;x++,pen.inc_x(),pos[0]+=pw)
-				pen.put_value(Color::blend(color_func(pos,calc_supersample(pos,pw,ph)),pen.get_value(),get_amount(),get_blend_method()));
+				pen.put_value(Color::blend(color_func(pos,calc_supersample(pos,pw,ph),&table),pen.get_value(),get_amount(),get_blend_method()));
 	}
 
 	// Mark our progress as finished
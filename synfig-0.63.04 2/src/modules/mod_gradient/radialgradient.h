@@ -54,7 +54,7 @@ private:
 	bool loop;
 	bool zigzag;
 
-	synfig::Color color_func(const synfig::Point &x, float supersample=0)const;
+	synfig::Color color_func(const synfig::Point &x, float supersample=0, const synfig::GradientTable *table=0)const;
 
 	float calc_supersample(const synfig::Point &x, float pw,float ph)const;
 
@@ -140,7 +140,7 @@ SpiralGradient::get_param_vocab()const
 }
 
 inline Color
-SpiralGradient::color_func(const Point &pos, float supersample)const
+SpiralGradient::color_func(const Point &pos, float supersample, const GradientTable *table)const
 {
 	const Point centered(pos-center);
 	Angle a;
@@ -173,7 +173,7 @@ SpiralGradient::color_func(const Point &pos, float supersample)const
 		return pool.demult_alpha();
 	}
 
-	return gradient(dist,supersample);
+	return table ? (*table)(dist,supersample) : gradient(dist,supersample);
 }
 
 float
@@ -232,17 +232,24 @@ SpiralGradient::accelerated_render(Context context,Surface *surface,int quality,
 	const int w(surface->get_w());
 	const int h(surface->get_h());
 
+	// The supersample width shrinks away from the center, so the
+	// narrowest one needed is found at the farthest corner
+	const Point br(renddesc.get_br());
+	const Point corner(abs(tl[0]-center[0])>abs(br[0]-center[0]) ? tl[0] : br[0],
+					   abs(tl[1]-center[1])>abs(br[1]-center[1]) ? tl[1] : br[1]);
+	const GradientTable table(gradient,calc_supersample(corner,pw,ph),w*h);
+
 	if(get_amount()==1.0 && get_blend_method()==Color::BLEND_STRAIGHT)
 	{
 		for(y=0,pos[1]=tl[1];y<h;y++,pen.inc_y(),pen.dec_x(x),pos[1]+=ph)
 			for(x=0,pos[0]=tl[0];x<w;x++,pen.inc_x(),pos[0]+=pw)
-				pen.put_value(color_func(pos,calc_supersample(pos,pw,ph)));
+				pen.put_value(color_func(pos,calc_supersample(pos,pw,ph),&table));
 	}
 	else
 	{
 		for(y=0,pos[1]=tl[1];y<h;y++,pen.inc_y(),pen.dec_x(x),pos[1]+=ph)
 			for(x=0,pos[0]=tl[0];x<w;x++,pen.inc_x(),pos[0]+=pw)
-				pen.put_value(Color::blend(color_func(pos,calc_supersample(pos,pw,ph)),pen.get_value(),get_amount(),get_blend_method()));
+				pen.put_value(Color::blend(color_func(pos,calc_supersample(pos,pw,ph),&table),pen.get_value(),get_amount(),get_blend_method()));
 	}
 
 	// Mark our progress as finished
@@ -78,7 +78,7 @@ NoiseDistort::NoiseDistort():
 }
 
 inline Color
-NoiseDistort::color_func(const Point &point, float /*supersample*/,Context context)const
+NoiseDistort::color_func(const Point &point, float /*supersample*/,Context context,RandomNoise::Cell *cells)const
 {
 	Color ret(0,0,0,0);
 
@@ -95,8 +95,10 @@ NoiseDistort::color_func(const Point &point, float /*supersample*/,Context conte
 		Vector vect(0,0);
 		for(i=0;i<detail;i++)
 		{
-			vect[0]=random(smooth,0+(detail-i)*5,x,y,time)+vect[0]*0.5;
-			vect[1]=random(smooth,1+(detail-i)*5,x,y,time)+vect[1]*0.5;
+			RandomNoise::Cell *cell(cells?cells+i*2:0);
+
+			vect[0]=random(smooth,0+(detail-i)*5,x,y,time,0,cell)+vect[0]*0.5;
+			vect[1]=random(smooth,1+(detail-i)*5,x,y,time,0,cell?cell+1:0)+vect[1]*0.5;
 
 			if(vect[0]<-1)vect[0]=-1;if(vect[0]>1)vect[0]=1;
 			if(vect[1]<-1)vect[1]=-1;if(vect[1]>1)vect[1]=1;
@@ -293,17 +295,21 @@ NoiseDistort::accelerated_render(Context context,Surface *surface,int quality, c
 	const int w(surface->get_w());
 	const int h(surface->get_h());
 
+	// Neighbouring pixels mostly share their lattice cells
+	vector<RandomNoise::Cell> cell_cache(max(detail,0)*2);
+	RandomNoise::Cell *cells(cell_cache.empty()?0:&cell_cache[0]);
+
 	if(get_amount()==1.0 && get_blend_method()==Color::BLEND_STRAIGHT)
 	{
 		for(y=0,pos[1]=tl[1];y<h;y++,pen.inc_y(),pen.dec_x(x),pos[1]+=ph)
 			for(x=0,pos[0]=tl[0];x<w;x++,pen.inc_x(),pos[0]+=pw)
-				pen.put_value(color_func(pos,calc_supersample(pos,pw,ph),context));
+				pen.put_value(color_func(pos,calc_supersample(pos,pw,ph),context,cells));
 	}
 	else
 	{
 		for(y=0,pos[1]=tl[1];y<h;y++,pen.inc_y(),pen.dec_x(x),pos[1]+=ph)
 			for(x=0,pos[0]=tl[0];x<w;x++,pen.inc_x(),pos[0]+=pw)
-				pen.put_value(Color::blend(color_func(pos,calc_supersample(pos,pw,ph),context),pen.get_value(),get_amount(),get_blend_method()));
+				pen.put_value(Color::blend(color_func(pos,calc_supersample(pos,pw,ph),context,cells),pen.get_value(),get_amount(),get_blend_method()));
 	}
 
 	// Mark our progress as finished
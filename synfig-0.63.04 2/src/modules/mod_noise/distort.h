@@ -59,7 +59,8 @@ private:
 	//void sync();
 	mutable synfig::Time curr_time;
 
-	synfig::Color color_func(const synfig::Point &x, float supersample,synfig::Context context)const;
+	//! \a cells, if given, holds two RandomNoise::Cell per octave reused between calls
+	synfig::Color color_func(const synfig::Point &x, float supersample,synfig::Context context,RandomNoise::Cell *cells=0)const;
 
 	float calc_supersample(const synfig::Point &x, float pw,float ph)const;
 
@@ -76,6 +77,10 @@ public:
 	virtual synfig::Rect get_bounding_rect(synfig::Context context)const;
 	virtual Vocab get_param_vocab()const;
 	virtual bool reads_context()const { return true; }
+
+protected:
+	//! The noise moves over time at the given speed
+	virtual bool is_time_dependent_vfunc()const { return true; }
 }; // EOF of class NoiseDistort
 
 /* === E N D =============================================================== */
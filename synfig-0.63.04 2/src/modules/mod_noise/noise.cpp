@@ -41,6 +41,7 @@
 #include <synfig/surface.h>
 #include <synfig/value.h>
 #include <synfig/valuenode.h>
+#include <synfig/parallel.h>
 
 #endif
 
@@ -84,7 +85,7 @@ Noise::Noise():
 
 
 inline Color
-Noise::color_func(const Point &point, float pixel_size,Context /*context*/)const
+Noise::color_func(const Point &point, float pixel_size,Context /*context*/,RandomNoise::Cell *cells)const
 {
 	Color ret(0,0,0,0);
 
@@ -112,15 +113,17 @@ Noise::color_func(const Point &point, float pixel_size,Context /*context*/)const
 		float alpha=0.0f;
 		for(i=0;i<detail;i++)
 		{
-			amount=random(smooth,0+(detail-i)*5,x,y,ftime)+amount*0.5;
+			RandomNoise::Cell *cell(cells?cells+i*4:0);
+
+			amount=random(smooth,0+(detail-i)*5,x,y,ftime,0,cell)+amount*0.5;
 			if(amount<-1)amount=-1;if(amount>1)amount=1;
 
 			if(super_sample&&pixel_size)
 			{
-				amount2=random(smooth,0+(detail-i)*5,x2,y,ftime)+amount2*0.5;
+				amount2=random(smooth,0+(detail-i)*5,x2,y,ftime,0,cell?cell+1:0)+amount2*0.5;
 				if(amount2<-1)amount2=-1;if(amount2>1)amount2=1;
 
-				amount3=random(smooth,0+(detail-i)*5,x,y2,ftime)+amount3*0.5;
+				amount3=random(smooth,0+(detail-i)*5,x,y2,ftime,0,cell?cell+2:0)+amount3*0.5;
 				if(amount3<-1)amount3=-1;if(amount3>1)amount3=1;
 
 				if(turbulent)
@@ -135,7 +138,7 @@ Noise::color_func(const Point &point, float pixel_size,Context /*context*/)const
 
 			if(do_alpha)
 			{
-				alpha=random(smooth,3+(detail-i)*5,x,y,ftime)+alpha*0.5;
+				alpha=random(smooth,3+(detail-i)*5,x,y,ftime,0,cell?cell+3:0)+alpha*0.5;
 				if(alpha<-1)alpha=-1;if(alpha>1)alpha=1;
 			}
 
@@ -312,6 +315,57 @@ Noise::get_color(Context context, const Point &point)const
 		return Color::blend(color,context.get_color(point),get_amount(),get_blend_method());
 }
 
+//! Renders the rows of a noise layer over a surface
+/*!	Each call to rows() has its own cache of lattice cells, which is
+**	only ever seen by the thread doing that band of rows. The context
+**	is only handed on to Noise::color_func(), which doesn't use it. */
+class NoiseRows : public RowTask
+{
+	const Noise &layer;
+	Context context;
+	Surface *surface;
+	RendDesc renddesc;
+	float supersampleradius;
+
+public:
+	NoiseRows(const Noise &layer, Context context, Surface *surface, int quality, const RendDesc &renddesc):
+		layer(layer),
+		context(context),
+		surface(surface),
+		renddesc(renddesc)
+	{
+		supersampleradius=(abs(renddesc.get_pw())+abs(renddesc.get_ph()))*0.5f;
+		if(quality>=8)
+			supersampleradius=0;
+	}
+
+	virtual void rows(int begin, int end)
+	{
+		const Real pw(renddesc.get_pw()),ph(renddesc.get_ph());
+		const Point tl(renddesc.get_tl());
+		const int w(surface->get_w());
+		const float amount(layer.get_amount());
+		const Color::BlendMethod blend_method(layer.get_blend_method());
+		const bool straight(amount==1.0 && blend_method==Color::BLEND_STRAIGHT);
+		Point pos;
+		int x,y;
+
+		// Neighbouring pixels mostly share their lattice cells
+		vector<RandomNoise::Cell> cell_cache(max(layer.detail,0)*4);
+		RandomNoise::Cell *cells(cell_cache.empty()?0:&cell_cache[0]);
+
+		for(y=begin,pos[1]=tl[1]+y*ph;y<end;y++,pos[1]+=ph)
+		{
+			Color *row((*surface)[y]);
+			for(x=0,pos[0]=tl[0];x<w;x++,pos[0]+=pw)
+			{
+				const Color color(layer.color_func(pos,supersampleradius,context,cells));
+				row[x]=straight?color:Color::blend(color,row[x],amount,blend_method);
+			}
+		}
+	}
+};
+
 bool
 Noise::accelerated_render(Context context,Surface *surface,int quality, const RendDesc &renddesc, ProgressCallback *cb)const
 {
@@ -329,31 +383,8 @@ Noise::accelerated_render(Context context,Surface *surface,int quality, const Re
 			return true;
 	}
 
-
-	int x,y;
-
-	Surface::pen pen(surface->begin());
-	const Real pw(renddesc.get_pw()),ph(renddesc.get_ph());
-	Point pos;
-	Point tl(renddesc.get_tl());
-	const int w(surface->get_w());
-	const int h(surface->get_h());
-	float supersampleradius((abs(pw)+abs(ph))*0.5f);
-	if(quality>=8)
-		supersampleradius=0;
-
-	if(get_amount()==1.0 && get_blend_method()==Color::BLEND_STRAIGHT)
-	{
-		for(y=0,pos[1]=tl[1];y<h;y++,pen.inc_y(),pen.dec_x(x),pos[1]+=ph)
-			for(x=0,pos[0]=tl[0];x<w;x++,pen.inc_x(),pos[0]+=pw)
-				pen.put_value(color_func(pos,supersampleradius,context));
-	}
-	else
-	{
-		for(y=0,pos[1]=tl[1];y<h;y++,pen.inc_y(),pen.dec_x(x),pos[1]+=ph)
-			for(x=0,pos[0]=tl[0];x<w;x++,pen.inc_x(),pos[0]+=pw)
-				pen.put_value(Color::blend(color_func(pos,supersampleradius,context),pen.get_value(),get_amount(),get_blend_method()));
-	}
+	NoiseRows rows(*this,context,surface,quality,renddesc);
+	parallel_rows(rows,surface->get_h());
 
 	// Mark our progress as finished
 	if(cb && !cb->amount_complete(10000,10000))
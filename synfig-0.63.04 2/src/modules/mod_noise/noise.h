@@ -46,6 +46,8 @@ class Noise : public synfig::Layer_Composite, public synfig::Layer_NoDeform
 {
 	SYNFIG_LAYER_MODULE_EXT
 
+	friend class NoiseRows;
+
 private:
 
 	synfig::Vector size;
@@ -65,7 +67,8 @@ private:
 
 	bool super_sample;
 
-	synfig::Color color_func(const synfig::Point &x, float supersample,synfig::Context context)const;
+	//! \a cells, if given, holds four RandomNoise::Cell per octave reused between calls
+	synfig::Color color_func(const synfig::Point &x, float supersample,synfig::Context context,RandomNoise::Cell *cells=0)const;
 
 	float calc_supersample(const synfig::Point &x, float pw,float ph)const;
 
@@ -81,6 +84,10 @@ public:
 	virtual void set_time(synfig::Context context, synfig::Time time, const synfig::Point &point)const;
 
 	virtual Vocab get_param_vocab()const;
+
+protected:
+	//! The noise moves over time at the given speed
+	virtual bool is_time_dependent_vfunc()const { return true; }
 };
 
 /* === E N D =============================================================== */
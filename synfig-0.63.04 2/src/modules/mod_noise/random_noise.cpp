@@ -72,7 +72,7 @@ RandomNoise::operator()(const int salt,const int x,const int y,const int t)const
 }
 
 float
-RandomNoise::operator()(SmoothType smooth,int subseed,float xf,float yf,float tf,int loop)const
+RandomNoise::operator()(SmoothType smooth,int subseed,float xf,float yf,float tf,int loop,Cell *cell)const
 {
 	int x((int)floor(xf));
 	int y((int)floor(yf));
@@ -96,20 +96,74 @@ RandomNoise::operator()(SmoothType smooth,int subseed,float xf,float yf,float tf
 
 	// synfig::info("%s:%d tf %.2f loop %d fraction %.2f ( -1,0,1,2 : %2d %2d %2d %2d)", __FILE__, __LINE__, tf, loop, tf-t, t_1, t0, t1, t2);
 
+	// Linear and cosine smoothing only look at the next frame when between frames
+	const bool animated((smooth==SMOOTH_LINEAR || smooth==SMOOTH_COSINE) && (float)t!=tf);
+
+	Cell local_cell;
+	if(!cell)
+		cell=&local_cell;
+
+	if(!cell->valid || cell->seed!=seed_ || cell->subseed!=subseed || cell->smooth!=smooth ||
+	   cell->x!=x || cell->y!=y || cell->t!=t || cell->loop!=loop || cell->animated!=animated)
+	{
+		cell->valid=true;
+		cell->seed=seed_;
+		cell->subseed=subseed;
+		cell->smooth=smooth;
+		cell->x=x;
+		cell->y=y;
+		cell->t=t;
+		cell->loop=loop;
+		cell->animated=animated;
+
+		const int ta[] = {t_1,t0,t1,t2};
+		float (&v)[4][4][4](cell->value);
+		int i,j,k;
+
+		switch(smooth)
+		{
+		case SMOOTH_CUBIC:
+		case SMOOTH_SPLINE:
+			for(k=0;k<4;k++)
+				for(j=0;j<4;j++)
+					for(i=0;i<4;i++)
+						v[k][j][i]=(*this)(subseed,x+i-1,y+j-1,ta[k]);
+			break;
+		case SMOOTH_FAST_SPLINE:
+			for(j=0;j<4;j++)
+				for(i=0;i<4;i++)
+					v[1][j][i]=(*this)(subseed,x+i-1,y+j-1);
+			break;
+		case SMOOTH_COSINE:
+		case SMOOTH_LINEAR:
+			for(k=1;k<(animated?3:2);k++)
+				for(j=1;j<3;j++)
+					for(i=1;i<3;i++)
+						v[k][j][i]=(*this)(subseed,x+i-1,y+j-1,ta[k]);
+			break;
+		default:
+			v[1][1][1]=(*this)(subseed,x,y,t0);
+			break;
+		}
+	}
+
+	// Lattice values, indexed [t][y][x] starting one before the cell
+	const float (&v)[4][4][4](cell->value);
+
 	switch(smooth)
 	{
 	case SMOOTH_CUBIC:	// cubic
 		{
-			#define f(j,i,k)	((*this)(subseed,i,j,k))
+			#define f(j,i,k)	(v[k][j][i])
 			//Using catmull rom interpolation because it doesn't blur at all
 			// ( http://www.gamedev.net/reference/articles/article1497.asp )
 			//bezier curve with intermediate ctrl pts: 0.5/3(p(i+1) - p(i-1)) and similar
 			float xfa [4], tfa[4];
 
-			//precalculate indices (all clamped) and offset
-			const int xa[] = {x-1,x,x+1,x+2};
-			const int ya[] = {y-1,y,y+1,y+2};
-			const int ta[] = {t_1,t0,t1,t2};
+			//precalculate indices into the lattice values
+			const int xa[] = {0,1,2,3};
+			const int ya[] = {0,1,2,3};
+			const int ta[] = {0,1,2,3};
 
 			const float dx(xf-x);
 			const float dy(yf-y);
@@ -161,8 +215,8 @@ RandomNoise::operator()(SmoothType smooth,int subseed,float xf,float yf,float tf
 		{
 #define P(x)		(((x)>0)?((x)*(x)*(x)):0.0f)
 #define R(x)		( P(x+2) - 4.0f*P(x+1) + 6.0f*P(x) - 4.0f*P(x-1) )*(1.0f/6.0f)
-#define F(i,j)		((*this)(subseed,i+x,j+y)*(R((i)-a)*R(b-(j))))
-#define FT(i,j,k,l)	((*this)(subseed,i+x,j+y,l)*(R((i)-a)*R(b-(j))*R((k)-c)))
+#define F(i,j)		(v[1][(j)+1][(i)+1]*(R((i)-a)*R(b-(j))))
+#define FT(i,j,k,l)	(v[(k)+1][(j)+1][(i)+1]*(R((i)-a)*R(b-(j))*R((k)-c)))
 #define Z(i,j)		ret+=F(i,j)
 #define ZT(i,j,k,l) ret+=FT(i,j,k,l)
 #define X(i,j)		// placeholder... To make box more symmetric
@@ -243,10 +297,10 @@ RandomNoise::operator()(SmoothType smooth,int subseed,float xf,float yf,float tf
 		float d=1.0-b;
 		int x2=x+1,y2=y+1;
 		return
-			(*this)(subseed,x,y,t0)*(c*d)+
-			(*this)(subseed,x2,y,t0)*(a*d)+
-			(*this)(subseed,x,y2,t0)*(c*b)+
-			(*this)(subseed,x2,y2,t0)*(a*b);
+			v[1][1][1]*(c*d)+
+			v[1][1][2]*(a*d)+
+			v[1][2][1]*(c*b)+
+			v[1][2][2]*(a*b);
 	}
 	else
 	{
@@ -268,14 +322,14 @@ RandomNoise::operator()(SmoothType smooth,int subseed,float xf,float yf,float tf
 		int x2=x+1,y2=y+1;
 
 		return
-			(*this)(subseed,x,y,t0)*(d*e*f)+
-			(*this)(subseed,x2,y,t0)*(a*e*f)+
-			(*this)(subseed,x,y2,t0)*(d*b*f)+
-			(*this)(subseed,x2,y2,t0)*(a*b*f)+
-			(*this)(subseed,x,y,t1)*(d*e*c)+
-			(*this)(subseed,x2,y,t1)*(a*e*c)+
-			(*this)(subseed,x,y2,t1)*(d*b*c)+
-			(*this)(subseed,x2,y2,t1)*(a*b*c);
+			v[1][1][1]*(d*e*f)+
+			v[1][1][2]*(a*e*f)+
+			v[1][2][1]*(d*b*f)+
+			v[1][2][2]*(a*b*f)+
+			v[2][1][1]*(d*e*c)+
+			v[2][1][2]*(a*e*c)+
+			v[2][2][1]*(d*b*c)+
+			v[2][2][2]*(a*b*c);
 	}
 	case SMOOTH_LINEAR:
 	if((float)t==tf)
@@ -288,10 +342,10 @@ RandomNoise::operator()(SmoothType smooth,int subseed,float xf,float yf,float tf
 		float d=1.0-b;
 		int x2=x+1,y2=y+1;
 		return
-			(*this)(subseed,x,y,t0)*(c*d)+
-			(*this)(subseed,x2,y,t0)*(a*d)+
-			(*this)(subseed,x,y2,t0)*(c*b)+
-			(*this)(subseed,x2,y2,t0)*(a*b);
+			v[1][1][1]*(c*d)+
+			v[1][1][2]*(a*d)+
+			v[1][2][1]*(c*b)+
+			v[1][2][2]*(a*b);
 	}
 	else
 	{
@@ -307,17 +361,17 @@ RandomNoise::operator()(SmoothType smooth,int subseed,float xf,float yf,float tf
 		int x2=x+1,y2=y+1;
 
 		return
-			(*this)(subseed,x,y,t0)*(d*e*f)+
-			(*this)(subseed,x2,y,t0)*(a*e*f)+
-			(*this)(subseed,x,y2,t0)*(d*b*f)+
-			(*this)(subseed,x2,y2,t0)*(a*b*f)+
-			(*this)(subseed,x,y,t1)*(d*e*c)+
-			(*this)(subseed,x2,y,t1)*(a*e*c)+
-			(*this)(subseed,x,y2,t1)*(d*b*c)+
-			(*this)(subseed,x2,y2,t1)*(a*b*c);
+			v[1][1][1]*(d*e*f)+
+			v[1][1][2]*(a*e*f)+
+			v[1][2][1]*(d*b*f)+
+			v[1][2][2]*(a*b*f)+
+			v[2][1][1]*(d*e*c)+
+			v[2][1][2]*(a*e*c)+
+			v[2][2][1]*(d*b*c)+
+			v[2][2][2]*(a*b*c);
 	}
 	default:
 	case SMOOTH_DEFAULT:
-		return (*this)(subseed,x,y,t0);
+		return v[1][1][1];
 	}
 }
@@ -54,8 +54,27 @@ public:
 		SMOOTH_FAST_SPLINE	= 5,
 	};
 
+	//! The lattice values around the cell of the last smoothed sample
+	/*!	Handing the same Cell to successive calls of the smoothed
+	**	operator() lets samples which fall into the same cell, as
+	**	neighbouring pixels mostly do, reuse its hashed lattice values.
+	**	Use one Cell per subseed and octave. */
+	class Cell
+	{
+		friend class RandomNoise;
+
+		bool valid;
+		bool animated;
+		int seed, subseed, x, y, t, loop;
+		SmoothType smooth;
+		float value[4][4][4];
+
+	public:
+		Cell(): valid(false) { }
+	};
+
 	float operator()(int subseed,int x,int y=0, int t=0)const;
-	float operator()(SmoothType smooth,int subseed,float x,float y=0,float t=0,int loop=0)const;
+	float operator()(SmoothType smooth,int subseed,float x,float y=0,float t=0,int loop=0,Cell *cell=0)const;
 };
 
 /* === E N D =============================================================== */
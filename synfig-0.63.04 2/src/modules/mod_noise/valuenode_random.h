@@ -70,6 +70,9 @@ public:
 	void randomize_seed();
 
 protected:
+	//! The value drifts over time at the given speed
+	virtual bool is_time_dependent_vfunc()const { return true; }
+
 	LinkableValueNode* create_new()const;
 	virtual bool set_link_vfunc(int i,ValueNode::Handle x);
 
@@ -33,6 +33,7 @@
 #endif
 
 #include "trgt_openexr.h"
+#include <synfig/general.h>
 #include <ETL/stringf>
 #include <cstdio>
 #include <algorithm>
@@ -127,9 +128,10 @@ exr_trgt::start_frame(synfig::ProgressCallback *cb)
 	if(buffer_color) delete [] buffer_color;
 	buffer_color=new Color[w];
 #endif
-	//if(buffer) delete [] buffer;
-	//buffer=new Imf::Rgba[w];
-	out_surface.set_wh(w,h);
+	// Scanlines are written to the file as they come,
+	// so that only one of them is ever held here
+	if(buffer) delete [] buffer;
+	buffer=new Imf::Rgba[w];
 
 	return true;
 }
@@ -138,12 +140,7 @@ void
 exr_trgt::end_frame()
 {
 	if(exr_file)
-	{
-		exr_file->setFrameBuffer(out_surface[0],1,desc.get_w());
-		exr_file->writePixels(desc.get_h());
-
 		delete exr_file;
-	}
 
 	exr_file=0;
 
@@ -157,8 +154,7 @@ exr_trgt::start_scanline(int i)
 #ifndef USE_HALF_TYPE
 	return reinterpret_cast<Color *>(buffer_color);
 #else
-	return reinterpret_cast<Color *>(out_surface[scanline]);
-//	return reinterpret_cast<unsigned char *>(buffer);
+	return reinterpret_cast<Color *>(buffer);
 #endif
 }
 
@@ -172,8 +168,7 @@ exr_trgt::end_scanline()
 	int i;
 	for(i=0;i<desc.get_w();i++)
 	{
-//		Imf::Rgba &rgba=buffer[i];
-		Imf::Rgba &rgba=out_surface[scanline][i];
+		Imf::Rgba &rgba=buffer[i];
 		Color &color=buffer_color[i];
 		rgba.r=color.get_r();
 		rgba.g=color.get_g();
@@ -182,8 +177,18 @@ exr_trgt::end_scanline()
 	}
 #endif
 
-    //exr_file->setFrameBuffer(buffer,1,desc.get_w());
-	//exr_file->writePixels(1);
+	// The frame buffer is placed so that this scanline lands in
+	// the buffer, and scanlines come in order from the top down
+	try
+	{
+		exr_file->setFrameBuffer(buffer-scanline*desc.get_w(),1,desc.get_w());
+		exr_file->writePixels(1);
+	}
+	catch(const std::exception &x)
+	{
+		synfig::error("exr_trgt: %s",x.what());
+		return false;
+	}
 
 	return true;
 }
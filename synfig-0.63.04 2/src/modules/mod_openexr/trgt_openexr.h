@@ -52,8 +52,8 @@ private:
 	int imagecount,scanline;
 	synfig::String filename;
 	Imf::RgbaOutputFile *exr_file;
+	//! The scanline being written
 	Imf::Rgba *buffer;
-	etl::surface<Imf::Rgba> out_surface;
 #ifndef USE_HALF_TYPE
 	synfig::Color *buffer_color;
 #endif
@@ -41,6 +41,7 @@
 #include <synfig/surface.h>
 #include <synfig/value.h>
 #include <synfig/valuenode.h>
+#include <synfig/parallel.h>
 
 #include <ETL/calculus>
 #include <ETL/bezier>
@@ -62,6 +63,9 @@ using namespace etl;
 #define EPSILON				(0.000000001)
 #define CUSP_TANGENT_ADJUST	(0.025)
 
+//! Width and height, in pixels, of the tiles particles are sorted into for drawing
+#define PLANT_TILE_SIZE		64
+
 /* === G L O B A L S ======================================================= */
 
 SYNFIG_LAYER_INIT(Plant);
@@ -73,6 +77,223 @@ SYNFIG_LAYER_SET_CVS_ID(Plant,"$Id$");
 
 /* === P R O C E D U R E S ================================================= */
 
+namespace {
+
+//! A particle as it is to be drawn, see splat()
+struct Splat
+{
+	float x1f, x2f, y1f, y2f;
+	Color color;
+};
+
+};
+
+//! Draws the box \a x1f to \a x2f by \a y1f to \a y2f, in pixels, onto \a dest
+/*!	Pixels which the box only partly covers are drawn with alpha to match,
+**	and nothing is drawn outside of the columns \a left up to \a right and
+**	the rows \a top up to \a bottom. */
+static void
+splat(Surface &dest, const Color &color, float x1f, float x2f, float y1f, float y2f, int left, int top, int right, int bottom)
+{
+	int x1,y1,x2,y2;
+	x1=ceil_to_int(x1f);
+	x2=ceil_to_int(x2f)-1;
+	y1=ceil_to_int(y1f);
+	y2=ceil_to_int(y2f)-1;
+
+	// if the box isn't entirely outside of the clip box, draw it
+	if(x1<=right && y1<=bottom && x2>=left && y2>=top)
+	{
+		float x1e=x1-x1f, x2e=x2f-x2, y1e=y1-y1f, y2e=y2f-y2;
+		// printf("x1e %.4f x2e %.4f y1e %.4f y2e %.4f\n", x1e, x2e, y1e, y2e);
+
+		// adjust the box so it's entirely within the clip box
+		if(x1<=left) { x1=left; x1e=0; }
+		if(y1<=top)  { y1=top;  y1e=0; }
+		if(x2>=right)  { x2=right;  x2e=0; }
+		if(y2>=bottom) { y2=bottom; y2e=0; }
+
+		int w(x2-x1), h(y2-y1);
+
+		Surface::alpha_pen surface_pen(dest.get_pen(x1,y1),1.0f);
+		if(w>0 && h>0)
+			dest.fill(color,surface_pen,w,h);
+
+		/* the rectangle doesn't cross any vertical pixel boundaries so we don't
+		 * need to draw any top or bottom edges
+		 */
+		if(x2<x1)
+		{
+			// case 1 - a single pixel
+			if(y2<y1)
+			{
+				surface_pen.move_to(x2,y2);
+				surface_pen.set_alpha((x2f-x1f)*(y2f-y1f));
+				surface_pen.put_value(color);
+			}
+			// case 2 - a single vertical column of pixels
+			else
+			{
+				surface_pen.move_to(x2,y1-1);
+				if (y1e!=0)	// maybe draw top pixel
+				{
+					surface_pen.set_alpha(y1e*(x2f-x1f));
+					surface_pen.put_value(color);
+				}
+				surface_pen.inc_y();
+				surface_pen.set_alpha(x2f-x1f);
+				for(int i=y1; i<y2; i++) // maybe draw pixels between
+				{
+					surface_pen.put_value(color);
+					surface_pen.inc_y();
+				}
+				if (y2e!=0)	// maybe draw bottom pixel
+				{
+					surface_pen.set_alpha(y2e*(x2f-x1f));
+					surface_pen.put_value(color);
+				}
+			}
+		}
+		else
+		{
+			// case 3 - a single horizontal row of pixels
+			if(y2<y1)
+			{
+				surface_pen.move_to(x1-1,y2);
+				if (x1e!=0)	// maybe draw left pixel
+				{
+					surface_pen.set_alpha(x1e*(y2f-y1f));
+					surface_pen.put_value(color);
+				}
+				surface_pen.inc_x();
+				surface_pen.set_alpha(y2f-y1f);
+				for(int i=x1; i<x2; i++) // maybe draw pixels between
+				{
+					surface_pen.put_value(color);
+					surface_pen.inc_x();
+				}
+				if (x2e!=0)	// maybe draw right pixel
+				{
+					surface_pen.set_alpha(x2e*(y2f-y1f));
+					surface_pen.put_value(color);
+				}
+			}
+			// case 4 - a proper block of pixels
+			else
+			{
+				if (x1e!=0)	// maybe draw left edge
+				{
+					surface_pen.move_to(x1-1,y1-1);
+					if (y1e!=0)	// maybe draw top left pixel
+					{
+						surface_pen.set_alpha(x1e*y1e);
+						surface_pen.put_value(color);
+					}
+					surface_pen.inc_y();
+					surface_pen.set_alpha(x1e);
+					for(int i=y1; i<y2; i++) // maybe draw pixels along the left edge
+					{
+						surface_pen.put_value(color);
+						surface_pen.inc_y();
+					}
+					if (y2e!=0)	// maybe draw bottom left pixel
+					{
+						surface_pen.set_alpha(x1e*y2e);
+						surface_pen.put_value(color);
+					}
+					surface_pen.inc_x();
+				}
+				else
+					surface_pen.move_to(x1,y2);
+
+				if (y2e!=0)	// maybe draw bottom edge
+				{
+					surface_pen.set_alpha(y2e);
+					for(int i=x1; i<x2; i++) // maybe draw pixels along the bottom edge
+					{
+						surface_pen.put_value(color);
+						surface_pen.inc_x();
+					}
+					if (x2e!=0)	// maybe draw bottom right pixel
+					{
+						surface_pen.set_alpha(x2e*y2e);
+						surface_pen.put_value(color);
+					}
+					surface_pen.dec_y();
+				}
+				else
+					surface_pen.move_to(x2,y2-1);
+
+				if (x2e!=0)	// maybe draw right edge
+				{
+					surface_pen.set_alpha(x2e);
+					for(int i=y1; i<y2; i++) // maybe draw pixels along the right edge
+					{
+						surface_pen.put_value(color);
+						surface_pen.dec_y();
+					}
+					if (y1e!=0)	// maybe draw top right pixel
+					{
+						surface_pen.set_alpha(x2e*y1e);
+						surface_pen.put_value(color);
+					}
+					surface_pen.dec_x();
+				}
+				else
+					surface_pen.move_to(x2-1,y1-1);
+
+				if (y1e!=0)	// maybe draw top edge
+				{
+					surface_pen.set_alpha(y1e);
+					for(int i=x1; i<x2; i++) // maybe draw pixels along the top edge
+					{
+						surface_pen.put_value(color);
+						surface_pen.dec_x();
+					}
+				}
+			}
+		}
+	}
+}
+
+namespace {
+
+//! Draws the particles of every tile in a row of tiles, see Plant::accelerated_render()
+class SplatTiles : public RowTask
+{
+	Surface &dest;
+	const std::vector<Splat> &splat_list;
+	const std::vector<std::vector<int> > &tile_list;
+	int tiles_x;
+
+public:
+	SplatTiles(Surface &dest, const std::vector<Splat> &splat_list, const std::vector<std::vector<int> > &tile_list, int tiles_x):
+		dest(dest),
+		splat_list(splat_list),
+		tile_list(tile_list),
+		tiles_x(tiles_x)
+	{ }
+
+	virtual void rows(int begin, int end)
+	{
+		for (int ty = begin; ty < end; ty++)
+			for (int tx = 0; tx < tiles_x; tx++)
+			{
+				const std::vector<int> &tile(tile_list[ty*tiles_x+tx]);
+				const int left(tx*PLANT_TILE_SIZE), top(ty*PLANT_TILE_SIZE);
+				const int right(min(left+PLANT_TILE_SIZE,dest.get_w())), bottom(min(top+PLANT_TILE_SIZE,dest.get_h()));
+
+				for (std::vector<int>::const_iterator iter = tile.begin(); iter != tile.end(); ++iter)
+				{
+					const Splat &splat(splat_list[*iter]);
+					::splat(dest,splat.color,splat.x1f,splat.x2f,splat.y1f,splat.y2f,left,top,right,bottom);
+				}
+			}
+	}
+};
+
+};
+
 /* === M E T H O D S ======================================================= */
 
 
@@ -109,6 +330,7 @@ Plant::Plant():
 	drag=0.1;
 	size=0.015;
 	needs_sync_=true;
+	needs_regrow_=true;
 	sync();
 	size_as_alpha=false;
 	reverse=true;
@@ -117,7 +339,7 @@ Plant::Plant():
 }
 
 void
-Plant::branch(int n,int depth,float t, float stunt_growth, synfig::Point position,synfig::Vector vel)const
+Plant::branch(Segment &segment, int n,int depth,float t, float stunt_growth, synfig::Point position,synfig::Vector vel)const
 {
 	float next_split((1.0-t)/(splits-depth)+t/*+random_factor*random(40+depth,t*splits,0,0)/splits*/);
 	for(;t<next_split;t+=step)
@@ -128,11 +350,11 @@ Plant::branch(int n,int depth,float t, float stunt_growth, synfig::Point positio
 		position[0]+=vel[0]*step;
 		position[1]+=vel[1]*step;
 
-		particle_list.push_back(Particle(position, gradient(t)));
-		if (particle_list.size() % 1000000 == 0)
-			synfig::info("constructed %d million particles...", particle_list.size()/1000000);
+		segment.particle_list.push_back(Particle(position, gradient(t)));
+		if (segment.particle_list.size() % 1000000 == 0)
+			synfig::info("constructed %d million particles...", segment.particle_list.size()/1000000);
 
-		bounding_rect.expand(position);
+		segment.bounding_rect.expand(position);
 	}
 
 	if(t>=1.0-stunt_growth)return;
@@ -145,8 +367,8 @@ Plant::branch(int n,int depth,float t, float stunt_growth, synfig::Point positio
 	synfig::Vector velocity2(vel[0]*sin_v + vel[1]*cos_v + random_factor*random(Random::SMOOTH_COSINE, 31+n+depth, t*splits, 0.0f, 0.0f),
 							-vel[0]*cos_v + vel[1]*sin_v + random_factor*random(Random::SMOOTH_COSINE, 33+n+depth, t*splits, 0.0f, 0.0f));
 
-	Plant::branch(n,depth+1,t,stunt_growth,position,velocity1);
-	Plant::branch(n,depth+1,t,stunt_growth,position,velocity2);
+	Plant::branch(segment,n,depth+1,t,stunt_growth,position,velocity1);
+	Plant::branch(segment,n,depth+1,t,stunt_growth,position,velocity2);
 }
 
 void
@@ -181,95 +403,134 @@ Plant::calc_bounding_rect()const
 	bounding_rect.expand_y(size);
 }
 
+void
+Plant::grow(Segment &segment, int seg)const
+{
+	segment.particle_list.clear();
+	segment.bounding_rect=Rect::zero();
+
+	etl::hermite<Vector> curve;
+
+	Real step(abs(this->step));
+
+	float iterw=segment.w1;	// the width value of the iter vertex
+	float nextw=segment.w2;	// the width value of the next vertex
+	float width;			// the width at an intermediate position
+	curve.p1()=segment.p1;
+	curve.t1()=segment.t1;
+	curve.p2()=segment.p2;
+	curve.t2()=segment.t2;
+	curve.sync();
+	etl::derivative<etl::hermite<Vector> > deriv(curve);
+
+	Real f;
+
+	int i=0, branch_count = 0, steps = round_to_int(1.0/step);
+	if (steps < 1) steps = 1;
+	for(f=0.0;f<1.0;f+=step,i++)
+	{
+		Point point(curve(f));
+
+		segment.particle_list.push_back(Particle(point, gradient(0)));
+		if (segment.particle_list.size() % 1000000 == 0)
+			synfig::info("constructed %d million particles...", segment.particle_list.size()/1000000);
+
+		segment.bounding_rect.expand(point);
+
+		Real stunt_growth(random_factor * (random(Random::SMOOTH_COSINE,i,f+seg,0.0f,0.0f)/2.0+0.5));
+		stunt_growth*=stunt_growth;
+
+		if((((i+1)*sprouts + steps/2) / steps) > branch_count) {
+			Vector branch_velocity(deriv(f).norm()*velocity + deriv(f).perp().norm()*perp_velocity);
+
+			if (isnan(branch_velocity[0]) || isnan(branch_velocity[1]))
+				continue;
+
+			branch_velocity[0] += random_factor * random(Random::SMOOTH_COSINE, 1, f*splits, 0.0f, 0.0f);
+			branch_velocity[1] += random_factor * random(Random::SMOOTH_COSINE, 2, f*splits, 0.0f, 0.0f);
+
+			if (use_width)
+			{
+				width = iterw+(nextw-iterw)*f; // calculate the width based on the current position
+
+				branch_velocity[0] *= width; // scale the velocity accordingly to the current width
+				branch_velocity[1] *= width;
+			}
+
+			branch_count++;
+			branch(segment, i, 0, 0,	 // time
+				   stunt_growth, // stunt growth
+				   point, branch_velocity);
+		}
+	}
+
+	segment.grown=true;
+}
+
 void
 Plant::sync()const
 {
 	Mutex::Lock lock(mutex);
 	if (!needs_sync_) return;
 	time_t start_time; time(&start_time);
-	particle_list.clear();
+
+	if (needs_regrow_)
+	{
+		segment_list.clear();
+		needs_regrow_=false;
+	}
 
 	bounding_rect=Rect::zero();
 
 	// Bline must have at least 2 points in it
 	if(bline.size()<2)
 	{
+		segment_list.clear();
 		needs_sync_=false;
 		return;
 	}
 
 	std::vector<synfig::BLinePoint>::const_iterator iter,next;
 
-	etl::hermite<Vector> curve;
-
-	Real step(abs(this->step));
-
-	int seg(0);
+	int seg(0), regrown(0);
+	size_t particles(0);
 
 	next=bline.begin();
 
 	if(bline_loop)	iter=--bline.end(); // iter is the last  bline in the list; next is the first  bline in the list
 	else			iter=next++;		// iter is the first bline in the list; next is the second bline in the list
 
+	segment_list.resize(bline_loop ? bline.size() : bline.size()-1);
+
 	// loop through the bline; seg counts the blines as we do so; stop before iter is the last bline in the list
 	for(;next!=bline.end();iter=next++,seg++)
 	{
-		float iterw=iter->get_width();	// the width value of the iter vertex
-		float nextw=next->get_width();	// the width value of the next vertex
-		float width;					// the width at an intermediate position
-		curve.p1()=iter->get_vertex();
-		curve.t1()=iter->get_tangent2();
-		curve.p2()=next->get_vertex();
-		curve.t2()=next->get_tangent1();
-		curve.sync();
-		etl::derivative<etl::hermite<Vector> > deriv(curve);
-
-		Real f;
-
-		int i=0, branch_count = 0, steps = round_to_int(1.0/step);
-		if (steps < 1) steps = 1;
-		for(f=0.0;f<1.0;f+=step,i++)
-		{
-			Point point(curve(f));
-
-			particle_list.push_back(Particle(point, gradient(0)));
-			if (particle_list.size() % 1000000 == 0)
-				synfig::info("constructed %d million particles...", particle_list.size()/1000000);
-
-			bounding_rect.expand(point);
-
-			Real stunt_growth(random_factor * (random(Random::SMOOTH_COSINE,i,f+seg,0.0f,0.0f)/2.0+0.5));
-			stunt_growth*=stunt_growth;
-
-			if((((i+1)*sprouts + steps/2) / steps) > branch_count) {
-				Vector branch_velocity(deriv(f).norm()*velocity + deriv(f).perp().norm()*perp_velocity);
-
-				if (isnan(branch_velocity[0]) || isnan(branch_velocity[1]))
-					continue;
-
-				branch_velocity[0] += random_factor * random(Random::SMOOTH_COSINE, 1, f*splits, 0.0f, 0.0f);
-				branch_velocity[1] += random_factor * random(Random::SMOOTH_COSINE, 2, f*splits, 0.0f, 0.0f);
+		Segment &segment(segment_list[seg]);
 
-				if (use_width)
-				{
-					width = iterw+(nextw-iterw)*f; // calculate the width based on the current position
-
-					branch_velocity[0] *= width; // scale the velocity accordingly to the current width
-					branch_velocity[1] *= width;
-				}
-
-				branch_count++;
-				branch(i, 0, 0,		 // time
-					   stunt_growth, // stunt growth
-					   point, branch_velocity);
-			}
+		// only regrow the segments whose part of the bline has changed
+		if (!segment.grown ||
+			segment.p1!=iter->get_vertex() || segment.t1!=iter->get_tangent2() || segment.w1!=iter->get_width() ||
+			segment.p2!=next->get_vertex() || segment.t2!=next->get_tangent1() || segment.w2!=next->get_width())
+		{
+			segment.p1=iter->get_vertex();
+			segment.t1=iter->get_tangent2();
+			segment.w1=iter->get_width();
+			segment.p2=next->get_vertex();
+			segment.t2=next->get_tangent1();
+			segment.w2=next->get_width();
+			grow(segment,seg);
+			regrown++;
 		}
+
+		bounding_rect.expand(segment.bounding_rect.get_min());
+		bounding_rect.expand(segment.bounding_rect.get_max());
+		particles+=segment.particle_list.size();
 	}
 
 	time_t end_time; time(&end_time);
 	if (end_time-start_time > 4)
-		synfig::info("Plant::sync() constructed %d particles in %d seconds\n",
-					 particle_list.size(), int(end_time-start_time));
+		synfig::info("Plant::sync() regrew %d of %d segments, %d particles in all, in %d seconds\n",
+					 regrown, seg, int(particles), int(end_time-start_time));
 	needs_sync_=false;
 }
 
@@ -287,18 +548,18 @@ Plant::set_param(const String & param, const ValueBase &value)
 	if(param=="seed" && value.same_type_as(int()))
 	{
 		random.set_seed(value.get(int()));
-		needs_sync_=true;
+		needs_sync_=needs_regrow_=true;
 		set_param_static(param, value.get_static());
 		return true;
 	}
 	IMPORT(origin);
-	IMPORT_PLUS(split_angle,needs_sync_=true);
-	IMPORT_PLUS(gravity,needs_sync_=true);
-	IMPORT_PLUS(gradient,needs_sync_=true);
-	IMPORT_PLUS(velocity,needs_sync_=true);
-	IMPORT_PLUS(perp_velocity,needs_sync_=true);
+	IMPORT_PLUS(split_angle,needs_sync_=needs_regrow_=true);
+	IMPORT_PLUS(gravity,needs_sync_=needs_regrow_=true);
+	IMPORT_PLUS(gradient,needs_sync_=needs_regrow_=true);
+	IMPORT_PLUS(velocity,needs_sync_=needs_regrow_=true);
+	IMPORT_PLUS(perp_velocity,needs_sync_=needs_regrow_=true);
 	IMPORT_PLUS(step,{
-			needs_sync_ = true;
+			needs_sync_ = needs_regrow_ = true;
 			if (step <= 0)
 				step=0.01; // user is probably clueless - give a good default
 			else if (step < 0.00001)
@@ -307,17 +568,17 @@ Plant::set_param(const String & param, const ValueBase &value)
 				step=1;
 		});
 	IMPORT_PLUS(splits,{
-			needs_sync_=true;
+			needs_sync_=needs_regrow_=true;
 			if (splits < 1)
 				splits = 1;
 		});
-	IMPORT_PLUS(sprouts,needs_sync_=true);
-	IMPORT_PLUS(random_factor,needs_sync_=true);
-	IMPORT_PLUS(drag,needs_sync_=true);
+	IMPORT_PLUS(sprouts,needs_sync_=needs_regrow_=true);
+	IMPORT_PLUS(random_factor,needs_sync_=needs_regrow_=true);
+	IMPORT_PLUS(drag,needs_sync_=needs_regrow_=true);
 	IMPORT(size);
 	IMPORT(size_as_alpha);
 	IMPORT(reverse);
-	IMPORT(use_width);
+	IMPORT_PLUS(use_width,needs_sync_=needs_regrow_=true);
 
 	IMPORT_AS(origin,"offset");
 
@@ -485,7 +746,10 @@ Plant::set_version(const String &ver)
 	version = ver;
 
 	if (version == "0.1")
+	{
 		use_width = false;
+		needs_sync_ = needs_regrow_ = true;
+	}
 
 	return true;
 }
@@ -520,29 +784,34 @@ Plant::accelerated_render(Context context,Surface *surface,int quality, const Re
 	if(needs_sync_==true)
 		sync();
 
-	if (particle_list.begin() != particle_list.end())
-	{
-		std::vector<Particle>::iterator iter;
-		Particle *particle;
+	float radius(size*sqrt(1.0f/(abs(pw)*abs(ph))));
 
-		float radius(size*sqrt(1.0f/(abs(pw)*abs(ph))));
+	// Work out the box each particle will be drawn as, in drawing order,
+	// and sort those which reach the canvas into the tiles they touch.
+	// Each tile is then drawn on its own with its particles still in
+	// order, so that drawing stays within a small area of the surface.
+	const int tiles_x((surface_width+PLANT_TILE_SIZE-1)/PLANT_TILE_SIZE);
+	const int tiles_y((surface_height+PLANT_TILE_SIZE-1)/PLANT_TILE_SIZE);
+	std::vector<Splat> splat_list;
+	std::vector<std::vector<int> > tile_list(tiles_x*tiles_y);
 
-		int x1,y1,x2,y2;
-
-		if (reverse)	iter = particle_list.end();
-		else			iter = particle_list.begin();
+	const int segments(segment_list.size());
+	for (int s = 0; s < segments; s++)
+	{
+		const std::vector<Particle> &particle_list(segment_list[reverse ? segments-1-s : s].particle_list);
+		const int count(particle_list.size());
 
-		while (true)
+		for (int i = 0; i < count; i++)
 		{
-			if (reverse)	particle = &(*(iter-1));
-			else			particle = &(*iter);
+			const Particle &particle(particle_list[reverse ? count-1-i : i]);
 
 			float scaled_radius(radius);
-			Color color(particle->color);
+			Splat splat;
+			splat.color=particle.color;
 			if(size_as_alpha)
 			{
-				scaled_radius*=color.get_a();
-				color.set_a(1);
+				scaled_radius*=splat.color.get_a();
+				splat.color.set_a(1);
 			}
 
 			// previously, radius was multiplied by sqrt(step)*12 only if
@@ -551,182 +820,31 @@ Plant::accelerated_render(Context context,Surface *surface,int quality, const Re
 			// seems a little arbitrary - does it help?
 
 			// calculate the box that this particle will be drawn as
-			float x1f=(particle->point[0]-tl[0])/pw-(scaled_radius*0.5);
-			float x2f=(particle->point[0]-tl[0])/pw+(scaled_radius*0.5);
-			float y1f=(particle->point[1]-tl[1])/ph-(scaled_radius*0.5);
-			float y2f=(particle->point[1]-tl[1])/ph+(scaled_radius*0.5);
-			x1=ceil_to_int(x1f);
-			x2=ceil_to_int(x2f)-1;
-			y1=ceil_to_int(y1f);
-			y2=ceil_to_int(y2f)-1;
-
-			// if the box isn't entirely off the canvas, draw it
-			if(x1<=surface_width && y1<=surface_height && x2>=0 && y2>=0)
-			{
-				float x1e=x1-x1f, x2e=x2f-x2, y1e=y1-y1f, y2e=y2f-y2;
-				// printf("x1e %.4f x2e %.4f y1e %.4f y2e %.4f\n", x1e, x2e, y1e, y2e);
-
-				// adjust the box so it's entirely on the canvas
-				if(x1<=0) { x1=0; x1e=0; }
-				if(y1<=0) { y1=0; y1e=0; }
-				if(x2>=surface_width)  { x2=surface_width;  x2e=0; }
-				if(y2>=surface_height) { y2=surface_height; y2e=0; }
-
-				int w(x2-x1), h(y2-y1);
-
-				Surface::alpha_pen surface_pen(dest_surface.get_pen(x1,y1),1.0f);
-				if(w>0 && h>0)
-					dest_surface.fill(color,surface_pen,w,h);
-
-				/* the rectangle doesn't cross any vertical pixel boundaries so we don't
-				 * need to draw any top or bottom edges
-				 */
-				if(x2<x1)
-				{
-					// case 1 - a single pixel
-					if(y2<y1)
-					{
-						surface_pen.move_to(x2,y2);
-						surface_pen.set_alpha((x2f-x1f)*(y2f-y1f));
-						surface_pen.put_value(color);
-					}
-					// case 2 - a single vertical column of pixels
-					else
-					{
-						surface_pen.move_to(x2,y1-1);
-						if (y1e!=0)	// maybe draw top pixel
-						{
-							surface_pen.set_alpha(y1e*(x2f-x1f));
-							surface_pen.put_value(color);
-						}
-						surface_pen.inc_y();
-						surface_pen.set_alpha(x2f-x1f);
-						for(int i=y1; i<y2; i++) // maybe draw pixels between
-						{
-							surface_pen.put_value(color);
-							surface_pen.inc_y();
-						}
-						if (y2e!=0)	// maybe draw bottom pixel
-						{
-							surface_pen.set_alpha(y2e*(x2f-x1f));
-							surface_pen.put_value(color);
-						}
-					}
-				}
-				else
-				{
-					// case 3 - a single horizontal row of pixels
-					if(y2<y1)
-					{
-						surface_pen.move_to(x1-1,y2);
-						if (x1e!=0)	// maybe draw left pixel
-						{
-							surface_pen.set_alpha(x1e*(y2f-y1f));
-							surface_pen.put_value(color);
-						}
-						surface_pen.inc_x();
-						surface_pen.set_alpha(y2f-y1f);
-						for(int i=x1; i<x2; i++) // maybe draw pixels between
-						{
-							surface_pen.put_value(color);
-							surface_pen.inc_x();
-						}
-						if (x2e!=0)	// maybe draw right pixel
-						{
-							surface_pen.set_alpha(x2e*(y2f-y1f));
-							surface_pen.put_value(color);
-						}
-					}
-					// case 4 - a proper block of pixels
-					else
-					{
-						if (x1e!=0)	// maybe draw left edge
-						{
-							surface_pen.move_to(x1-1,y1-1);
-							if (y1e!=0)	// maybe draw top left pixel
-							{
-								surface_pen.set_alpha(x1e*y1e);
-								surface_pen.put_value(color);
-							}
-							surface_pen.inc_y();
-							surface_pen.set_alpha(x1e);
-							for(int i=y1; i<y2; i++) // maybe draw pixels along the left edge
-							{
-								surface_pen.put_value(color);
-								surface_pen.inc_y();
-							}
-							if (y2e!=0)	// maybe draw bottom left pixel
-							{
-								surface_pen.set_alpha(x1e*y2e);
-								surface_pen.put_value(color);
-							}
-							surface_pen.inc_x();
-						}
-						else
-							surface_pen.move_to(x1,y2);
-
-						if (y2e!=0)	// maybe draw bottom edge
-						{
-							surface_pen.set_alpha(y2e);
-							for(int i=x1; i<x2; i++) // maybe draw pixels along the bottom edge
-							{
-								surface_pen.put_value(color);
-								surface_pen.inc_x();
-							}
-							if (x2e!=0)	// maybe draw bottom right pixel
-							{
-								surface_pen.set_alpha(x2e*y2e);
-								surface_pen.put_value(color);
-							}
-							surface_pen.dec_y();
-						}
-						else
-							surface_pen.move_to(x2,y2-1);
-
-						if (x2e!=0)	// maybe draw right edge
-						{
-							surface_pen.set_alpha(x2e);
-							for(int i=y1; i<y2; i++) // maybe draw pixels along the right edge
-							{
-								surface_pen.put_value(color);
-								surface_pen.dec_y();
-							}
-							if (y1e!=0)	// maybe draw top right pixel
-							{
-								surface_pen.set_alpha(x2e*y1e);
-								surface_pen.put_value(color);
-							}
-							surface_pen.dec_x();
-						}
-						else
-							surface_pen.move_to(x2-1,y1-1);
-
-						if (y1e!=0)	// maybe draw top edge
-						{
-							surface_pen.set_alpha(y1e);
-							for(int i=x1; i<x2; i++) // maybe draw pixels along the top edge
-							{
-								surface_pen.put_value(color);
-								surface_pen.dec_x();
-							}
-						}
-					}
-				}
-			}
-
-			if (reverse)
-			{
-				if (--iter == particle_list.begin())
-					break;
-			}
-			else
-			{
-				if (++iter == particle_list.end())
-					break;
-			}
+			splat.x1f=(particle.point[0]-tl[0])/pw-(scaled_radius*0.5);
+			splat.x2f=(particle.point[0]-tl[0])/pw+(scaled_radius*0.5);
+			splat.y1f=(particle.point[1]-tl[1])/ph-(scaled_radius*0.5);
+			splat.y2f=(particle.point[1]-tl[1])/ph+(scaled_radius*0.5);
+
+			// the columns touched run from the one holding the left
+			// edge, ceil(x1f)-1, to the one holding the right, ceil(x2f)-1
+			const int x1(max(ceil_to_int(splat.x1f)-1,0)), x2(min(ceil_to_int(splat.x2f)-1,surface_width-1));
+			const int y1(max(ceil_to_int(splat.y1f)-1,0)), y2(min(ceil_to_int(splat.y2f)-1,surface_height-1));
+			if(x1>x2 || y1>y2)
+				continue;
+
+			const int index(splat_list.size());
+			splat_list.push_back(splat);
+			for(int ty=y1/PLANT_TILE_SIZE;ty<=y2/PLANT_TILE_SIZE;ty++)
+				for(int tx=x1/PLANT_TILE_SIZE;tx<=x2/PLANT_TILE_SIZE;tx++)
+					tile_list[ty*tiles_x+tx].push_back(index);
 		}
 	}
 
+	// No two tiles draw onto the same pixels, so the rows of tiles are
+	// split between threads
+	SplatTiles tiles(dest_surface,splat_list,tile_list,tiles_x);
+	parallel_rows(tiles,tiles_y,1);
+
 	Surface::alpha_pen pen(surface->get_pen(0,0),get_amount(),get_blend_method());
 	dest_surface.blit_to(pen);
 
@@ -70,7 +70,23 @@ private:
 			point(point),color(color) { }
 	};
 
-	mutable std::vector<Particle> particle_list;
+	//! The particles grown from one segment of the bline
+	/*!	Each segment's growth only depends on its own two vertices, its
+	**	position in the bline and the other parameters, so when just the
+	**	bline changes only the segments which moved have to be regrown. */
+	struct Segment
+	{
+		synfig::Point p1, t1, p2, t2;	//!< the hermite the segment was grown from
+		float w1, w2;					//!< the widths at either end of it
+		bool grown;
+
+		std::vector<Particle> particle_list;
+		synfig::Rect bounding_rect;
+
+		Segment():w1(0),w2(0),grown(false) { }
+	};
+
+	mutable std::vector<Segment> segment_list;
 	mutable synfig::Rect	bounding_rect;
 	synfig::Angle split_angle;
 	synfig::Vector gravity;
@@ -88,9 +104,12 @@ private:
 	bool size_as_alpha;
 	bool reverse;
 	mutable bool needs_sync_;
+	//! Set when a parameter other than the bline changed, so that no segment can be kept
+	mutable bool needs_regrow_;
 	mutable synfig::Mutex mutex;
 
-	void branch(int n, int depth,float t, float stunt_growth, synfig::Point position,synfig::Vector velocity)const;
+	void branch(Segment &segment, int n, int depth,float t, float stunt_growth, synfig::Point position,synfig::Vector velocity)const;
+	void grow(Segment &segment, int seg)const;
 	void sync()const;
 	String version;
 	bool use_width;
@@ -83,6 +83,17 @@ public:
 
 	void reverse();
 
+	//! Compares the geometry of two points, ignoring their UniqueID
+	bool is_equal_to(const BLinePoint& rhs)const
+	{
+		return vertex_.is_equal_to(rhs.vertex_)
+			&& get_tangent1().is_equal_to(rhs.get_tangent1())
+			&& get_tangent2().is_equal_to(rhs.get_tangent2())
+			&& width_==rhs.width_
+			&& origin_==rhs.origin_
+			&& split_tangent_==rhs.split_tangent_;
+	}
+
 }; // END of class BLinePoint
 
 }; // END of namespace synfig
@@ -33,8 +33,10 @@
 #include <synfig/surface.h>
 
 #include "blur.h"
+#include "parallel.h"
 
 #include <stdexcept>
+#include <vector>
 #include <ETL/stringf>
 
 #include <ETL/pen>
@@ -133,6 +135,210 @@ inline Color zero<Color>()
 	return Color::alpha();
 }
 
+//! Averages the rows of a disc blur from \a src into \a dest
+/*!	Each row of the ellipse is summed along the source row through a
+**	window which adds the pixel coming in and subtracts the one going
+**	out, so the sums stay as precise as the pixels themselves rather
+**	than the whole row. */
+template <typename T,typename AT,class VP>
+class DiscBlurRows : public RowTask
+{
+	etl::surface<T,AT,VP> &dest;
+	const etl::surface<T,AT,VP> &src;
+	const std::vector<int> &span;
+	int total;
+
+public:
+	DiscBlurRows(etl::surface<T,AT,VP> &dest, const etl::surface<T,AT,VP> &src, const std::vector<int> &span, int total):
+		dest(dest),
+		src(src),
+		span(span),
+		total(total)
+	{ }
+
+	virtual void rows(int begin, int end)
+	{
+		const int w = src.get_w(),
+				  h = src.get_h(),
+				  bh = span.size()/2;
+		std::vector<T> line(w);
+		int x,y,y2;
+
+		for(y=begin;y<end;y++)
+		{
+			std::fill(line.begin(),line.end(),zero<T>());
+			for(y2=-bh;y2<=bh;y2++)
+			{
+				const int hw = span[y2+bh];
+				if(hw < 0)
+					continue;
+
+				int v = y+y2;
+				if( v < 0 )	v = 0;
+				if( v >= h ) v = h-1;
+
+				// Pixels outside the surface repeat the nearest edge pixel
+				const T *row = src[v];
+				T sum = zero<T>();
+				for(x=-hw;x<=hw;x++)
+					sum += row[std::min(std::max(x,0),w-1)];
+				for(x=0;x<w;x++)
+				{
+					line[x] += sum;
+					sum += row[std::min(x+hw+1,w-1)] - row[std::max(x-hw,0)];
+				}
+			}
+			for(x=0;x<w;x++)
+				dest[y][x] = line[x]/total;
+		}
+	}
+};
+
+//! Averages every pixel with the ones inside an ellipse of half-size bw by bh
+/*!	The ellipse is stored as the half-width of each of its rows, so each
+**	output pixel costs one addition and one subtraction per row of the
+**	ellipse rather than one addition per pixel inside it.  The rows are
+**	split between threads by parallel_rows(). */
+template <typename T,typename AT,class VP>
+static bool DiscBlur(etl::surface<T,AT,VP> &surface,int bw,int bh,synfig::SuperCallback &cb)
+{
+	int y2;
+
+	// Half-width of each row of the disc, or -1 when the row is empty
+	std::vector<int> span(2*bh+1);
+	int total = 0;
+	for(y2=-bh;y2<=bh;y2++)
+	{
+		int &hw = span[y2+bh];
+		hw = -1;
+		for(int x2=0;x2<=bw;x2++)
+		{
+			float tmp_x=(float)x2/bw;
+			float tmp_y=(float)y2/bh;
+			if(tmp_x*tmp_x+tmp_y*tmp_y>1.0)
+				break;
+			hw = x2;
+		}
+		if(hw >= 0)
+			total += hw*2+1;
+	}
+
+	const etl::surface<T,AT,VP> src(surface);
+	DiscBlurRows<T,AT,VP> task(surface,src,span,total);
+	parallel_rows(task,surface.get_h());
+
+	return cb.amount_complete(1,1);
+}
+
+//! Smallest blur (in passes of the 2x2 kernel) handed to GaussianBlur_IIR()
+#define GAUSSIAN_IIR_MIN_SIZE	16
+
+//! Applies the recursive gaussian of Young and van Vliet to a line of samples
+/*!	The filter runs forward then backward over \a line, so its cost does
+**	not depend on \a sigma.  The ends are primed with the edge samples. */
+template <typename T>
+static void GaussianBlur_IIR_line(std::vector<T> &line, float sigma)
+{
+	const int n = line.size();
+	if(n < 2)
+		return;
+
+	const float q = sigma >= 2.5f
+		? 0.98711f*sigma - 0.96330f
+		: 3.97156f - 4.14554f*sqrt(1.0f - 0.26891f*sigma);
+	const float q2 = q*q, q3 = q2*q;
+	const float b0 = 1.57825f + 2.44413f*q + 1.4281f*q2 + 0.422205f*q3;
+	const float b1 = (2.44413f*q + 2.85619f*q2 + 1.26661f*q3)/b0;
+	const float b2 = -(1.4281f*q2 + 1.26661f*q3)/b0;
+	const float b3 = (0.422205f*q3)/b0;
+	const float B = 1.0f - (b1 + b2 + b3);
+
+	int i;
+	T w1(line[0]), w2(line[0]), w3(line[0]);
+	for(i=0;i<n;i++)
+	{
+		const T v(line[i]*B + w1*b1 + w2*b2 + w3*b3);
+		w3 = w2; w2 = w1; w1 = v;
+		line[i] = v;
+	}
+
+	w1 = w2 = w3 = line[n-1];
+	for(i=n-1;i>=0;i--)
+	{
+		const T v(line[i]*B + w1*b1 + w2*b2 + w3*b3);
+		w3 = w2; w2 = w1; w1 = v;
+		line[i] = v;
+	}
+}
+
+//! Runs GaussianBlur_IIR_line() over the rows, or the columns, of a surface
+/*!	Each call to rows() has its own line buffer, so the lines can be
+**	split between threads by parallel_rows(). */
+template <typename T,typename AT,class VP>
+class GaussianBlur_IIR_Pass : public RowTask
+{
+	etl::surface<T,AT,VP> &surface;
+	float sigma;
+	bool columns;
+
+public:
+	GaussianBlur_IIR_Pass(etl::surface<T,AT,VP> &surface, float sigma, bool columns):
+		surface(surface),
+		sigma(sigma),
+		columns(columns)
+	{ }
+
+	virtual void rows(int begin, int end)
+	{
+		const int w = surface.get_w(),
+				  h = surface.get_h();
+		int x,y;
+
+		if(!columns)
+		{
+			std::vector<T> line(w);
+			for(y=begin;y<end;y++)
+			{
+				std::copy(surface[y],surface[y]+w,line.begin());
+				GaussianBlur_IIR_line(line,sigma);
+				std::copy(line.begin(),line.end(),surface[y]);
+			}
+		}
+		else
+		{
+			std::vector<T> line(h);
+			for(x=begin;x<end;x++)
+			{
+				for(y=0;y<h;y++)
+					line[y] = surface[y][x];
+				GaussianBlur_IIR_line(line,sigma);
+				for(y=0;y<h;y++)
+					surface[y][x] = line[y];
+			}
+		}
+	}
+};
+
+//! Gaussian blur with the given deviations (in pixels), in constant time per pixel
+template <typename T,typename AT,class VP>
+static bool GaussianBlur_IIR(etl::surface<T,AT,VP> &surface,float sigma_x,float sigma_y,synfig::SuperCallback &cb)
+{
+	if(sigma_x > 0)
+	{
+		GaussianBlur_IIR_Pass<T,AT,VP> pass(surface,sigma_x,false);
+		parallel_rows(pass,surface.get_h());
+		if(!cb.amount_complete(1,2))
+			return false;
+	}
+
+	if(sigma_y > 0)
+	{
+		GaussianBlur_IIR_Pass<T,AT,VP> pass(surface,sigma_y,true);
+		parallel_rows(pass,surface.get_w());
+	}
+	return cb.amount_complete(2,2);
+}
+
 template <typename T,typename AT,class VP>
 static void GuassianBlur_2x2(etl::surface<T,AT,VP> &surface)
 {
@@ -494,58 +700,10 @@ bool Blur::operator()(const Surface &surface,
 
 			if(size[0] && size[1] && w*h>2)
 			{
-				int x2,y2;
-				Surface tmp_surface(worksurface);
-
-				for(y=0;y<h;y++)
+				if(!DiscBlur(worksurface,bw,bh,blurcall))
 				{
-					for(x=0;x<w;x++)
-					{
-						//accumulate all the pixels in an ellipse of w,h about the current pixel
-						Color color=Color::alpha();
-						int total=0;
-
-						for(y2=-bh;y2<=bh;y2++)
-						{
-							for(x2=-bw;x2<=bw;x2++)
-							{
-								//get the floating point distance away from the origin pixel in relative coords
-								float tmp_x=(float)x2/bw;
-								float tmp_y=(float)y2/bh;
-								tmp_x*=tmp_x;
-								tmp_y*=tmp_y;
-
-								//ignore if it's outside of the disc
-								if( tmp_x+tmp_y>1.0)
-									continue;
-
-								//cap the pixel indices to inside the surface
-								int u= x+x2,
-									v= y+y2;
-
-								if( u < 0 )					u = 0;
-								if( u >= w ) u = w-1;
-
-								if( v < 0 ) 				v = 0;
-								if( v >= h ) v = h-1;
-
-								//accumulate the color, and # of pixels added in
-								color += tmp_surface[v][u];
-								total++;
-							}
-						}
-
-						//blend the color with the original color
-						//if(get_amount()==1.0 && get_blend_method()==Color::BLEND_STRAIGHT)
-							worksurface[y][x]=color/total;
-						//else
-						//	worksurface[y][x]=Color::blend(color/total,tmp_surface[y][x],get_amount(),get_blend_method());
-					}
-					if(!blurcall.amount_complete(y,h))
-					{
-						//if(cb)cb->error(strprintf(__FILE__"%d: Accelerated Renderer Failure",__LINE__));
-						return false;
-					}
+					//if(cb)cb->error(strprintf(__FILE__"%d: Accelerated Renderer Failure",__LINE__));
+					return false;
 				}
 				break;
 			}
@@ -602,6 +760,9 @@ bool Blur::operator()(const Surface &surface,
 	case Blur::FASTGAUSSIAN:	// F A S T G A U S S I A N ----------------------------------------------
 		{
 			//fast gaussian is treated as a 3x3 type of thing, except expanded to work with the length
+			// The box blurs keep running sums, so their cost doesn't grow with
+			// the length; large blurs only get slow in the GAUSSIAN branch,
+			// which is why that one switches to GaussianBlur_IIR().
 
 			/*	1	2	1
 				2	4	2
@@ -728,6 +889,15 @@ bool Blur::operator()(const Surface &surface,
 			int bh = (int)(abs(ph)*size[1]*GAUSSIAN_ADJUSTMENT+0.5);
 			int max=bw+bh;
 
+			// Every pass below adds a variance of a quarter pixel per
+			// unit of bw and bh, so large blurs are done recursively
+			if(std::max(bw,bh) >= GAUSSIAN_IIR_MIN_SIZE)
+			{
+				if(!GaussianBlur_IIR(*gauss_surface,sqrt((float)bw)/2,sqrt((float)bh)/2,blurcall))
+					return false;
+				bw=bh=0;
+			}
+
 			Color *SC0=new class Color[w+2];
 			Color *SC1=new class Color[w+2];
 			Color *SC2=new class Color[w+2];
@@ -877,58 +1047,10 @@ bool Blur::operator()(const etl::surface<float> &surface,
 
 			if(size[0] && size[1] && w*h>2)
 			{
-				int x2,y2;
-				etl::surface<float> tmp_surface(worksurface);
-
-				for(y=0;y<h;y++)
+				if(!DiscBlur(worksurface,bw,bh,blurcall))
 				{
-					for(x=0;x<w;x++)
-					{
-						//accumulate all the pixels in an ellipse of w,h about the current pixel
-						float a = 0;
-						int total=0;
-
-						for(y2=-bh;y2<=bh;y2++)
-						{
-							for(x2=-bw;x2<=bw;x2++)
-							{
-								//get the floating point distance away from the origin pixel in relative coords
-								float tmp_x=(float)x2/bw;
-								float tmp_y=(float)y2/bh;
-								tmp_x*=tmp_x;
-								tmp_y*=tmp_y;
-
-								//ignore if it's outside of the disc
-								if( tmp_x+tmp_y>1.0)
-									continue;
-
-								//cap the pixel indices to inside the surface
-								int u= x+x2,
-									v= y+y2;
-
-								if( u < 0 )					u = 0;
-								if( u >= w ) u = w-1;
-
-								if( v < 0 ) 				v = 0;
-								if( v >= h ) v = h-1;
-
-								//accumulate the color, and # of pixels added in
-								a += tmp_surface[v][u];
-								total++;
-							}
-						}
-
-						//blend the color with the original color
-						//if(get_amount()==1.0 && get_blend_method()==Color::BLEND_STRAIGHT)
-							worksurface[y][x]=a/total;
-						//else
-						//	worksurface[y][x]=Color::blend(color/total,tmp_surface[y][x],get_amount(),get_blend_method());
-					}
-					if(!blurcall.amount_complete(y,h))
-					{
-						//if(cb)cb->error(strprintf(__FILE__"%d: Accelerated Renderer Failure",__LINE__));
-						return false;
-					}
+					//if(cb)cb->error(strprintf(__FILE__"%d: Accelerated Renderer Failure",__LINE__));
+					return false;
 				}
 				break;
 			}
@@ -978,6 +1100,9 @@ bool Blur::operator()(const etl::surface<float> &surface,
 	case Blur::FASTGAUSSIAN:	// F A S T G A U S S I A N ----------------------------------------------
 		{
 			//fast gaussian is treated as a 3x3 type of thing, except expanded to work with the length
+			// The box blurs keep running sums, so their cost doesn't grow with
+			// the length; large blurs only get slow in the GAUSSIAN branch,
+			// which is why that one switches to GaussianBlur_IIR().
 
 			/*	1	2	1
 				2	4	2
@@ -1102,6 +1227,15 @@ bool Blur::operator()(const etl::surface<float> &surface,
 			int bh = (int)(abs(ph)*size[1]*GAUSSIAN_ADJUSTMENT+0.5);
 			int max=bw+bh;
 
+			// Every pass below adds a variance of a quarter pixel per
+			// unit of bw and bh, so large blurs are done recursively
+			if(std::max(bw,bh) >= GAUSSIAN_IIR_MIN_SIZE)
+			{
+				if(!GaussianBlur_IIR(*gauss_surface,sqrt((float)bw)/2,sqrt((float)bh)/2,blurcall))
+					return false;
+				bw=bh=0;
+			}
+
 			float *SC0=new float[w+2];
 			float *SC1=new float[w+2];
 			float *SC2=new float[w+2];
@@ -38,6 +38,7 @@
 #include "context.h"
 #include "layer_pastecanvas.h"
 #include "loadcanvas.h"
+#include "valuenode_const.h"
 #include <sigc++/bind.h>
 
 #endif
@@ -191,6 +192,7 @@ Canvas::back()const
 Context
 Canvas::get_context()const
 {
+	load_deferred();
 	return begin();
 }
 
@@ -199,6 +201,7 @@ Canvas::value_node_list()const
 {
 	if(is_inline() && parent_)
 		return parent_->value_node_list();
+	load_deferred();
 	return value_node_list_;
 }
 
@@ -207,6 +210,7 @@ Canvas::keyframe_list()
 {
 	if(is_inline() && parent_)
 		return parent_->keyframe_list();
+	load_deferred();
 	return keyframe_list_;
 }
 
@@ -215,6 +219,7 @@ Canvas::keyframe_list()const
 {
 	if(is_inline() && parent_)
 		return parent_->keyframe_list();
+	load_deferred();
 	return keyframe_list_;
 }
 
@@ -279,6 +284,11 @@ Canvas::set_description(const String &x)
 void
 Canvas::set_time(Time t)const
 {
+	// A canvas with nothing animated in it renders the same at any time,
+	// so there is no need to walk its layers again
+	if(!is_dirty_ && !get_time().is_equal(t) && !is_time_dependent())
+		const_cast<Canvas&>(*this).cur_time_=t;
+
 	if(is_dirty_ || !get_time().is_equal(t))
 	{
 #if 0
@@ -391,7 +401,10 @@ Canvas::find_value_node(const String &id)const
 	// If we do not have any resolution, then we assume that the
 	// request is for this immediate canvas
 	if(id.find_first_of(':')==string::npos && id.find_first_of('#')==string::npos)
+	{
+		load_deferred();
 		return value_node_list_.find(id);
+	}
 
 	String canvas_id(id,0,id.rfind(':'));
 	String value_node_id(id,id.rfind(':')+1);
@@ -443,26 +456,18 @@ Canvas::add_value_node(ValueNode::Handle x, const String &id)
 	if(id.find_first_of(':',0)!=string::npos)
 		throw Exception::BadLinkName("Bad character");
 
-	try
-	{
-		if(PlaceholderValueNode::Handle::cast_dynamic(value_node_list_.find(id)))
-			throw Exception::IDNotFound("add_value_node()");
-
+	ValueNode::Handle other(value_node_list_.lookup(id));
+	if(other && !PlaceholderValueNode::Handle::cast_dynamic(other))
 		throw Exception::IDAlreadyExists(id);
-	}
-	catch(Exception::IDNotFound)
-	{
-		x->set_id(id);
 
-		x->set_parent_canvas(this);
+	x->set_id(id);
 
-		if(!value_node_list_.add(x))
-		{
-			synfig::error("Unable to add ValueNode");
-			throw std::runtime_error("Unable to add ValueNode");
-		}
+	x->set_parent_canvas(this);
 
-		return;
+	if(!value_node_list_.add(x))
+	{
+		synfig::error("Unable to add ValueNode");
+		throw std::runtime_error("Unable to add ValueNode");
 	}
 }
 
@@ -564,9 +569,12 @@ Canvas::surefind_canvas(const String &id, String &warnings)
 
 		// Search for the image in the image list,
 		// and return it if it is found
-		for(iter=children().begin();iter!=children().end();iter++)
+		for(iter=children_.begin();iter!=children_.end();iter++)
 			if(id==(*iter)->get_id())
+			{
+				(*iter)->load_deferred();
 				return *iter;
+			}
 
 		// Create a new canvas and return it
 		//synfig::warning("Implicitly creating canvas named "+id);
@@ -650,9 +658,12 @@ Canvas::find_canvas(const String &id, String &warnings)const
 
 		// Search for the image in the image list,
 		// and return it if it is found
-		for(iter=children().begin();iter!=children().end();iter++)
+		for(iter=children_.begin();iter!=children_.end();iter++)
 			if(id==(*iter)->get_id())
+			{
+				(*iter)->load_deferred();
 				return *iter;
+			}
 
 		throw Exception::IDNotFound("Child Canvas in Parent Canvas: (child)"+id);
 	}
@@ -673,6 +684,26 @@ Canvas::find_canvas(const String &id, String &warnings)const
 	return child_canvas->find_canvas(string(id,id.find_first_of(':')+1), warnings);
 }
 
+void
+Canvas::load_deferred()const
+{
+	if(deferred_loader_.empty())
+		return;
+
+	// clear the loader before calling it, since the loader
+	// will look this canvas up again to fill it in
+	sigc::slot<void> loader(deferred_loader_);
+	deferred_loader_=sigc::slot<void>();
+	loader();
+}
+
+void
+Canvas::load_deferred_children()const
+{
+	for(Children::const_iterator iter=children_.begin();iter!=children_.end();++iter)
+		(*iter)->load_deferred();
+}
+
 Canvas::Handle
 Canvas::create()
 {
@@ -834,6 +865,64 @@ Canvas::clone(const GUID& deriv_guid)const
 	return canvas;
 }
 
+//! Returns the inline canvas held by \a value, if any
+static Canvas::Handle
+inline_canvas(const ValueBase &value)
+{
+	if(value.get_type()!=ValueBase::TYPE_CANVAS)
+		return 0;
+	Canvas::Handle canvas(value.get(Canvas::Handle()));
+	return canvas && canvas->is_inline() ? canvas : Canvas::Handle();
+}
+
+Canvas::Handle
+Canvas::render_copy()const
+{
+	Handle canvas(new Canvas(id_));
+
+	canvas->is_inline_=is_inline_;
+	canvas->parent_=parent_;
+	canvas->version_=version_;
+	canvas->name_=name_;
+	canvas->description_=description_;
+	canvas->author_=author_;
+	canvas->email_=email_;
+	canvas->file_name_=file_name_;
+	canvas->meta_data_=meta_data_;
+	canvas->keyframe_list_=keyframe_list_;
+	canvas->rend_desc()=rend_desc();
+	canvas->value_node_list_=value_node_list_;
+	canvas->children_=children_;
+	canvas->externals_=externals_;
+
+	for(const_iterator iter=begin();iter!=end();++iter)
+	{
+		// share the value nodes, but not the inline canvases, since
+		// a layer takes those over when it is added to a canvas
+		Layer::Handle layer((*iter)->simple_clone());
+		if(!layer)
+		{
+			synfig::error("Unable to copy layer");
+			continue;
+		}
+
+		const Layer::ParamList param_list((*iter)->get_param_list());
+		for(Layer::ParamList::const_iterator param=param_list.begin();param!=param_list.end();++param)
+			if(!(*iter)->dynamic_param_list().count(param->first))
+				if(Canvas::Handle sub_canvas=inline_canvas(param->second))
+					layer->set_param(param->first,sub_canvas->render_copy());
+
+		const Layer::DynamicParamList &dynamic_param_list((*iter)->dynamic_param_list());
+		for(Layer::DynamicParamList::const_iterator param=dynamic_param_list.begin();param!=dynamic_param_list.end();++param)
+			if(Canvas::Handle sub_canvas=inline_canvas((*param->second)(0)))
+				layer->connect_dynamic_param(param->first,ValueNode_Const::create(ValueBase(sub_canvas->render_copy())));
+
+		canvas->push_back(layer);
+	}
+
+	return canvas;
+}
+
 void
 Canvas::set_inline(LooseHandle parent)
 {
@@ -878,8 +967,8 @@ Canvas::new_child_canvas()
 //		runtime_error("You cannot create a child Canvas in an inline Canvas");
 
 	// Create a new canvas
-	children().push_back(create());
-	Canvas::Handle canvas(children().back());
+	children_.push_back(create());
+	Canvas::Handle canvas(children_.back());
 
 	canvas->parent_=this;
 
@@ -896,8 +985,8 @@ Canvas::new_child_canvas(const String &id)
 //		runtime_error("You cannot create a child Canvas in an inline Canvas");
 
 	// Create a new canvas
-	children().push_back(create());
-	Canvas::Handle canvas(children().back());
+	children_.push_back(create());
+	Canvas::Handle canvas(children_.back());
 
 	canvas->set_id(id);
 	canvas->parent_=this;
@@ -929,7 +1018,7 @@ Canvas::add_child_canvas(Canvas::Handle child_canvas, const synfig::String& id)
 		if(child_canvas->is_inline())
 			child_canvas->is_inline_=false;
 		child_canvas->id_=id;
-		children().push_back(child_canvas);
+		children_.push_back(child_canvas);
 		child_canvas->parent_=this;
 	}
 
@@ -945,10 +1034,10 @@ Canvas::remove_child_canvas(Canvas::Handle child_canvas)
 	if(child_canvas->parent_!=this)
 		throw runtime_error("Given child does not belong to me");
 
-	if(find(children().begin(),children().end(),child_canvas)==children().end())
+	if(find(children_.begin(),children_.end(),child_canvas)==children_.end())
 		throw Exception::IDNotFound(child_canvas->get_id());
 
-	children().remove(child_canvas);
+	children_.remove(child_canvas);
 
 	child_canvas->parent_=0;
 }
@@ -1275,6 +1364,19 @@ Canvas::get_times_vfunc(Node::time_set &set) const
 	}
 }
 
+bool
+Canvas::is_time_dependent_vfunc() const
+{
+	const_iterator	i = begin(),
+				iend = end();
+
+	for(; i != iend; ++i)
+		if((*i)->is_time_dependent())
+			return true;
+
+	return false;
+}
+
 std::set<etl::handle<Layer> >
 Canvas::get_layers_in_group(const String&group)
 {
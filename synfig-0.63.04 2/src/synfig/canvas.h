@@ -224,6 +224,10 @@ private:
 	//! Layer Signal Connection database. Seems to be unused.
 	std::map<etl::loose_handle<Layer>,std::vector<sigc::connection> > connections_;
 
+	//! Fills in the contents of the canvas, if loading them was put off
+	/*!	\see set_deferred_loader(), load_deferred() */
+	mutable sigc::slot<void> deferred_loader_;
+
 	/*
  -- ** -- S I G N A L S -------------------------------------------------------
 	*/
@@ -421,11 +425,31 @@ public:
 	LooseHandle get_root()const;
 
 	//! Returns a list of all child canvases in this canvas
+	/*!	Child canvases whose contents were deferred are left as they are,
+	**	with only their ids set. \see load_deferred_children() */
 	std::list<Handle> &children() { return children_; }
 
 	//! Returns a list of all child canvases in this canvas
+	/*!	\see children() */
 	const std::list<Handle> &children()const { return children_; }
 
+	//! Puts off loading the contents of the canvas until they are first needed
+	/*!	\a loader is called, once, when the canvas is looked up by
+	**	find_canvas() or surefind_canvas(), or when its layers, value nodes
+	**	or keyframes are first asked for through get_context(),
+	**	value_node_list(), find_value_node() or keyframe_list().
+	**	Used when loading files with a section per canvas. */
+	void set_deferred_loader(const sigc::slot<void> &loader) { deferred_loader_=loader; }
+
+	//! Returns \c true if the contents of the canvas have yet to be loaded
+	bool is_deferred()const { return !deferred_loader_.empty(); }
+
+	//! Loads the contents of the canvas now, if they were put off
+	void load_deferred()const;
+
+	//! Loads the contents of every child canvas that were put off
+	void load_deferred_children()const;
+
 	//! Gets the color at the specified point
 	//Color get_color(const Point &pos)const;
 
@@ -585,6 +609,16 @@ public:
 	static Handle create_inline(Handle parent);
 	//! Clones (copies) the Canvas if it is inline.
 	Handle clone(const GUID& deriv_guid=GUID())const;
+	//! Returns a copy of the Canvas to be rendered on its own
+	/*!	The copy has its own RendDesc and its own layers, which can be
+	**	changed without affecting this canvas or any other copy of it.
+	**	Everything rendering only reads is shared rather than copied:
+	**	the value nodes the layers are linked to, the exported values and
+	**	canvases and the external canvases. Inline canvases are copied the
+	**	same way. This makes a copy far cheaper than parsing the file again
+	**	or clone(). Ids relative to the copy can't be worked out, so the
+	**	copy can be rendered but not saved. */
+	Handle render_copy()const;
 	//! Stores the external canvas by its file name and the Canvas handle
 	void register_external_canvas(String file, Handle canvas);
 
@@ -613,6 +647,9 @@ protected:
 	//! stores it in the passed Time Set \set
 	//! \see Node::get_times()
 	virtual void get_times_vfunc(Node::time_set &set) const;
+	//! Returns \c true if any of the Layers of the Canvas is time dependent
+	//! \see Node::is_time_dependent()
+	virtual bool is_time_dependent_vfunc() const;
 }; // END of class Canvas
 
 	//! Optimize layers based on its calculated Z depth to perform a quick
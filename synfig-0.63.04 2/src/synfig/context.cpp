@@ -324,11 +324,15 @@ Context::set_time(Time time)const
 		// it either isn't already set to the given time
 		//        or it's a stroboscope layer,
 		//        or it's a time loop layer,
+		// and it has either never been set since it last changed
+		//        or it has something animated in it,
 		// then break out of the loop and set its time
 		if((*context)->active() &&
 		   (!(*context)->dirty_time_.is_equal(time) ||
 			(*context)->get_name() == "stroboscope" ||
-			(*context)->get_name() == "timeloop"))
+			(*context)->get_name() == "timeloop") &&
+		   ((*context)->dirty_time_ == Time::end() ||
+			(*context)->is_time_dependent()))
 			break;
 
 		// Otherwise, we want to keep searching
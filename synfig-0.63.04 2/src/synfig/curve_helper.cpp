@@ -44,14 +44,89 @@ using namespace synfig;
 
 /* === M A C R O S ========================================================= */
 #define ERR	1e-11
+#define CURVE_INDEX_LEAF_SIZE	4
 const Real ERROR = 1e-11;
 
 /* === G L O B A L S ======================================================= */
 
 /* === P R O C E D U R E S ================================================= */
 
+namespace {
+
+//! Orders segments by the centre of their bounding box along one axis
+struct CompareCenter
+{
+	const vector<Rect> &bounds;
+	int axis;
+
+	CompareCenter(const vector<Rect> &bounds, int axis):bounds(bounds),axis(axis) { }
+
+	Real center(int i)const
+		{ return axis ? bounds[i].miny+bounds[i].maxy : bounds[i].minx+bounds[i].maxx; }
+
+	bool operator()(int a, int b)const { return center(a)<center(b); }
+};
+
+};
+
 /* === M E T H O D S ======================================================= */
 
+void
+CurveIndex::build(const vector<Rect> &bounds)
+{
+	clear();
+	if(bounds.empty())
+		return;
+
+	order.resize(bounds.size());
+	for(int i=0;i<(int)order.size();i++)
+		order[i]=i;
+
+	// a binary tree never has more than 2n-1 nodes, so this also
+	// guarantees that nodes are never moved while the tree is built
+	nodes.reserve(bounds.size()*2);
+	nodes.push_back(Node());
+	build(bounds,0,0,order.size());
+}
+
+void
+CurveIndex::build(const vector<Rect> &bounds, int index, int first, int count)
+{
+	const Rect &b(bounds[order[first]]);
+	Rect box(b);
+	Rect centers((b.minx+b.maxx)*0.5,(b.miny+b.maxy)*0.5);
+
+	for(int i=first+1;i<first+count;i++)
+	{
+		const Rect &b(bounds[order[i]]);
+		box.expand(b.minx,b.miny);
+		box.expand(b.maxx,b.maxy);
+		centers.expand((b.minx+b.maxx)*0.5,(b.miny+b.maxy)*0.5);
+	}
+
+	Node &node(nodes[index]);
+	node.bounds=box;
+	node.first=first;
+	node.count=count;
+	node.child=-1;
+
+	if(count<=CURVE_INDEX_LEAF_SIZE)
+		return;
+
+	// split at the median of the segment centres along the longer axis
+	const int axis(centers.maxx-centers.minx>=centers.maxy-centers.miny ? 0 : 1);
+	const int half(count/2);
+	nth_element(order.begin()+first,order.begin()+first+half,order.begin()+first+count,CompareCenter(bounds,axis));
+
+	const int child(nodes.size());
+	node.child=child;
+	nodes.push_back(Node());
+	nodes.push_back(Node());
+
+	build(bounds,child,first,half);
+	build(bounds,child+1,first+half,count-half);
+}
+
 /* === E N T R Y P O I N T ================================================= */
 
 Real synfig::find_closest(const etl::bezier<Point> &curve, const Point &point,
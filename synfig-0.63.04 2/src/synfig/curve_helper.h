@@ -120,6 +120,90 @@ inline void Bound(etl::rect<T> &r, const etl::bezier<Point> &b)
 	r.expand(b[3][0],b[3][1]);
 }
 
+//! Squared distance from a point to the nearest point of a rectangle
+inline Real rect_point_distsq(const Rect &r, const Point &p)
+{
+	const Real dx(p[0]<r.minx ? r.minx-p[0] : (p[0]>r.maxx ? p[0]-r.maxx : 0));
+	const Real dy(p[1]<r.miny ? r.miny-p[1] : (p[1]>r.maxy ? p[1]-r.maxy : 0));
+	return dx*dx+dy*dy;
+}
+
+//! Bounding volume hierarchy over the segments of a curve
+/*!	The tree is built from the bounding box of every segment (see Bound()),
+**	and is then used to visit only those segments that could contain the
+**	point closest to a query point. Since a bezier segment lies within the
+**	hull of its control points, the distance to a segment's box is a lower
+**	bound for the distance to any point of the segment, and whole subtrees
+**	can be skipped once something nearer has been found. */
+class CurveIndex
+{
+	struct Node
+	{
+		Rect bounds;
+		int first, count;	//!< range of \a order covered by this node
+		int child;			//!< index of the first child, or -1 for a leaf
+	};
+
+	std::vector<Node> nodes;
+	std::vector<int> order;
+
+	void build(const std::vector<Rect> &bounds, int index, int first, int count);
+
+public:
+	//! Builds the tree for segments with the given bounding boxes
+	void build(const std::vector<Rect> &bounds);
+
+	void clear() { nodes.clear(); order.clear(); }
+
+	bool empty()const { return nodes.empty(); }
+
+	//! Visits the segments that may lie nearest to \a p
+	/*!	\a func is called as \c func(i) for the index \a i of a candidate
+	**	segment, and must return the smallest squared distance it has found
+	**	so far (of any segment). Segments are visited nearest box first, and
+	**	every segment whose box is farther than that distance is skipped, so
+	**	\a func must break ties between equally near segments on its own if
+	**	it cares about them. */
+	template < typename F >
+	void find_closest(const Point &p, F &func, Real best=1e50)const
+	{
+		if(nodes.empty())
+			return;
+
+		// the distance returned by \a func is usually held in a float,
+		// so allow for a little rounding before pruning against it
+		const Real slack(1.0+1e-5);
+
+		// the tree is split at the median, so it is never deeper than
+		// log2 of the segment count and the stack stays small
+		int stack[64];
+		int depth(0);
+		stack[depth++]=0;
+
+		while(depth)
+		{
+			const Node &node(nodes[stack[--depth]]);
+
+			if(rect_point_distsq(node.bounds,p)>best*slack)
+				continue;
+
+			if(node.child<0)
+			{
+				for(int i=node.first;i<node.first+node.count;i++)
+					best=func(order[i]);
+				continue;
+			}
+
+			// push the farther child first so that the nearer one is searched first
+			const int a(node.child), b(node.child+1);
+			if(rect_point_distsq(nodes[a].bounds,p)<=rect_point_distsq(nodes[b].bounds,p))
+				stack[depth++]=b, stack[depth++]=a;
+			else
+				stack[depth++]=a, stack[depth++]=b;
+		}
+	}
+};
+
 /*template < typename T >
 inline bool intersect(const etl::rect<T> &r1, const etl::rect<T> &r2)
 {
@@ -47,6 +47,15 @@ using namespace synfig;
 
 /* === M A C R O S ========================================================= */
 
+//! Number of samples per supersample width in each level of a GradientTable
+#define GRADIENT_TABLE_DENSITY	16
+
+//! Upper limit on the number of samples in each level of a GradientTable
+#define GRADIENT_TABLE_MAX_SIZE	(1<<16)
+
+//! Ratio between the supersample widths of successive levels of a GradientTable
+#define GRADIENT_TABLE_LEVEL_RATIO	1.189207115	// 2^(1/4)
+
 /* === G L O B A L S ======================================================= */
 
 /* === P R O C E D U R E S ================================================= */
@@ -594,3 +603,93 @@ synfig::Gradient::find(const UniqueID &id)const
 
 	throw Exception::NotFound("synfig::Gradient::find()const: Unable to find UniqueID in gradient");
 }
+
+void
+synfig::GradientTable::set(const Gradient &x, Real supersample, int max_samples)
+{
+	gradient=x;
+	levels.clear();
+
+	min_supersample=std::min(supersample<0 ? -supersample : supersample,2.0);
+	if(gradient.size()<2 || !(min_supersample>0))
+		return;
+
+	const Real front(gradient.begin()->pos);
+	const Real back(gradient.rbegin()->pos);
+
+	// Gradient::operator() never filters wider than 2
+	std::vector<Real> widths;
+	std::vector<int> sizes;
+	int total(0);
+	for(supersample=min_supersample;;supersample=std::min(supersample*GRADIENT_TABLE_LEVEL_RATIO,2.0))
+	{
+		// outside of this range the gradient gives the color of its end points
+		const Real length(back-front+supersample);
+		const int size((int)std::min(ceil(length*GRADIENT_TABLE_DENSITY/supersample)+1,(Real)GRADIENT_TABLE_MAX_SIZE));
+
+		widths.push_back(supersample);
+		sizes.push_back(std::max(2,size));
+		total+=sizes.back();
+
+		// a table which costs more than it saves isn't worth building
+		if(total>max_samples)
+			return;
+
+		if(supersample>=2.0)
+			break;
+	}
+
+	levels.resize(widths.size());
+	for(size_t i=0;i<levels.size();i++)
+	{
+		Level &level(levels[i]);
+		const Real length(back-front+widths[i]);
+		const Real step(length/(sizes[i]-1));
+
+		level.supersample=widths[i];
+		level.begin=front-widths[i]*0.5;
+		level.inv_step=1.0/step;
+		level.colors.resize(sizes[i]);
+		for(int j=0;j<sizes[i];j++)
+			level.colors[j]=gradient(level.begin+j*step,widths[i]).premult_alpha();
+	}
+}
+
+Color
+synfig::GradientTable::sample(const Level &level, const Real &x)
+{
+	const Real u((x-level.begin)*level.inv_step);
+	if(!(u>0))
+		return level.colors.front();
+	if(u>=level.colors.size()-1)
+		return level.colors.back();
+
+	const int i((int)u);
+	const float amount(u-i);
+	return level.colors[i]*(1.0f-amount)+level.colors[i+1]*amount;
+}
+
+Color
+synfig::GradientTable::operator()(const Real &x,float supersample)const
+{
+	if(supersample<0)
+		supersample=-supersample;
+	if(supersample>2.0)
+		supersample=2.0f;
+
+	if(levels.empty() || supersample<min_supersample*0.5 || isnan(x))
+		return gradient(x,supersample);
+
+	// find the levels just narrower and wider than the width asked for
+	int i(0);
+	if(supersample>min_supersample)
+		i=std::min((int)(log(supersample/min_supersample)*(1.0/log(GRADIENT_TABLE_LEVEL_RATIO))),(int)levels.size()-1);
+	if(i+1<(int)levels.size() && supersample>=levels[i+1].supersample)
+		i++;
+
+	if(i+1==(int)levels.size() || supersample<=levels[i].supersample)
+		return sample(levels[i],x).demult_alpha();
+
+	const float amount((supersample-levels[i].supersample)/(levels[i+1].supersample-levels[i].supersample));
+	return (sample(levels[i],x)*(1.0f-amount)+sample(levels[i+1],x)*amount).demult_alpha();
+}
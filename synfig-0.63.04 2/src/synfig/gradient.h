@@ -129,6 +129,48 @@ public:
 	const_iterator find(const UniqueID &id)const;
 }; // END of class Gradient
 
+/*! \class GradientTable
+**	\brief Lookup table for sampling a Gradient many times
+**
+**	Holds the gradient sampled at a series of supersample widths, each
+**	level a little wider than the previous, from the narrowest width a
+**	render needs up to the widest one the gradient allows. Looking up a
+**	color interpolates between the samples nearest in position and width,
+**	instead of walking the list of CPoints as Gradient::operator() does.
+*/
+class GradientTable
+{
+	struct Level
+	{
+		Real supersample;
+		Real begin;
+		Real inv_step;
+		std::vector<Color> colors;	//!< premultiplied
+	};
+
+	Gradient gradient;
+	Real min_supersample;
+	std::vector<Level> levels;
+
+	static Color sample(const Level &level, const Real &x);
+
+public:
+	GradientTable():min_supersample(0) { }
+
+	//! Tabulates \a gradient for supersample widths of \a min_supersample and above
+	/*!	If that would take more than \a max_samples samples, the table is
+	**	left empty and every lookup is passed on to the gradient. */
+	GradientTable(const Gradient &gradient, const Real &min_supersample, int max_samples)
+		{ set(gradient,min_supersample,max_samples); }
+
+	void set(const Gradient &gradient, Real min_supersample, int max_samples);
+
+	//! Equivalent to Gradient::operator(), but looked up in the table
+	/*!	Widths much narrower than the table was built for are passed on to
+	**	the gradient itself. */
+	Color operator()(const Real &x, float supersample=0)const;
+}; // END of class GradientTable
+
 }; // END of namespace synfig
 
 /* === E N D =============================================================== */
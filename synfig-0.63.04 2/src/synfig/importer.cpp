@@ -33,6 +33,7 @@
 #include "canvas.h"
 #include "importer.h"
 #include "surface.h"
+#include "module.h"
 #include <algorithm>
 #include "string.h"
 #include <map>
@@ -102,20 +103,18 @@ Importer::open(const String &filename)
 		return 0;
 	}
 
-	String ext(filename_extension(filename));
-	if (ext.size()) ext = ext.substr(1); // skip initial '.'
-	std::transform(ext.begin(),ext.end(),ext.begin(),&::tolower);
-
-
-	if(!Importer::book().count(ext))
+	Factory factory(get_factory(filename));
+	if(!factory && request_module(filename))
+		factory=get_factory(filename);
+	if(!factory)
 	{
-		synfig::error(_("Importer::open(): Unknown file type -- ")+ext);
+		synfig::error(_("Importer::open(): Unknown file type -- ")+filename_extension(filename).substr(1));
 		return 0;
 	}
 
 	try {
 		Importer::Handle importer;
-		importer=Importer::book()[ext](filename.c_str());
+		importer=factory(filename.c_str());
 		(*__open_importers)[filename]=importer;
 		return importer;
 	}
@@ -126,6 +125,41 @@ Importer::open(const String &filename)
 	return 0;
 }
 
+//! Returns the extension of \a filename the way the book of importers is indexed
+static String
+importer_extension(const String &filename)
+{
+	String ext(filename_extension(filename));
+	if (ext.size()) ext = ext.substr(1); // skip initial '.'
+	std::transform(ext.begin(),ext.end(),ext.begin(),&::tolower);
+	return ext;
+}
+
+Importer::Factory
+Importer::get_factory(const String &filename)
+{
+	Book::const_iterator iter(book().find(importer_extension(filename)));
+	return iter==book().end() ? 0 : iter->second;
+}
+
+bool
+Importer::request_module(const String &filename)
+{
+	return Module::request(Module::ENTRY_IMPORTER,importer_extension(filename));
+}
+
+void
+Importer::set_open(const String &filename, Handle importer)
+{
+	(*__open_importers)[filename]=importer;
+}
+
+void
+Importer::forget_open(const String &filename)
+{
+	__open_importers->erase(filename);
+}
+
 Importer::Importer():
 	gamma_(2.2)
 {
@@ -85,6 +85,10 @@ class Importer : public etl::shared_object
 public:
 	//! Type that represents a pointer to a Importer's constructor.
 	//! As a pointer to the constructor, it represents a "factory" of importers.
+	/*!	Files are opened ahead of time on several threads at once (see
+	**	open_canvas()), so constructors must only touch state of their own.
+	**	All of the importers that come with synfig do; an importer that
+	**	can't has to lock around its constructor itself. */
 	typedef Importer* (*Factory)(const char *filename);
 	typedef std::map<String,Factory> Book;
 	static Book* book_;
@@ -142,6 +146,22 @@ public:
 
 	//! Attempts to open \a filename, and returns a handle to the associated Importer
 	static Handle open(const String &filename);
+
+	//! Returns the factory of the importer for the extension of \a filename, or 0 if there is none
+	/*!	Only reads the book, so it may be called from any thread once
+	**	the modules are loaded. */
+	static Factory get_factory(const String &filename);
+
+	//! Loads the module with the importer for the extension of \a filename, if it hasn't been loaded yet
+	/*!	See Module::request(). Since get_factory() never loads a module,
+	**	this has to be called first, from the main thread. */
+	static bool request_module(const String &filename);
+
+	//! Makes open() return \a importer for \a filename, for importers created ahead of time
+	static void set_open(const String &filename, Handle importer);
+
+	//! Makes open() create a new importer for \a filename, for files which have changed since they were opened
+	static void forget_open(const String &filename);
 };
 
 }; // END of namespace synfig
@@ -39,6 +39,7 @@
 #include "layer_mime.h"
 #include "context.h"
 #include "paramdesc.h"
+#include "module.h"
 
 #include "layer_solidcolor.h"
 #include "layer_polygon.h"
@@ -148,6 +149,9 @@ Layer::Layer():
 Layer::LooseHandle
 synfig::Layer::create(const String &name)
 {
+	if(!book().count(name))
+		Module::request(Module::ENTRY_LAYER,name);
+
 	if(!book().count(name))
 	{
 		return Layer::LooseHandle(new Layer_Mime(name));
@@ -604,6 +608,19 @@ Layer::get_times_vfunc(Node::time_set &set) const
 	}
 }
 
+bool
+Layer::is_time_dependent_vfunc() const
+{
+	DynamicParamList::const_iterator 	i = dynamic_param_list_.begin(),
+										end = dynamic_param_list_.end();
+
+	for(; i != end; ++i)
+		if(i->second->is_time_dependent())
+			return true;
+
+	return false;
+}
+
 
 void
 Layer::add_to_group(const String&x)
@@ -552,6 +552,12 @@ protected:
 	//! Called to figure out the animation time information
 	virtual void get_times_vfunc(Node::time_set &set) const;
 
+	//! Returns \c true if any dynamic parameter is time dependent
+	/*!	Context::set_time() skips the layers for which this is \c false
+	**	once their parameters have been set. Layers that do anything with
+	**	the time in set_time() besides passing it on must override it. */
+	virtual bool is_time_dependent_vfunc() const;
+
 	/*
  --	** -- S T A T I C  F U N C T I O N S --------------------------------------
 	*/
@@ -60,6 +60,10 @@ public:
 	virtual bool accelerated_render(Context context,Surface *surface,int quality, const RendDesc &renddesc, ProgressCallback *cb)const;
 	virtual Vocab get_param_vocab()const;
 	virtual bool reads_context()const { return true; }
+
+protected:
+	//! Evaluates the context for each index at the current time
+	virtual bool is_time_dependent_vfunc()const { return true; }
 }; // END of class Layer_Duplicate
 
 }; // END of namespace synfig
@@ -66,6 +66,10 @@ public:
 	virtual bool accelerated_render(Context context,Surface *surface,int quality, const RendDesc &renddesc, ProgressCallback *cb)const;
 	virtual Vocab get_param_vocab()const;
 	virtual bool reads_context()const { return true; }
+
+protected:
+	//! Samples the context around the current time
+	virtual bool is_time_dependent_vfunc()const { return true; }
 }; // END of class Layer_MotionBlur
 
 }; // END of namespace synfig
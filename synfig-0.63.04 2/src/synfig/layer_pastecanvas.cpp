@@ -572,6 +572,12 @@ void Layer_PasteCanvas::get_times_vfunc(Node::time_set &set) const
 	Layer::get_times_vfunc(set);
 }
 
+bool
+Layer_PasteCanvas::is_time_dependent_vfunc() const
+{
+	return (canvas && canvas->is_time_dependent()) || Layer::is_time_dependent_vfunc();
+}
+
 
 bool
 Layer_PasteCanvas::set_param_static(const String &param, const bool x)
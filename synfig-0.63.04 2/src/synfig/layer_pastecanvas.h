@@ -180,6 +180,9 @@ protected:
 	//! Layer time points. \todo clarify all this comments.
 	virtual void get_times_vfunc(Node::time_set &set) const;
 
+	//! The Paste Canvas is also time dependent when its canvas is
+	virtual bool is_time_dependent_vfunc() const;
+
 }; // END of class Layer_PasteCanvas
 
 }; // END of namespace synfig
@@ -41,12 +41,12 @@
 #include "valuenode.h"
 #include "float.h"
 #include "blur.h"
+#include "mutex.h"
 
 #include "curve_helper.h"
 
 #include <vector>
 
-#include <deque>
 
 #endif
 
@@ -99,7 +99,9 @@ struct Primitive
 
 //******** CURVE FUNCTIONS *****************
 const int	MAX_SUBDIVISION_SIZE = 64;
-const int	MIN_SUBDIVISION_DRAW_LEVELS = 4;
+
+//! Default distance (in pixels) a flattened curve may stray from the real one
+const Real	CURVE_TOLERANCE = 0.1;
 
 static void Subd_Conic_Stack(Point *arc)
 {
@@ -953,18 +955,113 @@ struct PenMark
 	}
 };
 
+typedef vector<PenMark> CoverArray;
+
+//! Number of cover buffers kept around for reuse by later PolySpans
+const size_t	COVER_POOL_SIZE = 8;
+//! Buffers which have grown beyond this many marks are not pooled
+const size_t	COVER_POOL_MAX_MARKS = 1<<20;
+
+//! Cover buffers released by finished PolySpans
+/*! Every rendered shape needs a few buffers of marks, so keeping them
+**	around saves growing them from scratch for every layer and tile.
+**	Shared by the render threads, hence the mutex. */
+static vector<CoverArray> cover_pool;
+static Mutex cover_pool_mutex;
+
+static void
+acquire_cover_array(CoverArray &x)
+{
+	Mutex::Lock lock(cover_pool_mutex);
+	if(!cover_pool.empty())
+	{
+		x.swap(cover_pool.back());
+		cover_pool.pop_back();
+	}
+}
+
+static void
+release_cover_array(CoverArray &x)
+{
+	x.clear();
+	if(x.capacity() > COVER_POOL_MAX_MARKS)
+		return;
+
+	Mutex::Lock lock(cover_pool_mutex);
+	if(cover_pool.size() < COVER_POOL_SIZE)
+	{
+		cover_pool.push_back(CoverArray());
+		cover_pool.back().swap(x);
+	}
+}
+
+//! Sorts the marks by (y,x)
+/*!	Uses two stable counting sort passes (first on x, then on y) through
+**	\a scratch, which is linear in the number of marks as long as they are
+**	not spread over a much larger area than their count.  Other ranges
+**	fall back to a comparison sort. */
+static void
+sort_covers(CoverArray::iterator begin, CoverArray::iterator end, CoverArray &scratch)
+{
+	const size_t n = end - begin;
+	if(n < 64)
+	{
+		sort(begin,end);
+		return;
+	}
+
+	int minx = begin->x, maxx = begin->x;
+	int miny = begin->y, maxy = begin->y;
+	for(CoverArray::iterator i = begin; i != end; ++i)
+	{
+		if(i->x < minx) minx = i->x; else if(i->x > maxx) maxx = i->x;
+		if(i->y < miny) miny = i->y; else if(i->y > maxy) maxy = i->y;
+	}
+
+	const size_t w = maxx - minx + 1;
+	const size_t h = maxy - miny + 1;
+	if(w + h > 8*n)
+	{
+		sort(begin,end);
+		return;
+	}
+
+	vector<size_t> count(max(w,h) + 1);
+	scratch.resize(n);
+
+	// scatter on x into the scratch buffer
+	for(CoverArray::iterator i = begin; i != end; ++i)
+		count[i->x - minx + 1]++;
+	for(size_t i = 1; i <= w; ++i)
+		count[i] += count[i-1];
+	for(CoverArray::iterator i = begin; i != end; ++i)
+		scratch[count[i->x - minx]++] = *i;
+
+	// then stably on y back into place
+	fill(count.begin(),count.begin() + h + 1,0);
+	for(CoverArray::iterator i = scratch.begin(); i != scratch.end(); ++i)
+		count[i->y - miny + 1]++;
+	for(size_t i = 1; i <= h; ++i)
+		count[i] += count[i-1];
+	for(CoverArray::iterator i = scratch.begin(); i != scratch.end(); ++i)
+		begin[count[i->y - miny]++] = *i;
+}
+
 typedef rect<int> ContextRect;
 
 class Layer_Shape::PolySpan
 {
 public:
-	typedef	deque<PenMark> 	cover_array;
+	typedef	CoverArray		cover_array;
 
 	Point			arc[3*MAX_SUBDIVISION_SIZE + 1];
 
 	cover_array		covers;
 	PenMark			current;
 
+	//scratch space for sorting the covers
+	cover_array		sort_buffer;
+
 	int				open_index;
 
 	//ending position of last primitive
@@ -981,6 +1078,9 @@ public:
 	//the window that will be drawn (used for clipping)
 	ContextRect		window;
 
+	//how far (in pixels) flattened curves may stray from the real ones
+	Real			tolerance;
+
 	//for assignment to flags value
 	enum PolySpanFlags
 	{
@@ -989,10 +1089,18 @@ public:
 	};
 
 	//default constructor - 0 everything
-	PolySpan() :current(0,0,0,0),flags(NotSorted)
+	PolySpan() :current(0,0,0,0),flags(NotSorted),tolerance(CURVE_TOLERANCE)
 	{
 		cur_x = cur_y = close_x = close_y = 0;
 		open_index = 0;
+		acquire_cover_array(covers);
+		acquire_cover_array(sort_buffer);
+	}
+
+	~PolySpan()
+	{
+		release_cover_array(covers);
+		release_cover_array(sort_buffer);
 	}
 
 	bool notclosed() const
@@ -1047,7 +1155,7 @@ public:
 	// Not recommended - destroys any separation of spans currently held
 	void merge_all()
 	{
-		sort(covers.begin(),covers.end());
+		sort_covers(covers.begin(),covers.end(),sort_buffer);
 		open_index = 0;
 	}
 
@@ -1060,7 +1168,7 @@ public:
 			addcurrent();
 			current.setcover(0,0);
 
-			sort(covers.begin() + open_index,covers.end());
+			sort_covers(covers.begin() + open_index,covers.end(),sort_buffer);
 			flags &= ~NotSorted;
 		}
 	}
@@ -1499,44 +1607,35 @@ static inline bool clip_cubic(const Point *const p, const ContextRect &r)
 			((p[0][1] < r.miny) && (p[1][1] < r.miny) && (p[2][1] < r.miny) && (p[3][1] < r.miny));
 }
 
-static inline Real max_edges_cubic(const Point *const p)
+// The flatness measures below are bounds on 16 times the squared distance
+// between a curve and its chord, so they can be compared to 16*tolerance^2
+// without a square root.  They only depend on the control points, so they
+// shrink by a factor of 16 with each subdivision.
+static inline Real flatness_cubic(const Point *const p)
 {
-	const Real x1 = p[1][0] - p[0][0];
-	const Real y1 = p[1][1] - p[0][1];
-
-	const Real x2 = p[2][0] - p[1][0];
-	const Real y2 = p[2][1] - p[1][1];
+	Real ux = 3*p[1][0] - 2*p[0][0] - p[3][0];
+	Real uy = 3*p[1][1] - 2*p[0][1] - p[3][1];
+	Real vx = 3*p[2][0] - 2*p[3][0] - p[0][0];
+	Real vy = 3*p[2][1] - 2*p[3][1] - p[0][1];
 
-	const Real x3 = p[3][0] - p[2][0];
-	const Real y3 = p[3][1] - p[2][1];
+	ux *= ux; uy *= uy;
+	vx *= vx; vy *= vy;
 
-	const Real d1 = x1*x1 + y1*y1;
-	const Real d2 = x2*x2 + y2*y2;
-	const Real d3 = x3*x3 + y3*y3;
-
-	return max(max(d1,d2),d3);
+	return max(ux,vx) + max(uy,vy);
 }
 
-static inline Real max_edges_conic(const Point *const p)
+static inline Real flatness_conic(const Point *const p)
 {
-	const Real x1 = p[1][0] - p[0][0];
-	const Real y1 = p[1][1] - p[0][1];
-
-	const Real x2 = p[2][0] - p[1][0];
-	const Real y2 = p[2][1] - p[1][1];
+	const Real x = 2*p[1][0] - p[0][0] - p[2][0];
+	const Real y = 2*p[1][1] - p[0][1] - p[2][1];
 
-	const Real d1 = x1*x1 + y1*y1;
-	const Real d2 = x2*x2 + y2*y2;
-
-	return max(d1,d2);
+	return x*x + y*y;
 }
 
 void Layer_Shape::PolySpan::conic_to(Real x1, Real y1, Real x, Real y)
 {
 	Point *current = arc;
-	int		level = 0;
 	int 	num = 0;
-	bool	onsecond = false;
 
 	arc[0] = Point(x,y);
 	arc[1] = Point(x1,y1);
@@ -1549,7 +1648,9 @@ void Layer_Shape::PolySpan::conic_to(Real x1, Real y1, Real x, Real y)
 		return;
 	}
 
-	//Ok so it's not super degenerate, subdivide and draw (run through minimum subdivision levels first)
+	const Real max_flatness = 16*tolerance*tolerance;
+
+	//Ok so it's not super degenerate, subdivide until it is flat enough and draw
 	while(current >= arc)
 	{
 		if(num >= MAX_SUBDIVISION_SIZE)
@@ -1565,40 +1666,23 @@ void Layer_Shape::PolySpan::conic_to(Real x1, Real y1, Real x, Real y)
 		{
 			line_to(current[0][0],current[0][1]); //backwards so front is destination
 			current -= 2;
-			if(onsecond) level--;
-			onsecond = true;
 			num--;
 			continue;
 		}else
-		//if we are not at the level minimum
-		if(level < MIN_SUBDIVISION_DRAW_LEVELS)
+		//split it again, if it strays too far from its chord
+		if(flatness_conic(current) > max_flatness)
 		{
 			Subd_Conic_Stack(current);
 			current += 2; 		//cursor on second curve
-			level ++;
 			num ++;
-			onsecond = false;
-			continue;
-		}else
-		//split it again, if it's too big
-		if(max_edges_conic(current) > 0.25) //distance of .5 (cover no more than half the pixel)
-		{
-			Subd_Conic_Stack(current);
-			current += 2; 		//cursor on second curve
-			level ++;
-			num ++;
-			onsecond = false;
 		}
-		else	//NOT TOO BIG? RENDER!!!
+		else	//FLAT ENOUGH? RENDER!!!
 		{
-			//cur_x,cur_y = current[2], so we need to go 1,0
-			line_to(current[1][0],current[1][1]);
+			//cur_x,cur_y = current[2], the chord is close enough to the curve
 			line_to(current[0][0],current[0][1]);
 
 			current -= 2;
-			if(onsecond) level--;
 			num--;
-			onsecond = true;
 		}
 	}
 }
@@ -1607,8 +1691,6 @@ void Layer_Shape::PolySpan::cubic_to(Real x1, Real y1, Real x2, Real y2, Real x,
 {
 	Point *current = arc;
 	int		num = 0;
-	int		level = 0;
-	bool	onsecond = false;
 
 	arc[0] = Point(x,y);
 	arc[1] = Point(x2,y2);
@@ -1622,7 +1704,9 @@ void Layer_Shape::PolySpan::cubic_to(Real x1, Real y1, Real x2, Real y2, Real x,
 		return;
 	}
 
-	//Ok so it's not super degenerate, subdivide and draw (run through minimum subdivision levels first)
+	const Real max_flatness = 16*tolerance*tolerance;
+
+	//Ok so it's not super degenerate, subdivide until it is flat enough and draw
 	while(current >= arc) //once current goes below arc, there are no more curves left
 	{
 		if(num >= MAX_SUBDIVISION_SIZE)
@@ -1633,48 +1717,29 @@ void Layer_Shape::PolySpan::cubic_to(Real x1, Real y1, Real x2, Real y2, Real x,
 			assert(0);
 			return;
 		}else
-
-		//if we are not at the level minimum
-		if(level < MIN_SUBDIVISION_DRAW_LEVELS)
-		{
-			Subd_Cubic_Stack(current);
-			current += 3; 		//cursor on second curve
-			level ++;
-			num ++;
-			onsecond = false;
-			continue;
-		}else
 		//if the curve is clipping then draw degenerate
 		if(clip_cubic(current,window))
 		{
 			line_to(current[0][0],current[0][1]); //backwards so front is destination
 			current -= 3;
-			if(onsecond) level--;
-			onsecond = true;
 			num --;
 			continue;
 		}
 		else
-		//split it again, if it's too big
-		if(max_edges_cubic(current) > 0.25) //could use max_edges<3>
+		//split it again, if it strays too far from its chord
+		if(flatness_cubic(current) > max_flatness)
 		{
 			Subd_Cubic_Stack(current);
 			current += 3; 		//cursor on second curve
-			level ++;
 			num ++;
-			onsecond = false;
 		}
-		else //NOT TOO BIG? RENDER!!!
+		else //FLAT ENOUGH? RENDER!!!
 		{
-			//cur_x,cur_y = current[3], so we need to go 2,1,0
-			line_to(current[2][0],current[2][1]);
-			line_to(current[1][0],current[1][1]);
+			//cur_x,cur_y = current[3], the chord is close enough to the curve
 			line_to(current[0][0],current[0][1]);
 
 			current -= 3;
-			if(onsecond) level--;
 			num --;
-			onsecond = true;
 		}
 	}
 }
@@ -44,6 +44,7 @@
 
 #include "layer_pastecanvas.h"
 #include "loadcanvas.h"
+#include "savecanvas.h"
 #include "valuenode.h"
 #include "valuenode_animated.h"
 #include "valuenode_composite.h"
@@ -69,8 +70,24 @@
 #include "gradient.h"
 
 #include <map>
+#include <deque>
+#include <algorithm>
+#include <sys/stat.h>
 #include <sigc++/bind.h>
 
+#include "importer.h"
+#include "module.h"
+#include "mutex.h"
+
+#ifdef HAVE_LIBPTHREAD
+#include <pthread.h>
+#include <unistd.h>
+#endif
+
+extern "C" {
+#include <libxml/parser.h>
+}
+
 #endif
 
 /* === U S I N G =========================================================== */
@@ -103,6 +120,32 @@ std::set<String> CanvasParser::loading_;
 
 static std::map<String, Canvas::LooseHandle>* open_canvas_map_(0);
 
+//! Modification times of files, by absolute file name
+typedef std::map<String, time_t> FileTimes;
+
+//! Canvases kept parsed by open_canvas_cached(), with the modification times
+//! of the files they were parsed from, by absolute file name
+static std::map<String, std::pair<Canvas::Handle, FileTimes> >* canvas_cache_(0);
+
+//! While open_canvas_cached() parses a file, the files that it reads
+static FileTimes* loaded_files_(0);
+
+//! Returns the modification time of \a filename, or 0 if it can't be found
+static time_t
+file_mtime(const String &filename)
+{
+	struct stat buf;
+	return stat(filename.c_str(),&buf)==0 ? buf.st_mtime : 0;
+}
+
+//! Notes that \a filename is read as part of the canvas open_canvas_cached() is parsing
+static void
+note_loaded_file(const String &filename)
+{
+	if(loaded_files_)
+		(*loaded_files_)[etl::absolute_path(filename)]=file_mtime(filename);
+}
+
 std::map<synfig::String, etl::loose_handle<Canvas> >& synfig::get_open_canvas_map()
 {
 	if(!open_canvas_map_)
@@ -127,12 +170,482 @@ static void _canvas_file_name_changed(Canvas *x)
 
 }
 
+/* === E X T E R N A L S =================================================== */
+
+//! Maximum number of threads used to load the files a canvas refers to
+#define EXTERNAL_LOADER_MAX_THREADS	8
+
+//! Loads the files a canvas file refers to while it is being parsed
+/*!	External canvases (\c use="file.sif#...") and the images of import
+**	layers are collected by scan() from each part of the file as the
+**	parser gets to it, and are then read on a pool of threads, which
+**	follow the references of the canvases they load in turn.
+**	Only the reading, the XML parsing and the creation of the importers
+**	happen on the threads. The canvases are still built from the parsed
+**	documents one at a time on the parsing thread, when they are looked
+**	up through surefind_canvas(), which waits for the document if it
+**	is still being read. The filenames of import layers are only set
+**	once the whole file is parsed, by finish(), so that their images
+**	can all be loaded at once. The loader of the outermost file being
+**	opened does all of the work, the loaders of the files it refers to
+**	only hand it what they find. */
+class ExternalLoader
+{
+	struct Job
+	{
+		bool canvas;
+		String filename;
+		//! \c true once a thread has taken the job
+		bool started;
+		//! Held by the thread doing the job, until it is done
+		Mutex done;
+		xmlpp::DomParser *parser;
+		Importer *importer;
+
+		Job(bool canvas, const String &filename):
+			canvas(canvas), filename(filename), started(false), parser(0), importer(0) { }
+	};
+
+	//! An import layer waiting for its filename
+	struct Import
+	{
+		Layer::Handle layer;
+		ValueBase filename;
+	};
+
+	static ExternalLoader *current_;
+
+	//! The book of importers is added to by modules loaded while the threads run
+	static Mutex importer_mutex_;
+
+	bool outermost_;
+	Mutex mutex_;
+	std::deque<Job*> queue_;
+	std::map<String,Job*> jobs_;
+	std::vector<Import> imports_;
+	std::vector<Importer::Handle> importer_handles_;
+
+	int max_threads_;
+	//! Number of threads which haven't yet run out of jobs
+	int running_;
+#ifdef HAVE_LIBPTHREAD
+	std::vector<pthread_t> threads_;
+
+	static void *worker(void *data);
+#endif
+
+	void add(bool canvas, const String &filename, bool on_thread);
+	void take(Job *job);
+	void process(Job *job);
+	void join();
+
+	void scan(const xmlpp::Element *element, const String &dir, bool on_thread);
+
+	static String full_path(const String &dir, const String &filename)
+	{
+		if(is_absolute_path(filename))
+			return absolute_path(filename);
+		return absolute_path(dir+ETL_DIRECTORY_SEPARATOR+filename);
+	}
+
+public:
+	ExternalLoader();
+	~ExternalLoader();
+
+	//! Returns \c true if this is the loader of the outermost file being opened
+	bool is_outermost()const { return outermost_; }
+
+	//! Loads whatever is left, and sets the filenames of the import layers
+	/*!	Only called on the loader of the outermost file, once it is parsed */
+	void finish();
+
+	//! Starts loading the external files referred to within \a element
+	/*!	\a dir is the directory that relative file names are taken from.
+	**	Does nothing unless a file is being opened. */
+	static void collect(const xmlpp::Element *element, const String &dir);
+
+	//! Returns the root of the parsed canvas file \a filename, if it was loaded ahead
+	/*!	Waits for the file if it is still being read */
+	static xmlpp::Element *find_canvas(const String &filename);
+
+	//! Leaves setting the filename of the import layer \a layer to finish()
+	/*!	Returns \c false if no file is being opened, in which
+	**	case the filename has to be set right away */
+	static bool defer_import(const Layer::Handle &layer, const ValueBase &filename);
+};
+
+ExternalLoader *ExternalLoader::current_(0);
+Mutex ExternalLoader::importer_mutex_;
+
+ExternalLoader::ExternalLoader():
+	outermost_(!current_),
+	max_threads_(0),
+	running_(0)
+{
+	if(!outermost_)
+		return;
+	current_=this;
+
+#ifdef HAVE_LIBPTHREAD
+	// libxml2 must be set up before it is used from several threads
+	xmlInitParser();
+
+	max_threads_=1;
+#ifdef _SC_NPROCESSORS_ONLN
+	max_threads_=std::max(1,std::min((int)sysconf(_SC_NPROCESSORS_ONLN),EXTERNAL_LOADER_MAX_THREADS));
+#endif
+#endif
+}
+
+ExternalLoader::~ExternalLoader()
+{
+	if(!outermost_)
+		return;
+
+	// a file which failed to parse leaves its threads to be waited for here
+	join();
+	current_=0;
+
+	for(std::map<String,Job*>::iterator iter=jobs_.begin();iter!=jobs_.end();++iter)
+	{
+		delete iter->second->parser;
+		delete iter->second->importer;
+		delete iter->second;
+	}
+}
+
+void
+ExternalLoader::add(bool canvas, const String &filename, bool on_thread)
+{
+	// Modules can only be loaded on the parsing thread, so the images
+	// found on the threads are left to the parser if their importer
+	// isn't loaded
+	if(!canvas && !on_thread)
+	{
+		Mutex::Lock lock(importer_mutex_);
+		if(!Importer::get_factory(filename))
+			Importer::request_module(filename);
+	}
+
+	Mutex::Lock lock(mutex_);
+	if(jobs_.count(filename))
+		return;
+
+	Job *job(new Job(canvas,filename));
+	jobs_[filename]=job;
+	queue_.push_back(job);
+
+#ifdef HAVE_LIBPTHREAD
+	if(running_<max_threads_)
+	{
+		pthread_t thread;
+		if(pthread_create(&thread,NULL,&ExternalLoader::worker,this)==0)
+		{
+			threads_.push_back(thread);
+			running_++;
+		}
+	}
+#endif
+}
+
+void
+ExternalLoader::scan(const xmlpp::Element *element, const String &dir, bool on_thread)
+{
+	const xmlpp::Attribute *use(element->get_attribute("use"));
+	if(use)
+	{
+		const String value(use->get_value());
+		const String::size_type hash(value.find('#'));
+		if(hash!=String::npos && hash>0)
+			add(true,full_path(dir,unix_to_local_path(String(value,0,hash))),on_thread);
+	}
+
+	const bool import(element->get_name()=="layer" && element->get_attribute("type") &&
+					  element->get_attribute("type")->get_value()=="import");
+
+	xmlpp::Element::NodeList list(element->get_children());
+	for(xmlpp::Element::NodeList::iterator iter=list.begin();iter!=list.end();++iter)
+	{
+		const xmlpp::Element *child(dynamic_cast<const xmlpp::Element*>(*iter));
+		if(!child)
+			continue;
+
+		// <param name="filename"><string>...</string></param>, named the way Import::set_param() names it
+		if(import && child->get_name()=="param" && child->get_attribute("name") &&
+		   child->get_attribute("name")->get_value()=="filename")
+		{
+			xmlpp::Element::NodeList strings(child->get_children("string"));
+			const xmlpp::Element *string(strings.empty() ? 0 : dynamic_cast<const xmlpp::Element*>(strings.front()));
+			if(string && string->get_child_text())
+			{
+				String filename(string->get_child_text()->get_content());
+				String::size_type n;
+				while((n=filename.find("%20"))!=String::npos)
+					filename.replace(n,3," ");
+				if(!filename.empty())
+					add(false,full_path(dir,filename),on_thread);
+			}
+			continue;
+		}
+
+		scan(child,dir,on_thread);
+	}
+}
+
+void
+ExternalLoader::process(Job *job)
+{
+	if(job->canvas)
+	{
+		xmlpp::DomParser *parser(new xmlpp::DomParser());
+		try
+		{
+			if(filename_extension(job->filename)==CANVAS_SECTIONS_EXTENSION)
+			{
+				String text;
+				if(read_canvas_section(job->filename,0,text))
+					parser->parse_memory(text);
+			}
+			else
+				parser->parse_file(job->filename);
+		}
+		catch(...) { }
+
+		// Anything that failed is left for the parser to open, and report, by itself
+		if(!*parser || !parser->get_document()->get_root_node())
+		{
+			delete parser;
+			return;
+		}
+
+		job->parser=parser;
+		scan(parser->get_document()->get_root_node(),dirname(job->filename),true);
+		return;
+	}
+
+	Importer::Factory factory;
+	{
+		Mutex::Lock lock(importer_mutex_);
+		factory=Importer::get_factory(job->filename);
+	}
+	if(!factory)
+		return;
+
+	// Importers decode their files as they are created, which is the work
+	// worth doing on the threads, so the factories are called unlocked
+	try { job->importer=factory(job->filename.c_str()); }
+	catch(...) { }
+}
+
+void
+ExternalLoader::take(Job *job)
+{
+	job->started=true;
+	job->done.lock();
+}
+
+#ifdef HAVE_LIBPTHREAD
+void *
+ExternalLoader::worker(void *data)
+{
+	ExternalLoader *loader(static_cast<ExternalLoader*>(data));
+
+	for(;;)
+	{
+		Job *job;
+		{
+			Mutex::Lock lock(loader->mutex_);
+			// the thread ends once the queue runs dry,
+			// add() starts another one when more turns up
+			if(loader->queue_.empty())
+			{
+				loader->running_--;
+				return NULL;
+			}
+			job=loader->queue_.front();
+			loader->queue_.pop_front();
+			loader->take(job);
+		}
+
+		loader->process(job);
+		job->done.unlock();
+	}
+}
+#endif
+
+void
+ExternalLoader::join()
+{
+#ifdef HAVE_LIBPTHREAD
+	// jobs still running may start more threads
+	for(;;)
+	{
+		pthread_t thread;
+		{
+			Mutex::Lock lock(mutex_);
+			if(threads_.empty())
+				break;
+			thread=threads_.back();
+			threads_.pop_back();
+		}
+		pthread_join(thread,NULL);
+	}
+#endif
+}
+
+void
+ExternalLoader::finish()
+{
+	join();
+
+	// whatever the threads couldn't take, if any, is loaded here
+	while(!queue_.empty())
+	{
+		Job *job(queue_.front());
+		queue_.pop_front();
+		take(job);
+		process(job);
+		job->done.unlock();
+	}
+
+	// Importer handles aren't thread safe, so they are
+	// only made once the threads are done with them
+	for(std::map<String,Job*>::iterator iter=jobs_.begin();iter!=jobs_.end();++iter)
+	{
+		if(!iter->second->canvas)
+			note_loaded_file(iter->first);
+		if(iter->second->importer)
+		{
+			Importer::Handle importer(iter->second->importer);
+			iter->second->importer=0;
+			importer_handles_.push_back(importer);
+			Importer::set_open(iter->first,importer);
+		}
+	}
+
+	for(std::vector<Import>::iterator iter=imports_.begin();iter!=imports_.end();++iter)
+		if(!iter->layer->set_param("filename",iter->filename))
+			synfig::warning(strprintf(_("Layer '%s' rejected value for parameter '%s'"),
+									  iter->layer->get_name().c_str(),"filename"));
+	imports_.clear();
+}
+
+void
+ExternalLoader::collect(const xmlpp::Element *element, const String &dir)
+{
+	if(current_)
+		current_->scan(element,dir,false);
+}
+
+xmlpp::Element *
+ExternalLoader::find_canvas(const String &filename)
+{
+	if(!current_)
+		return 0;
+
+	Job *job;
+	bool read_here(false);
+	{
+		Mutex::Lock lock(current_->mutex_);
+		std::map<String,Job*>::iterator iter(current_->jobs_.find(absolute_path(filename)));
+		if(iter==current_->jobs_.end() || !iter->second->canvas)
+			return 0;
+		job=iter->second;
+
+		// Nothing has got to it yet, so it is read right here
+		if(!job->started)
+		{
+			current_->queue_.erase(std::find(current_->queue_.begin(),current_->queue_.end(),job));
+			current_->take(job);
+			read_here=true;
+		}
+	}
+
+	if(read_here)
+		current_->process(job);
+	else
+		job->done.lock();
+	job->done.unlock();
+
+	if(!job->parser)
+		return 0;
+	return job->parser->get_document()->get_root_node();
+}
+
+bool
+ExternalLoader::defer_import(const Layer::Handle &layer, const ValueBase &filename)
+{
+	if(!current_)
+		return false;
+
+	Import import;
+	import.layer=layer;
+	import.filename=filename;
+	current_->imports_.push_back(import);
+	return true;
+}
+
 Canvas::Handle
 synfig::open_canvas(const String &filename,String &errors,String &warnings)
 {
 	return open_canvas_as(filename, filename, errors, warnings);
 }
 
+Canvas::Handle
+synfig::open_canvas_cached(const String &filename,String &errors,String &warnings)
+{
+	if(!canvas_cache_)
+		canvas_cache_=new std::map<String, std::pair<Canvas::Handle, FileTimes> >;
+
+	const String key(etl::absolute_path(filename));
+	std::map<String, std::pair<Canvas::Handle, FileTimes> >::iterator iter(canvas_cache_->find(key));
+	if(iter!=canvas_cache_->end())
+	{
+		FileTimes::const_iterator file;
+		for(file=iter->second.second.begin();file!=iter->second.second.end();++file)
+			if(file_mtime(file->first)!=file->second)
+				break;
+		if(file==iter->second.second.end())
+			return iter->second.first;
+
+		// The file, or one that it refers to, has changed since it was
+		// parsed, so parse it again rather than getting the old canvases
+		// back from the open canvases, or the old images from the importers
+		const FileTimes files(iter->second.second);
+		canvas_cache_->erase(iter);
+		for(file=files.begin();file!=files.end();++file)
+		{
+			get_open_canvas_map().erase(file->first);
+			Importer::forget_open(file->first);
+		}
+	}
+
+	FileTimes files;
+	loaded_files_=&files;
+	Canvas::Handle canvas;
+	try
+	{
+		canvas=open_canvas(filename, errors, warnings);
+	}
+	catch(...)
+	{
+		loaded_files_=0;
+		throw;
+	}
+	loaded_files_=0;
+
+	if(canvas)
+		(*canvas_cache_)[key]=std::make_pair(canvas,files);
+	return canvas;
+}
+
+void
+synfig::clear_canvas_cache()
+{
+	delete canvas_cache_;
+	canvas_cache_=0;
+}
+
 Canvas::Handle
 synfig::open_canvas_as(const String &filename,const String &as,String &errors,String &warnings)
 {
@@ -153,6 +666,8 @@ synfig::open_canvas_as(const String &filename,const String &as,String &errors,St
 	CanvasParser parser;
 	parser.set_allow_errors(true);
 
+	note_loaded_file(filename);
+
 	try
 	{
 		CanvasParser::loading_.insert(filename);
@@ -1555,7 +2070,10 @@ CanvasParser::parse_linkable_value_node(xmlpp::Element *element,Canvas::Handle c
 				c[index] = canvas->surefind_value_node(id);
 				if(placeholders == canvas->value_node_list().placeholder_count())
 					if(PlaceholderValueNode::Handle::cast_dynamic(c[index]) )
-						throw Exception::IDNotFound("parse_linkable_value_noode()");
+					{
+						error(element,"Unable to resolve " + id);
+						continue;
+					}
 
 				if (!c[index])
 				{
@@ -1962,10 +2480,12 @@ CanvasParser::parse_dynamic_list(xmlpp::Element *element,Canvas::Handle canvas)
 				try
 				{
 					list_entry.value_node=canvas->surefind_value_node(id);
-					if(PlaceholderValueNode::Handle::cast_dynamic(list_entry.value_node))
-						throw Exception::IDNotFound("parse_dynamic_list()");
 				}
 				catch(Exception::IDNotFound)
+				{
+					list_entry.value_node=0;
+				}
+				if(!list_entry.value_node || PlaceholderValueNode::Handle::cast_dynamic(list_entry.value_node))
 				{
 					error(child,"\"use\" attribute in <entry> references unknown ID -- "+id);
 					continue;
@@ -2054,7 +2574,8 @@ CanvasParser::parse_value_node(xmlpp::Element *element,Canvas::Handle canvas)
 	if(element->get_name()=="dilist") // This is not a typo. The dynamic list parser will parse a dilist.
 		value_node=parse_dynamic_list(element,canvas);
 	else
-	if(LinkableValueNode::book().count(element->get_name()))
+	if(LinkableValueNode::book().count(element->get_name()) ||
+	   Module::request(Module::ENTRY_VALUENODE,element->get_name()))
 	{
 		value_node=parse_linkable_value_node(element,canvas);
 		if (!value_node) value_node = PlaceholderValueNode::create();
@@ -2116,12 +2637,64 @@ CanvasParser::parse_canvas_defs(xmlpp::Element *element,Canvas::Handle canvas)
 			continue;
 		else
 		if(child->get_name()=="canvas")
-			parse_canvas(child, canvas);
+		{
+			// Child canvases kept in sections of their own are only
+			// created here, and are read in when they are first needed
+			if(child->get_attribute("section") && !sections_file_.empty())
+			{
+				bool existing;
+				Canvas::Handle child_canvas(parse_canvas_header(child,canvas,false,filename,existing));
+				if(child_canvas && !existing)
+					child_canvas->set_deferred_loader(sigc::bind(sigc::ptr_fun(&CanvasParser::load_canvas_section),
+						sections_file_,filename,atoi(child->get_attribute("section")->get_value().c_str()),
+						Canvas::LooseHandle(canvas)));
+			}
+			else
+				parse_canvas(child, canvas);
+		}
 		else
 			parse_value_node(child,canvas);
 	}
 }
 
+void
+CanvasParser::load_canvas_section(String file,String as,int index,Canvas::LooseHandle parent)
+{
+	ChangeLocale change_locale(LC_NUMERIC, "C");
+
+	String text;
+	if(!read_canvas_section(file,index,text))
+	{
+		synfig::error("Unable to read section %d of %s",index,file.c_str());
+		return;
+	}
+
+	CanvasParser parser;
+	parser.set_allow_errors(true);
+	parser.filename=as;
+	parser.sections_file_=file;
+
+	try
+	{
+		xmlpp::DomParser dom;
+		dom.parse_memory(text);
+		if(dom)
+			parser.parse_canvas(dom.get_document()->get_root_node(),parent,false,as);
+	}
+	catch(const std::exception& ex)
+	{
+		synfig::error("Loading section %d of %s: %s",index,file.c_str(),ex.what());
+	}
+	catch(const String& str)
+	{
+		synfig::error("Loading section %d of %s: %s",index,file.c_str(),str.c_str());
+	}
+	catch(...)
+	{
+		synfig::error("Loading section %d of %s: Caught unknown exception",index,file.c_str());
+	}
+}
+
 Layer::Handle
 CanvasParser::parse_layer(xmlpp::Element *element,Canvas::Handle canvas)
 {
@@ -2220,7 +2793,10 @@ CanvasParser::parse_layer(xmlpp::Element *element,Canvas::Handle canvas)
 				{
 					handle<ValueNode> value_node=canvas->surefind_value_node(str);
 					if(PlaceholderValueNode::Handle::cast_dynamic(value_node))
-						throw Exception::IDNotFound("parse_layer()");
+					{
+						error(child,strprintf(_("Unknown ID (%s) referenced in parameter \"%s\""),str.c_str(), param_name.c_str()));
+						continue;
+					}
 
 					// Assign the value_node to the dynamic parameter list
 					if (param_name == "segment_list" && (layer->get_name() == "region" || layer->get_name() == "outline"))
@@ -2265,6 +2841,12 @@ CanvasParser::parse_layer(xmlpp::Element *element,Canvas::Handle canvas)
 					continue;
 				}
 
+				// The images of import layers are loaded on other
+				// threads, and only set once the file is parsed
+				if(param_name=="filename" && layer->get_name()=="import" &&
+				   ExternalLoader::defer_import(layer,data))
+					continue;
+
 				// Set the layer's parameter, and make sure that
 				// the layer liked it
 				if(!layer->set_param(param_name,data))
@@ -2306,6 +2888,30 @@ CanvasParser::parse_layer(xmlpp::Element *element,Canvas::Handle canvas)
 Canvas::Handle
 CanvasParser::parse_canvas(xmlpp::Element *element,Canvas::Handle parent,bool inline_, String filename)
 {
+	bool existing;
+	Canvas::Handle canvas(parse_canvas_header(element,parent,inline_,filename,existing));
+	if(!canvas || existing)
+		return canvas;
+
+	xmlpp::Element::NodeList list = element->get_children();
+	for(xmlpp::Element::NodeList::iterator iter = list.begin(); iter != list.end(); ++iter)
+	{
+		xmlpp::Element *child(dynamic_cast<xmlpp::Element*>(*iter));
+		if(child)
+			parse_canvas_child(child,canvas);
+//		else
+//		if((child->get_name()=="text"||child->get_name()=="comment") && child->has_child_text())
+//			continue;
+	}
+
+	parse_canvas_footer(element,canvas);
+	return canvas;
+}
+
+Canvas::Handle
+CanvasParser::parse_canvas_header(xmlpp::Element *element,Canvas::Handle parent,bool inline_, String filename, bool &existing)
+{
+	existing=false;
 
 	if(element->get_name()!="canvas")
 	{
@@ -2351,7 +2957,10 @@ CanvasParser::parse_canvas(xmlpp::Element *element,Canvas::Handle parent,bool in
 	{
 		GUID guid(element->get_attribute("guid")->get_value());
 		if(guid_cast<Canvas>(guid))
+		{
+			existing=true;
 			return guid_cast<Canvas>(guid);
+		}
 		else
 			canvas->set_guid(guid);
 	}
@@ -2450,114 +3059,113 @@ CanvasParser::parse_canvas(xmlpp::Element *element,Canvas::Handle parent,bool in
 
 	canvas->rend_desc().set_flags(RendDesc::PX_ASPECT|RendDesc::IM_SPAN);
 
-	xmlpp::Element::NodeList list = element->get_children();
-	for(xmlpp::Element::NodeList::iterator iter = list.begin(); iter != list.end(); ++iter)
+	return canvas;
+}
+
+void
+CanvasParser::parse_canvas_child(xmlpp::Element *child,Canvas::Handle canvas)
+{
+	if(child->get_name()=="defs")
 	{
-		xmlpp::Element *child(dynamic_cast<xmlpp::Element*>(*iter));
-		if(child)
+		if(canvas->is_inline())
+			error(child,_("Inline canvas cannot have a <defs> section"));
+		parse_canvas_defs(child, canvas);
+	}
+	else
+	if(child->get_name()=="keyframe")
+	{
+		if(canvas->is_inline())
 		{
-			if(child->get_name()=="defs")
-			{
-				if(canvas->is_inline())
-					error(child,_("Inline canvas cannot have a <defs> section"));
-				parse_canvas_defs(child, canvas);
-			}
-			else
-			if(child->get_name()=="keyframe")
-			{
-				if(canvas->is_inline())
-				{
-					warning(child,_("Inline canvas cannot have keyframes"));
-					continue;
-				}
+			warning(child,_("Inline canvas cannot have keyframes"));
+			return;
+		}
 
-				canvas->keyframe_list().add(parse_keyframe(child,canvas));
-				canvas->keyframe_list().sync();
-			}
-			else
-			if(child->get_name()=="meta")
-			{
-				if(canvas->is_inline())
-				{
-					warning(child,_("Inline canvases cannot have metadata"));
-					continue;
-				}
+		canvas->keyframe_list().add(parse_keyframe(child,canvas));
+		canvas->keyframe_list().sync();
+	}
+	else
+	if(child->get_name()=="meta")
+	{
+		if(canvas->is_inline())
+		{
+			warning(child,_("Inline canvases cannot have metadata"));
+			return;
+		}
 
-				String name,content;
+		String name,content;
 
-				if(!child->get_attribute("name"))
-				{
-					warning(child,_("<meta> must have a name"));
-					continue;
-				}
+		if(!child->get_attribute("name"))
+		{
+			warning(child,_("<meta> must have a name"));
+			return;
+		}
 
-				if(!child->get_attribute("content"))
-				{
-					warning(child,_("<meta> must have content"));
-					continue;
-				}
+		if(!child->get_attribute("content"))
+		{
+			warning(child,_("<meta> must have content"));
+			return;
+		}
 
-				canvas->set_meta_data(child->get_attribute("name")->get_value(),child->get_attribute("content")->get_value());
-			}
-			else if(child->get_name()=="name")
-			{
-				xmlpp::Element::NodeList list = child->get_children();
+		canvas->set_meta_data(child->get_attribute("name")->get_value(),child->get_attribute("content")->get_value());
+	}
+	else if(child->get_name()=="name")
+	{
+		xmlpp::Element::NodeList list = child->get_children();
 
-				// If we don't have any name, warn
-				if(list.empty())
-					warning(child,_("blank \"name\" entity"));
+		// If we don't have any name, warn
+		if(list.empty())
+			warning(child,_("blank \"name\" entity"));
 
-				string tmp;
-				for(xmlpp::Element::NodeList::iterator iter = list.begin(); iter != list.end(); ++iter)
-					if(dynamic_cast<xmlpp::TextNode*>(*iter))tmp+=dynamic_cast<xmlpp::TextNode*>(*iter)->get_content();
-				canvas->set_name(tmp);
-			}
-			else
-			if(child->get_name()=="desc")
-			{
+		string tmp;
+		for(xmlpp::Element::NodeList::iterator iter = list.begin(); iter != list.end(); ++iter)
+			if(dynamic_cast<xmlpp::TextNode*>(*iter))tmp+=dynamic_cast<xmlpp::TextNode*>(*iter)->get_content();
+		canvas->set_name(tmp);
+	}
+	else
+	if(child->get_name()=="desc")
+	{
 
-				xmlpp::Element::NodeList list = child->get_children();
+		xmlpp::Element::NodeList list = child->get_children();
 
-				// If we don't have any description, warn
-				if(list.empty())
-					warning(child,_("blank \"desc\" entity"));
+		// If we don't have any description, warn
+		if(list.empty())
+			warning(child,_("blank \"desc\" entity"));
 
-				string tmp;
-				for(xmlpp::Element::NodeList::iterator iter = list.begin(); iter != list.end(); ++iter)
-					if(dynamic_cast<xmlpp::TextNode*>(*iter))tmp+=dynamic_cast<xmlpp::TextNode*>(*iter)->get_content();
-				canvas->set_description(tmp);
-			}
-			else
-			if(child->get_name()=="author")
-			{
+		string tmp;
+		for(xmlpp::Element::NodeList::iterator iter = list.begin(); iter != list.end(); ++iter)
+			if(dynamic_cast<xmlpp::TextNode*>(*iter))tmp+=dynamic_cast<xmlpp::TextNode*>(*iter)->get_content();
+		canvas->set_description(tmp);
+	}
+	else
+	if(child->get_name()=="author")
+	{
 
-				xmlpp::Element::NodeList list = child->get_children();
+		xmlpp::Element::NodeList list = child->get_children();
 
-				// If we don't have any description, warn
-				if(list.empty())
-					warning(child,_("blank \"author\" entity"));
+		// If we don't have any description, warn
+		if(list.empty())
+			warning(child,_("blank \"author\" entity"));
 
-				string tmp;
-				for(xmlpp::Element::NodeList::iterator iter = list.begin(); iter != list.end(); ++iter)
-					if(dynamic_cast<xmlpp::TextNode*>(*iter))tmp+=dynamic_cast<xmlpp::TextNode*>(*iter)->get_content();
-				canvas->set_author(tmp);
-			}
-			else
-			if(child->get_name()=="layer")
-			{
-				//if(canvas->is_inline())
-				//	canvas->push_front(parse_layer(child,canvas->parent()));
-				//else
-					canvas->push_front(parse_layer(child,canvas));
-			}
-			else
-				error_unexpected_element(child,child->get_name());
-		}
-//		else
-//		if((child->get_name()=="text"||child->get_name()=="comment") && child->has_child_text())
-//			continue;
+		string tmp;
+		for(xmlpp::Element::NodeList::iterator iter = list.begin(); iter != list.end(); ++iter)
+			if(dynamic_cast<xmlpp::TextNode*>(*iter))tmp+=dynamic_cast<xmlpp::TextNode*>(*iter)->get_content();
+		canvas->set_author(tmp);
+	}
+	else
+	if(child->get_name()=="layer")
+	{
+		//if(canvas->is_inline())
+		//	canvas->push_front(parse_layer(child,canvas->parent()));
+		//else
+			canvas->push_front(parse_layer(child,canvas));
 	}
+	else
+		error_unexpected_element(child,child->get_name());
+}
 
+void
+CanvasParser::parse_canvas_footer(xmlpp::Element *element,Canvas::Handle canvas)
+{
 	if(canvas->value_node_list().placeholder_count())
 	{
 		String nodes;
@@ -2574,9 +3182,72 @@ CanvasParser::parse_canvas(xmlpp::Element *element,Canvas::Handle parent,bool in
 	}
 
 	canvas->set_version(CURRENT_CANVAS_VERSION);
+}
+
+Canvas::Handle
+CanvasParser::parse_canvas_stream(xmlpp::TextReader &reader, String filename)
+{
+	// find the root element
+	bool more(reader.read());
+	while(more && reader.get_node_type()!=xmlpp::TextReader::Element)
+		more=reader.read();
+	if(!more)
+		throw runtime_error(String("  * ") + _("Can't find a canvas in file") + " \"" + filename + "\"");
+
+	// only the attributes of the root have been read at this point,
+	// which is all that is needed to set up the canvas
+	bool existing;
+	const bool empty(reader.is_empty_element());
+	xmlpp::Element *root(dynamic_cast<xmlpp::Element*>(reader.get_current_node()));
+	Canvas::Handle canvas(parse_canvas_header(root,0,false,filename,existing));
+	if(!canvas || existing)
+		return canvas;
+
+	// Expand each child of the root on its own and parse it before
+	// moving on to the next, so that the reader can let go of the
+	// ones it has passed and the whole document is never in memory
+	more=!empty && reader.read();
+	while(more && reader.get_depth()>0)
+	{
+		if(reader.get_node_type()==xmlpp::TextReader::Element)
+		{
+			xmlpp::Element *child(dynamic_cast<xmlpp::Element*>(reader.expand()));
+			if(child)
+			{
+				// the files it refers to are read on other threads
+				// while it is parsed
+				ExternalLoader::collect(child,dirname(filename));
+				parse_canvas_child(child,canvas);
+			}
+			more=reader.next();
+		}
+		else
+			more=reader.read();
+	}
+
+	parse_canvas_footer(root,canvas);
 	return canvas;
 }
 
+void
+CanvasParser::remove_unnamed_value_nodes(Canvas::Handle canvas)
+{
+	const ValueNodeList& value_node_list(canvas->value_node_list());
+
+	// collect them first, since removing them changes the list
+	std::vector<ValueNode::Handle> unnamed;
+	ValueNodeList::const_iterator iter;
+	for(iter=value_node_list.begin();iter!=value_node_list.end();++iter)
+	{
+		ValueNode::Handle value_node(*iter);
+		if(value_node->is_exported() && value_node->get_id().find("Unnamed")==0)
+			unnamed.push_back(value_node);
+	}
+
+	for(std::vector<ValueNode::Handle>::iterator iter=unnamed.begin();iter!=unnamed.end();++iter)
+		canvas->remove_value_node(*iter);
+}
+
 void
 CanvasParser::register_canvas_in_map(Canvas::Handle canvas, String as)
 {
@@ -2617,26 +3288,44 @@ CanvasParser::parse_from_file_as(const String &file_,const String &as_,String &e
 
 		filename=as;
 		total_warnings_=0;
-		xmlpp::DomParser parser(file);
-		if(parser)
+		ExternalLoader loader;
 		{
-			Canvas::Handle canvas(parse_canvas(parser.get_document()->get_root_node(),0,false,as));
-			if (!canvas) return canvas;
-			register_canvas_in_map(canvas, as);
+			Canvas::Handle canvas;
+			if(filename_extension(file)==CANVAS_SECTIONS_EXTENSION)
+				sections_file_=file;
 
-			const ValueNodeList& value_node_list(canvas->value_node_list());
-
-			again:
-			ValueNodeList::const_iterator iter;
-			for(iter=value_node_list.begin();iter!=value_node_list.end();++iter)
+			if(xmlpp::Element *root=ExternalLoader::find_canvas(file))
+			{
+				// Already read along with the file that refers to it
+				canvas=parse_canvas(root,0,false,as);
+			}
+			else if(!sections_file_.empty())
 			{
-				ValueNode::Handle value_node(*iter);
-				if(value_node->is_exported() && value_node->get_id().find("Unnamed")==0)
+				// Only the root canvas is read now, its exported
+				// children are read from their sections when needed
+				String text;
+				if(!read_canvas_section(file,0,text))
+					throw runtime_error(String("  * ") + _("Can't open file") + " \"" + file + "\"");
+
+				xmlpp::DomParser parser;
+				parser.parse_memory(text);
+				if(parser)
 				{
-					canvas->remove_value_node(value_node);
-					goto again;
+					ExternalLoader::collect(parser.get_document()->get_root_node(),dirname(as));
+					canvas=parse_canvas(parser.get_document()->get_root_node(),0,false,as);
 				}
 			}
+			else
+			{
+				xmlpp::TextReader reader(file);
+				canvas=parse_canvas_stream(reader,as);
+			}
+			if(loader.is_outermost())
+				loader.finish();
+			if (!canvas) return canvas;
+			register_canvas_in_map(canvas, as);
+
+			remove_unnamed_value_nodes(canvas);
 
 			return canvas;
 		}
@@ -2648,7 +3337,8 @@ CanvasParser::parse_from_file_as(const String &file_,const String &as_,String &e
 	catch(Exception::IDAlreadyExists) { synfig::error("IDAlreadyExists Thrown"); }
 	catch(xmlpp::internal_error x)
 	{
-		if (!strcmp(x.what(), "Couldn't create parsing context"))
+		if (!strcmp(x.what(), "Couldn't create parsing context") ||
+			!strcmp(x.what(), "Cannot instantiate underlying libxml2 structure"))
 			throw runtime_error(String("  * ") + _("Can't open file") + " \"" + file + "\"");
 		throw;
 	}
@@ -2680,19 +3370,7 @@ CanvasParser::parse_as(xmlpp::Element* node,String &errors)
 			Canvas::Handle canvas(parse_canvas(node,0,false,""));
 			if (!canvas) return canvas;
 
-			const ValueNodeList& value_node_list(canvas->value_node_list());
-
-			again:
-			ValueNodeList::const_iterator iter;
-			for(iter=value_node_list.begin();iter!=value_node_list.end();++iter)
-			{
-				ValueNode::Handle value_node(*iter);
-				if(value_node->is_exported() && value_node->get_id().find("Unnamed")==0)
-				{
-					canvas->remove_value_node(value_node);
-					goto again;
-				}
-			}
+			remove_unnamed_value_nodes(canvas);
 
 			return canvas;
 		}
@@ -47,7 +47,7 @@
 
 /* === C L A S S E S & S T R U C T S ======================================= */
 
-namespace xmlpp { class Node; class Element; };
+namespace xmlpp { class Node; class Element; class TextReader; };
 
 namespace synfig {
 
@@ -74,6 +74,8 @@ private:
 	String filename;
 	//! Path of the file name to parse
 	String path;
+	//! File to read the sections of deferred child canvases from, if any
+	String sections_file_;
 	//! Error text when errors found
 	String errors_text;
 	//! Warning text when warnings found
@@ -159,6 +161,15 @@ private:
 
 	//! Canvas Parsing Function
 	Canvas::Handle parse_canvas(xmlpp::Element *node,Canvas::Handle parent=0,bool inline_=false, String path=".");
+	//! Creates the canvas for a <canvas> element and applies its attributes
+	/*! \a existing is set if the element refers to a canvas which is already loaded, whose contents are then left alone */
+	Canvas::Handle parse_canvas_header(xmlpp::Element *node,Canvas::Handle parent,bool inline_,String path,bool &existing);
+	//! Parses one child element of a <canvas> into \a canvas
+	void parse_canvas_child(xmlpp::Element *node,Canvas::Handle canvas);
+	//! Checks a canvas once all of its children have been parsed
+	void parse_canvas_footer(xmlpp::Element *node,Canvas::Handle canvas);
+	//! Canvas Parsing Function reading the root canvas a child at a time, rather than from a whole document
+	Canvas::Handle parse_canvas_stream(xmlpp::TextReader &reader,String path);
 	//! Canvas definitions Parsing Function (exported value nodes and exported canvases)
 	void parse_canvas_defs(xmlpp::Element *node,Canvas::Handle canvas);
 	//! Layer Parsing Function
@@ -210,6 +221,13 @@ private:
 	//! Static option for ValueBase parsing fucntion
 	bool parse_static(xmlpp::Element *node);
 
+	//! Removes the exported value nodes whose ids were made up by the loader
+	void remove_unnamed_value_nodes(Canvas::Handle canvas);
+
+	//! Loads the child canvas of \a parent kept in section \a index of \a file
+	/*!	Used as the deferred loader of child canvases, see Canvas::set_deferred_loader() */
+	static void load_canvas_section(String file,String as,int index,Canvas::LooseHandle parent);
+
 }; // END of CanvasParser
 
 /* === E X T E R N S ======================================================= */
@@ -224,6 +242,18 @@ extern Canvas::Handle open_canvas(const String &filename,String &errors,String &
 /*!	\return	The Canvas's handle on success, an empty handle on failure */
 extern Canvas::Handle open_canvas_as(const String &filename,const String &as,String &errors,String &warnings);
 
+//!	Loads a canvas from \a filename, parsing each file only once per process
+/*!	The parsed canvas is kept in a cache until clear_canvas_cache(), and
+**	every call for the same file returns that same canvas, unless the file,
+**	or an external canvas or the image of an import layer it refers to, has
+**	been modified since it was parsed. Images whose filenames are animated
+**	or linked to exported values aren't checked. Jobs which change the
+**	canvas they render should use Canvas::render_copy().
+**	\return	The Canvas's handle on success, an empty handle on failure */
+extern Canvas::Handle open_canvas_cached(const String &filename,String &errors,String &warnings);
+//!	Lets go of every canvas kept by open_canvas_cached()
+extern void clear_canvas_cache();
+
 //! Returns the Open Canvases Map.
 //! \see open_canvas_map_
 std::map<synfig::String, etl::loose_handle<Canvas> >& get_open_canvas_map();
@@ -66,6 +66,7 @@ using namespace synfig;
 /* === M A C R O S ========================================================= */
 
 #define MODULE_LIST_FILENAME	"synfig_modules.cfg"
+#define MODULE_MANIFEST_FILENAME	"synfig_modules.manifest"
 
 /* === S T A T I C S ======================================================= */
 
@@ -270,11 +271,21 @@ synfig::Main::Main(const synfig::String& basepath,ProgressCallback *cb):
 
 	Module::register_default_modules(cb);
 
-	for(i=0,iter=modules_to_load.begin();iter!=modules_to_load.end();++iter,i++)
-	{
-		Module::Register(*iter,cb);
-		if(cb)cb->amount_complete((i+1)*100,modules_to_load.size()*100);
-	}
+	// The manifest of what the modules provide lets them be loaded on demand
+	String manifest;
+	if(getenv("SYNFIG_MODULE_MANIFEST"))
+		manifest=getenv("SYNFIG_MODULE_MANIFEST");
+	else if(getenv("HOME"))
+		manifest=strprintf("%s/.synfig/%s", getenv("HOME"), MODULE_MANIFEST_FILENAME);
+
+	if(!manifest.empty())
+		Module::register_lazily(modules_to_load,manifest,cb);
+	else
+		for(i=0,iter=modules_to_load.begin();iter!=modules_to_load.end();++iter,i++)
+		{
+			Module::Register(*iter,cb);
+			if(cb)cb->amount_complete((i+1)*100,modules_to_load.size()*100);
+		}
 
 	if(cb)cb->amount_complete(100, 100);
 	if(cb)cb->task(_("DONE"));
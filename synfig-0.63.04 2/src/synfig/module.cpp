@@ -31,7 +31,21 @@
 
 #include "module.h"
 #include "general.h"
+#include "target.h"
+#include "importer.h"
+#include "valuenode.h"
 #include <ETL/stringf>
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <errno.h>
+#include <cstdio>
+
+#ifdef HAVE_UNISTD_H
+#include <unistd.h>
+#endif
 
 #ifndef USE_CF_BUNDLES
 #include <ltdl.h>
@@ -41,6 +55,17 @@
 
 /* === M A C R O S ========================================================= */
 
+//! First word of the manifest file written by Module::register_lazily()
+#define MODULE_MANIFEST_HEADER	"synfig-module-manifest"
+
+#ifndef LT_PATHSEP_CHAR
+#define LT_PATHSEP_CHAR	':'
+#endif
+
+#ifdef _WIN32
+#define mkdir(x,y) mkdir(x)
+#endif
+
 /* === G L O B A L S ======================================================= */
 
 using namespace std;
@@ -49,8 +74,192 @@ using namespace synfig;
 
 Module::Book *synfig::Module::book_;
 
+//! Names of the entry types in the manifest, in the order of Module::EntryType
+static const char *entry_type_names[]={ "layer", "target", "target-ext", "importer", "valuenode", 0 };
+
+//! An entry of one of the books, by type and name
+typedef std::pair<int,String> Entry;
+
+//! The module that provides each entry, as read from the manifest
+typedef std::map<Entry,String> Manifest;
+
+static Manifest *manifest_;
+
+//! Modules of the manifest which haven't been loaded yet, in the order of the module list
+static std::list<String> *pending_modules_;
+
+/* === C L A S S E S ======================================================= */
+
+//! Copy of the books that modules register their entries in
+struct Inventory
+{
+	Layer::Book layers;
+	Target::Book targets;
+	Target::ExtBook target_exts;
+	Importer::Book importers;
+	LinkableValueNode::Book valuenodes;
+
+	Inventory():
+		layers(Layer::book()),
+		targets(Target::book()),
+		target_exts(Target::ext_book()),
+		importers(Importer::book()),
+		valuenodes(LinkableValueNode::book())
+	{ }
+};
+
 /* === P R O C E D U R E S ================================================= */
 
+static bool same_entry(const Layer::BookEntry &a, const Layer::BookEntry &b) { return a.factory==b.factory; }
+static bool same_entry(const Target::BookEntry &a, const Target::BookEntry &b) { return a.factory==b.factory && a.filename==b.filename; }
+static bool same_entry(const String &a, const String &b) { return a==b; }
+static bool same_entry(Importer::Factory a, Importer::Factory b) { return a==b; }
+static bool same_entry(const LinkableValueNode::BookEntry &a, const LinkableValueNode::BookEntry &b) { return a.factory==b.factory; }
+
+//! Adds to \a entries those of \a book which were added or replaced since \a before
+template < typename B >
+static void
+changed_entries(int type, const B &before, const B &book, std::list<Entry> &entries)
+{
+	for(typename B::const_iterator iter=book.begin();iter!=book.end();++iter)
+	{
+		typename B::const_iterator prev(before.find(iter->first));
+		if(prev==before.end() || !same_entry(prev->second,iter->second))
+			entries.push_back(Entry(type,iter->first));
+	}
+}
+
+//! Adds to \a entries those of all books which were added or replaced since \a before
+static void
+changed_entries(const Inventory &before, std::list<Entry> &entries)
+{
+	changed_entries(Module::ENTRY_LAYER,before.layers,Layer::book(),entries);
+	changed_entries(Module::ENTRY_TARGET,before.targets,Target::book(),entries);
+	changed_entries(Module::ENTRY_TARGET_EXT,before.target_exts,Target::ext_book(),entries);
+	changed_entries(Module::ENTRY_IMPORTER,before.importers,Importer::book(),entries);
+	changed_entries(Module::ENTRY_VALUENODE,before.valuenodes,LinkableValueNode::book(),entries);
+}
+
+//! Puts the entry \a name of \a book back the way it was in \a before
+template < typename B >
+static void
+restore_entry(B &book, const B &before, const String &name)
+{
+	typename B::const_iterator iter(before.find(name));
+	if(iter==before.end())
+		book.erase(name);
+	else
+		book[name]=iter->second;
+}
+
+static void
+restore_entry(const Inventory &before, const Entry &entry)
+{
+	switch(entry.first)
+	{
+	case Module::ENTRY_LAYER:		restore_entry(Layer::book(),before.layers,entry.second); break;
+	case Module::ENTRY_TARGET:		restore_entry(Target::book(),before.targets,entry.second); break;
+	case Module::ENTRY_TARGET_EXT:	restore_entry(Target::ext_book(),before.target_exts,entry.second); break;
+	case Module::ENTRY_IMPORTER:	restore_entry(Importer::book(),before.importers,entry.second); break;
+	case Module::ENTRY_VALUENODE:	restore_entry(LinkableValueNode::book(),before.valuenodes,entry.second); break;
+	}
+}
+
+//! Returns the modification time of the file that lt_dlopenext() would load for \a module_name, or 0
+static time_t
+module_file_time(const String &module_name)
+{
+#ifndef USE_CF_BUNDLES
+	static const char *prefixes[]={ "lib", "", 0 };
+	static const char *extensions[]={ ".la", ".so", ".dylib", ".dll", 0 };
+
+	const char *path(lt_dlgetsearchpath());
+	if(!path)
+		return 0;
+
+	std::vector<String> dirs;
+	String search(path);
+	String::size_type begin(0), end;
+	for(;(end=search.find(LT_PATHSEP_CHAR,begin))!=String::npos;begin=end+1)
+		dirs.push_back(String(search,begin,end-begin));
+	dirs.push_back(String(search,begin));
+
+	struct stat buf;
+	for(int i=0;prefixes[i];i++)
+		for(int j=0;extensions[j];j++)
+			for(std::vector<String>::iterator iter=dirs.begin();iter!=dirs.end();++iter)
+				if(!iter->empty() && stat((*iter+"/"+prefixes[i]+module_name+extensions[j]).c_str(),&buf)==0)
+					return buf.st_mtime;
+#endif
+	return 0;
+}
+
+//! Reads the manifest \a filename into \a manifest
+/*!	\return \c false if it can't be read, or it was written by another
+**	version of synfig, for another list of modules, or before any of the
+**	modules were changed. */
+static bool
+read_manifest(const String &filename, const std::list<String> &module_list, Manifest &manifest)
+{
+	std::ifstream file(filename.c_str());
+	if(!file)
+		return false;
+
+	String line;
+	if(!getline(file,line) || line!=strprintf("%s %s",MODULE_MANIFEST_HEADER,get_version()))
+		return false;
+
+	std::list<String> modules;
+	while(getline(file,line))
+	{
+		std::istringstream stream(line);
+		String type, module_name, name;
+		if(!(stream>>type>>module_name))
+			continue;
+
+		if(type=="module")
+		{
+			long time;
+			if(!(stream>>time) || time!=(long)module_file_time(module_name))
+				return false;
+			modules.push_back(module_name);
+			continue;
+		}
+
+		int i;
+		for(i=0;entry_type_names[i] && type!=entry_type_names[i];i++);
+		if(!entry_type_names[i] || !(stream>>name))
+			return false;
+
+		manifest[Entry(i,name)]=module_name;
+	}
+
+	return modules==module_list;
+}
+
+//! Loads \a module_name for Module::request() or Module::load_pending()
+static bool
+load_lazily(String module_name, ProgressCallback *callback)
+{
+	pending_modules_->remove(module_name);
+
+	Inventory before;
+	if(!Module::Register(module_name,callback))
+		return false;
+
+	// When several modules provide the same entry, the one loaded last
+	// from the module list gets it, and the manifest says which one that is
+	std::list<Entry> entries;
+	changed_entries(before,entries);
+	for(std::list<Entry>::iterator iter=entries.begin();iter!=entries.end();++iter)
+	{
+		Manifest::const_iterator owner(manifest_->find(*iter));
+		if(owner!=manifest_->end() && owner->second!=module_name)
+			restore_entry(before,*iter);
+	}
+	return true;
+}
+
 bool
 Module::subsys_init(const String &prefix)
 {
@@ -80,12 +289,18 @@ Module::subsys_init(const String &prefix)
 	lt_dladdsearchdir(".");
 #endif
 	book_=new Book;
+	manifest_=new Manifest;
+	pending_modules_=new std::list<String>;
 	return true;
 }
 
 bool
 Module::subsys_stop()
 {
+	delete pending_modules_;
+	pending_modules_=0;
+	delete manifest_;
+	manifest_=0;
 	delete book_;
 
 #ifndef USE_CF_BUNDLES
@@ -190,3 +405,88 @@ synfig::Module::Register(const String &module_name, ProgressCallback *callback)
 #endif
 	return true;
 }
+
+void
+synfig::Module::register_lazily(const std::list<String> &module_list, const String &manifest, ProgressCallback *callback)
+{
+	Manifest entries;
+	if(read_manifest(manifest,module_list,entries))
+	{
+		manifest_->swap(entries);
+		pending_modules_->assign(module_list.begin(),module_list.end());
+		synfig::info(_("Loading modules on demand, as listed in %s"), manifest.c_str());
+		return;
+	}
+
+	std::ostringstream out;
+	out<<MODULE_MANIFEST_HEADER<<' '<<get_version()<<endl;
+
+	int i(0);
+	for(std::list<String>::const_iterator iter=module_list.begin();iter!=module_list.end();++iter)
+	{
+		Inventory before;
+		Register(*iter,callback);
+
+		std::list<Entry> changes;
+		changed_entries(before,changes);
+
+		out<<"module "<<*iter<<' '<<(long)module_file_time(*iter)<<endl;
+		for(std::list<Entry>::iterator entry=changes.begin();entry!=changes.end();++entry)
+			out<<entry_type_names[entry->first]<<' '<<*iter<<' '<<entry->second<<endl;
+
+		if(callback)callback->amount_complete(++i*100,module_list.size()*100);
+	}
+
+	// The manifest usually lives in ~/.synfig, which only
+	// synfigstudio creates, so it may not be there yet
+	const String directory(etl::dirname(manifest));
+	if(mkdir(directory.c_str(),ACCESSPERMS)==0)
+		synfig::info("Created directory \"%s\"",directory.c_str());
+
+	// Other processes, such as the workers of a split render, may be
+	// reading the manifest right now, so it is written to a file of
+	// our own and only then renamed over the old one. Without a
+	// manifest the modules are just all loaded again next time.
+	const String tmp_manifest(strprintf("%s.%d.TMP",manifest.c_str(),(int)getpid()));
+	std::ofstream file(tmp_manifest.c_str());
+	file<<out.str();
+	file.close();
+	if(!file)
+	{
+		synfig::info(_("Unable to write module manifest '%s', errno=%d"), tmp_manifest.c_str(), errno);
+		remove(tmp_manifest.c_str());
+		return;
+	}
+#ifdef _WIN32
+	// rename() won't replace an existing file here
+	remove(manifest.c_str());
+#endif
+	if(rename(tmp_manifest.c_str(),manifest.c_str())!=0)
+	{
+		synfig::info(_("Unable to write module manifest '%s', errno=%d"), manifest.c_str(), errno);
+		remove(tmp_manifest.c_str());
+	}
+}
+
+bool
+synfig::Module::request(EntryType type, const String &name)
+{
+	if(!pending_modules_ || pending_modules_->empty())
+		return false;
+
+	Manifest::const_iterator iter(manifest_->find(Entry(type,name)));
+	if(iter==manifest_->end() || find(pending_modules_->begin(),pending_modules_->end(),iter->second)==pending_modules_->end())
+		return false;
+
+	return load_lazily(iter->second,0);
+}
+
+void
+synfig::Module::load_pending(ProgressCallback *callback)
+{
+	if(!pending_modules_)
+		return;
+
+	while(!pending_modules_->empty())
+		load_lazily(pending_modules_->front(),callback);
+}
@@ -31,6 +31,7 @@
 #include "general.h"
 #include <ETL/handle>
 #include <map>
+#include <list>
 #include "string.h"
 #include "releases.h"
 #include <utility>
@@ -209,6 +210,34 @@ public:
 	//!Register Module by instance pointer
 	static inline void Register(Module *mod) { Register(Handle(mod)); }
 
+	//! Types of the entries that modules put in the books of synfig
+	enum EntryType
+	{
+		ENTRY_LAYER,		//!< Layer::book()
+		ENTRY_TARGET,		//!< Target::book()
+		ENTRY_TARGET_EXT,	//!< Target::ext_book()
+		ENTRY_IMPORTER,		//!< Importer::book()
+		ENTRY_VALUENODE		//!< LinkableValueNode::book()
+	};
+
+	//! Register Modules by name, loading each one only once it is needed
+	/*!	The entries that every module puts in the books are kept in the
+	**	manifest file \a manifest. If the manifest is up to date with the
+	**	files of the modules, none of them is loaded here, and each one is
+	**	loaded by request() when one of its entries is first looked up.
+	**	Otherwise they are all loaded at once and the manifest is written
+	**	anew from what they register. */
+	static void register_lazily(const std::list<String> &module_list, const String &manifest, ProgressCallback *cb=NULL);
+
+	//! Loads the module providing the entry \a name of the given type, if it hasn't been loaded yet
+	/*!	Only to be called from the main thread, since loading a module changes the books.
+	**	\return \c true if a module was loaded */
+	static bool request(EntryType type, const String &name);
+
+	//! Loads all of the modules that are still waiting for a request()
+	/*!	Needed before a book is listed as a whole */
+	static void load_pending(ProgressCallback *cb=NULL);
+
 	//! Virtual Modules properties wrappers. Must be defined in the modules classes
 	virtual const char * Name() { return " "; }
 	virtual const char * Desc() { return " "; }
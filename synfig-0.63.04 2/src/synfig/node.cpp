@@ -169,6 +169,8 @@ TimePointSet::insert(const TimePoint& x)
 Node::Node():
 	guid_(0),
 	bchanged(true),
+	time_dependent_(true),
+	btime_dependent_changed(true),
 	time_last_changed_(__sys_clock()),
 	deleting_(false)
 {
@@ -279,6 +281,24 @@ Node::get_times() const
 	return times;
 }
 
+bool
+Node::is_time_dependent() const
+{
+	if(btime_dependent_changed)
+	{
+		time_dependent_ = is_time_dependent_vfunc();
+		btime_dependent_changed = false;
+	}
+
+	return time_dependent_;
+}
+
+bool
+Node::is_time_dependent_vfunc() const
+{
+	return true;
+}
+
 void
 Node::begin_delete()
 {
@@ -292,6 +312,7 @@ void
 Node::on_changed()
 {
 	bchanged = true;
+	btime_dependent_changed = true;
 	signal_changed()();
 
 	std::set<Node*>::iterator iter;
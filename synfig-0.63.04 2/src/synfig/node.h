@@ -149,6 +149,12 @@ private:
 	//! \writeme
 	mutable bool		bchanged;
 
+	//! cached result of is_time_dependent_vfunc()
+	mutable bool		time_dependent_;
+
+	//! \c true when time_dependent_ has to be recomputed
+	mutable bool		btime_dependent_changed;
+
 	//! The last time the node was modified since the program started
 	//! \see __sys_clock
 	mutable int time_last_changed_;
@@ -240,6 +246,11 @@ public:
 	//! Returns the cached times values for all the children
 	const time_set &get_times() const;
 
+	//! Returns \c true if the node may evaluate differently at different times
+	/*!	The result is cached until the node or one of its children changes.
+	**	\see is_time_dependent_vfunc() */
+	bool is_time_dependent() const;
+
 	//! Writeme!
 	RWLock& get_rw_lock()const { return rw_lock_; }
 
@@ -265,6 +276,10 @@ protected:
 	//!	Function to be overloaded that fills the Time Point Set with
 	//! all the children Time Points.
 	virtual void get_times_vfunc(time_set &set) const = 0;
+
+	//!	Function to be overloaded that tells whether the node, including
+	//! all its children, may change over time. Defaults to \c true.
+	virtual bool is_time_dependent_vfunc() const;
 }; // End of Node class
 
 //! Finds a node by its GUID.
@@ -0,0 +1,133 @@
+/* === S Y N F I G ========================================================= */
+/*!	\file parallel.cpp
+**	\brief Splitting of row by row work between threads
+**
+**	$Id$
+**
+**	\legal
+**	This package is free software; you can redistribute it and/or
+**	modify it under the terms of the GNU General Public License as
+**	published by the Free Software Foundation; either version 2 of
+**	the License, or (at your option) any later version.
+**
+**	This package is distributed in the hope that it will be useful,
+**	but WITHOUT ANY WARRANTY; without even the implied warranty of
+**	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+**	General Public License for more details.
+**	\endlegal
+*/
+/* ========================================================================= */
+
+/* === H E A D E R S ======================================================= */
+
+#ifdef USING_PCH
+#	include "pch.h"
+#else
+#ifdef HAVE_CONFIG_H
+#	include <config.h>
+#endif
+
+#include "parallel.h"
+
+#include <algorithm>
+#include <vector>
+#include <cstdlib>
+
+#ifdef HAVE_UNISTD_H
+#include <unistd.h>
+#endif
+
+#ifdef HAVE_LIBPTHREAD
+#include <pthread.h>
+#endif
+
+#endif
+
+/* === U S I N G =========================================================== */
+
+using namespace synfig;
+
+/* === M A C R O S ========================================================= */
+
+//! Most threads parallel_rows() ever starts
+#define MAX_ROW_THREADS		16
+
+/* === G L O B A L S ======================================================= */
+
+/* === P R O C E D U R E S ================================================= */
+
+namespace {
+
+//! A range of rows of a task, handed to a thread
+struct RowRange
+{
+	RowTask *task;
+	int begin, end;
+};
+
+void *
+run_range(void *data)
+{
+	RowRange *range(static_cast<RowRange*>(data));
+	range->task->rows(range->begin,range->end);
+	return 0;
+}
+
+}; // END of anonymous namespace
+
+int
+synfig::get_row_threads()
+{
+	// SYNFIG_ROW_THREADS overrides the number of processors,
+	// 1 turns the threads off
+	if(const char *value=getenv("SYNFIG_ROW_THREADS"))
+		return std::max(1,std::min(atoi(value),MAX_ROW_THREADS));
+
+#if defined(HAVE_UNISTD_H) && defined(_SC_NPROCESSORS_ONLN)
+	const long processors(sysconf(_SC_NPROCESSORS_ONLN));
+	if(processors>1)
+		return std::min((int)processors,MAX_ROW_THREADS);
+#endif
+	return 1;
+}
+
+void
+synfig::parallel_rows(RowTask &task, int count, int min_rows)
+{
+	const int threads(std::min(get_row_threads(),count/std::max(1,min_rows)));
+
+#ifdef HAVE_LIBPTHREAD
+	if(threads>1)
+	{
+		std::vector<RowRange> ranges(threads);
+		std::vector<pthread_t> pool;
+		int i;
+
+		for(i=0;i<threads;i++)
+		{
+			ranges[i].task=&task;
+			ranges[i].begin=count*i/threads;
+			ranges[i].end=count*(i+1)/threads;
+		}
+
+		// A range that can't get a thread of its own is done right away
+		for(i=1;i<threads;i++)
+		{
+			pthread_t thread;
+			if(pthread_create(&thread,NULL,&run_range,&ranges[i])==0)
+				pool.push_back(thread);
+			else
+				run_range(&ranges[i]);
+		}
+
+		run_range(&ranges[0]);
+
+		for(std::vector<pthread_t>::iterator iter=pool.begin();iter!=pool.end();++iter)
+			pthread_join(*iter,NULL);
+		return;
+	}
+#endif
+
+	if(count>0)
+		task.rows(0,count);
+}
@@ -0,0 +1,63 @@
+/* === S Y N F I G ========================================================= */
+/*!	\file parallel.h
+**	\brief Splitting of row by row work between threads
+**
+**	$Id$
+**
+**	\legal
+**	This package is free software; you can redistribute it and/or
+**	modify it under the terms of the GNU General Public License as
+**	published by the Free Software Foundation; either version 2 of
+**	the License, or (at your option) any later version.
+**
+**	This package is distributed in the hope that it will be useful,
+**	but WITHOUT ANY WARRANTY; without even the implied warranty of
+**	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+**	General Public License for more details.
+**	\endlegal
+*/
+/* ========================================================================= */
+
+/* === S T A R T =========================================================== */
+
+#ifndef __SYNFIG_PARALLEL_H
+#define __SYNFIG_PARALLEL_H
+
+/* === H E A D E R S ======================================================= */
+
+/* === M A C R O S ========================================================= */
+
+/* === T Y P E D E F S ===================================================== */
+
+/* === C L A S S E S & S T R U C T S ======================================= */
+
+namespace synfig {
+
+//! Work made up of rows which don't depend on each other
+/*!	rows() is called from several threads at once, for ranges of rows
+**	which don't overlap. It must only write to its own rows, must not
+**	throw, and must not touch anything else that isn't thread safe,
+**	such as handles, contexts or progress callbacks. */
+class RowTask
+{
+public:
+	virtual ~RowTask() { }
+
+	//! Does the work for the rows from \a begin up to, but not including, \a end
+	virtual void rows(int begin, int end)=0;
+};
+
+//! Returns the number of threads parallel_rows() splits work between
+int get_row_threads();
+
+//! Runs \a task over the rows from 0 up to \a count, split between threads
+/*!	Every thread gets at least \a min_rows rows, and the calling thread
+**	takes one of the ranges itself. Returns once every row is done.
+**	Without thread support the rows are all done on the calling thread. */
+void parallel_rows(RowTask &task, int count, int min_rows=16);
+
+}; // END of namespace synfig
+
+/* === E N D =============================================================== */
+
+#endif
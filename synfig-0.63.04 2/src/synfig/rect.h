@@ -95,7 +95,7 @@ public:
 	Point get_min()const { return Point(minx,miny); }
 	Point get_max()const { return Point(maxx,maxy); }
 
-	bool is_inside(const Point& x) { return x[0]>minx && x[0]<maxx && x[1]>miny && x[1]<maxy; }
+	bool is_inside(const Point& x)const { return x[0]>minx && x[0]<maxx && x[1]>miny && x[1]<maxy; }
 
 	Real area()const
 	{
@@ -51,16 +51,30 @@
 #include "layer.h"
 #include "string.h"
 #include "paramdesc.h"
+#include "mutex.h"
 
 #include <libxml++/libxml++.h>
 #include <ETL/stringf>
 #include "gradient.h"
 #include <errno.h>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+#include <deque>
+#include <set>
+
+#ifdef HAVE_LIBPTHREAD
+#include <pthread.h>
+#endif
 
 extern "C" {
 #include <libxml/tree.h>
+#include <libxml/parser.h>
+#include <libxml/xmlIO.h>
 }
 
+#include <zlib.h>
+
 #endif
 
 /* === U S I N G =========================================================== */
@@ -81,6 +95,89 @@ using namespace synfig;
 ReleaseVersion save_canvas_version = ReleaseVersion(RELEASE_VERSION_END-1);
 int valuenode_too_new_count;
 
+//! When set, exported canvases are encoded into these sections instead of their parent's <defs>
+static std::vector<String> *canvas_sections;
+
+//! Writes the XML of the root canvas to an output buffer while it is being encoded
+/*!	Every child of the root and of its \c <defs> is written out and freed
+**	as soon as the next one is started, so that only one layer or exported
+**	value of the document is held in memory at a time. */
+class CanvasStream
+{
+	xmlOutputBufferPtr out_;
+	xmlpp::Element *root_;
+	//! Elements whose start tags have been written, innermost last
+	std::vector<xmlpp::Element*> open_;
+
+	void indent(int depth)
+	{
+		for(int i=0;i<depth;i++)
+			xmlOutputBufferWriteString(out_,"  ");
+	}
+
+	void open(xmlpp::Element *element)
+	{
+		// dump the element without its children, which
+		// gives <name .../>, and leave the tag open
+		xmlBufferPtr buffer(xmlBufferCreate());
+		xmlNodePtr copy(xmlCopyNode(element->cobj(),2));
+		xmlNodeDump(buffer,element->cobj()->doc,copy,0,0);
+		xmlFreeNode(copy);
+		String tag((const char*)xmlBufferContent(buffer),xmlBufferLength(buffer));
+		xmlBufferFree(buffer);
+		if(tag.size()>=2 && tag.compare(tag.size()-2,2,"/>")==0)
+			tag.replace(tag.size()-2,2,">");
+
+		indent(open_.size());
+		xmlOutputBufferWriteString(out_,tag.c_str());
+		xmlOutputBufferWriteString(out_,"\n");
+		open_.push_back(element);
+	}
+
+public:
+	CanvasStream(xmlOutputBufferPtr out, xmlpp::Element *root):
+		out_(out),
+		root_(root)
+	{
+		xmlOutputBufferWriteString(out_,"<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n");
+	}
+
+	xmlpp::Element *root()const { return root_; }
+
+	//! Writes out and frees the children of \a element encoded so far
+	/*!	\a element must be the root or a child of the last element flushed */
+	void flush(xmlpp::Element *element)
+	{
+		if(open_.empty() || open_.back()!=element)
+			open(element);
+
+		xmlpp::Node::NodeList list(element->get_children());
+		for(xmlpp::Node::NodeList::iterator iter=list.begin();iter!=list.end();++iter)
+		{
+			indent(open_.size());
+			xmlNodeDumpOutput(out_,element->cobj()->doc,(*iter)->cobj(),open_.size(),1,"UTF-8");
+			xmlOutputBufferWriteString(out_,"\n");
+			element->remove_child(*iter);
+		}
+	}
+
+	//! Writes out the rest of \a element and its end tag, and frees it
+	void close(xmlpp::Element *element)
+	{
+		flush(element);
+		open_.pop_back();
+
+		indent(open_.size());
+		xmlOutputBufferWriteString(out_,("</"+element->get_name()+">\n").c_str());
+
+		if(element->get_parent())
+			element->get_parent()->remove_child(element);
+	}
+};
+
+//! When set, the canvas encoded into its root is written out as it goes
+static CanvasStream *canvas_stream;
+
 /* === P R O C E D U R E S ================================================= */
 
 xmlpp::Element* encode_canvas(xmlpp::Element* root,Canvas::ConstHandle canvas);
@@ -636,12 +733,29 @@ xmlpp::Element* encode_layer(xmlpp::Element* root,Layer::ConstHandle layer)
 	return root;
 }
 
+//! Encodes \a canvas into a section of its own, returning the index of the section
+int encode_canvas_section(Canvas::ConstHandle canvas)
+{
+	// reserve the index first, since the canvas' own children
+	// are given the sections that follow it
+	const int index(canvas_sections->size());
+	canvas_sections->push_back(String());
+
+	xmlpp::Document document;
+	encode_canvas(document.create_root_node("canvas"),canvas);
+	(*canvas_sections)[index]=document.write_to_string();
+
+	return index;
+}
+
 xmlpp::Element* encode_canvas(xmlpp::Element* root,Canvas::ConstHandle canvas)
 {
 	assert(canvas);
 	const RendDesc &rend_desc=canvas->rend_desc();
 	root->set_name("canvas");
 
+	const bool streaming(canvas_stream && canvas_stream->root()==root);
+
 	if(canvas->is_root())
 		root->set_attribute("version",canvas->get_version());
 
@@ -711,6 +825,9 @@ xmlpp::Element* encode_canvas(xmlpp::Element* root,Canvas::ConstHandle canvas)
 			encode_keyframe(root->add_child("keyframe"),*iter,canvas->rend_desc().get_frame_rate());
 	}
 
+	if(streaming)
+		canvas_stream->flush(root);
+
 	// Output the <defs> section
 	//! Check where the parentheses should really go - around the && or the ||?
 	//! If children is not empty (there are exported canvases in the current canvas)
@@ -724,6 +841,9 @@ xmlpp::Element* encode_canvas(xmlpp::Element* root,Canvas::ConstHandle canvas)
 
 		for(ValueNodeList::const_iterator iter=value_node_list.begin();iter!=value_node_list.end();++iter)
 		{
+			if(streaming)
+				canvas_stream->flush(node);
+
 			// If the value_node is a constant, then use the shorthand
 			if(handle<ValueNode_Const>::cast_dynamic(*iter))
 			{
@@ -737,14 +857,39 @@ xmlpp::Element* encode_canvas(xmlpp::Element* root,Canvas::ConstHandle canvas)
 
 		for(Canvas::Children::const_iterator iter=canvas->children().begin();iter!=canvas->children().end();++iter)
 		{
+			if(streaming)
+				canvas_stream->flush(node);
+
+			// A child that was never looked at still has to be written out in full
+			(*iter)->load_deferred();
+
+			// Only exported children get sections, inline canvases are
+			// written along with their layers, see CANVAS_SECTIONS_EXTENSION
+			if(canvas_sections)
+			{
+				xmlpp::Element *stub(node->add_child("canvas"));
+				stub->set_attribute("id",(*iter)->get_id());
+				stub->set_attribute("section",strprintf("%d",encode_canvas_section(*iter)));
+				continue;
+			}
 			encode_canvas(node->add_child("canvas"),*iter);
 		}
+
+		if(streaming)
+			canvas_stream->close(node);
 	}
 
 	Canvas::const_reverse_iterator iter;
 
 	for(iter=canvas->rbegin();iter!=canvas->rend();++iter)
+	{
+		if(streaming)
+			canvas_stream->flush(root);
 		encode_layer(root->add_child("layer"),*iter);
+	}
+
+	if(streaming)
+		canvas_stream->close(root);
 
 	return root;
 }
@@ -761,6 +906,213 @@ xmlpp::Element* encode_canvas_toplevel(xmlpp::Element* root,Canvas::ConstHandle
 	return ret;
 }
 
+static void
+append_le32(String &data, unsigned int x)
+{
+	data+=(char)(x&0xff);
+	data+=(char)((x>>8)&0xff);
+	data+=(char)((x>>16)&0xff);
+	data+=(char)((x>>24)&0xff);
+}
+
+static bool
+read_le32(FILE *file, unsigned int &x)
+{
+	unsigned char bytes[4];
+	if(fread(bytes,1,4,file)!=4)
+		return false;
+	x=bytes[0]|(bytes[1]<<8)|(bytes[2]<<16)|((unsigned int)bytes[3]<<24);
+	return true;
+}
+
+//! Encodes \a canvas into the XML of its sections, see CANVAS_SECTIONS_EXTENSION
+static void
+encode_canvas_sections(Canvas::ConstHandle canvas, std::vector<String> &sections)
+{
+	sections.assign(1,String());
+	canvas_sections=&sections;
+	try
+	{
+		xmlpp::Document document;
+		encode_canvas_toplevel(document.create_root_node("canvas"),canvas);
+		sections[0]=document.write_to_string();
+	}
+	catch(...) { canvas_sections=0; throw; }
+	canvas_sections=0;
+}
+
+//! Compresses the XML of \a sections into the contents of a file of sections
+/*!	\return	\c false if a section couldn't be compressed */
+static bool
+pack_canvas_sections(const std::vector<String> &sections, String &data)
+{
+	std::vector<String> packed(sections.size());
+	for(unsigned int i=0;i<sections.size();i++)
+	{
+		uLongf size(compressBound(sections[i].size()));
+		append_le32(packed[i],sections[i].size());
+		packed[i].resize(4+size);
+		if(compress2((Bytef*)&packed[i][4],&size,(const Bytef*)sections[i].data(),sections[i].size(),Z_DEFAULT_COMPRESSION)!=Z_OK)
+		{
+			synfig::error("synfig::save_canvas(): Unable to compress section %d",i);
+			return false;
+		}
+		packed[i].resize(4+size);
+	}
+
+	data="SIFB";
+	append_le32(data,CANVAS_SECTIONS_VERSION);
+	append_le32(data,packed.size());
+
+	unsigned int offset(12+8*packed.size());
+	for(std::vector<String>::const_iterator iter=packed.begin();iter!=packed.end();++iter)
+	{
+		append_le32(data,offset);
+		append_le32(data,iter->size());
+		offset+=iter->size();
+	}
+	for(std::vector<String>::const_iterator iter=packed.begin();iter!=packed.end();++iter)
+		data+=*iter;
+
+	return true;
+}
+
+//! Encodes \a canvas into \a out, writing out each part as soon as it is encoded
+static void
+write_canvas_stream(xmlOutputBufferPtr out, Canvas::ConstHandle canvas)
+{
+	xmlpp::Document document;
+	CanvasStream stream(out,document.create_root_node("canvas"));
+
+	canvas_stream=&stream;
+	try
+	{
+		encode_canvas_toplevel(stream.root(),canvas);
+	}
+	catch(...) { canvas_stream=0; throw; }
+	canvas_stream=0;
+}
+
+static int
+append_to_string(void *context, const char *buffer, int len)
+{
+	static_cast<String*>(context)->append(buffer,len);
+	return len;
+}
+
+//! Encodes \a canvas into a string, without building the whole document first
+static String
+encode_canvas_stream(Canvas::ConstHandle canvas)
+{
+	String data;
+	xmlOutputBufferPtr out(xmlOutputBufferCreateIO(&append_to_string,NULL,&data,NULL));
+	try
+	{
+		write_canvas_stream(out,canvas);
+	}
+	catch(...) { xmlOutputBufferClose(out); throw; }
+	xmlOutputBufferClose(out);
+	return data;
+}
+
+//! Returns the gzip compression level to write \a filename with
+static int
+canvas_compression(const String &filename)
+{
+	return filename_extension(filename) == ".sifz" ? 9 : 0;
+}
+
+//! Puts \a tmp_filename, which has just been written, in place of \a filename
+static bool
+replace_canvas_file(const String &tmp_filename, const String &filename)
+{
+#ifdef _WIN32
+	// On Win32 platforms, rename() has bad behavior. work around it.
+	char old_file[80]="sif.XXXXXXXX";
+	mktemp(old_file);
+	rename(filename.c_str(),old_file);
+	if(rename(tmp_filename.c_str(),filename.c_str())!=0)
+	{
+		rename(old_file,tmp_filename.c_str());
+		synfig::error("synfig::save_canvas(): Unable to rename file to correct filename, errno=%d",errno);
+		return false;
+	}
+	remove(old_file);
+#else
+	if(rename(tmp_filename.c_str(),filename.c_str())!=0)
+	{
+		synfig::error("synfig::save_canvas(): Unable to rename file to correct filename, errno=%d",errno);
+		return false;
+	}
+#endif
+	return true;
+}
+
+//! Writes the encoded canvas \a data to \a filename, compressing it as asked
+static bool
+write_canvas_file(const String &filename, const String &data, int compression)
+{
+	synfig::String tmp_filename(filename+".TMP");
+
+	xmlOutputBufferPtr out(xmlOutputBufferCreateFilename(tmp_filename.c_str(),NULL,compression));
+	if(!out)
+	{
+		synfig::error("synfig::save_canvas(): Unable to open %s for writing, errno=%d",tmp_filename.c_str(),errno);
+		return false;
+	}
+
+	const bool written(xmlOutputBufferWrite(out,data.size(),data.data())>=0);
+	if(xmlOutputBufferClose(out)<0 || !written)
+	{
+		synfig::error("synfig::save_canvas(): Unable to write %s",tmp_filename.c_str());
+		return false;
+	}
+
+	return replace_canvas_file(tmp_filename,filename);
+}
+
+bool
+synfig::read_canvas_section(const String &filename, int index, String &text)
+{
+	FILE *file(fopen(filename.c_str(),"rb"));
+	if(!file)
+		return false;
+
+	char magic[4];
+	unsigned int version, count, offset, size;
+	bool ok(fread(magic,1,4,file)==4 && memcmp(magic,"SIFB",4)==0 &&
+			read_le32(file,version) && version<=CANVAS_SECTIONS_VERSION &&
+			read_le32(file,count) && index>=0 && (unsigned int)index<count &&
+			fseek(file,12+8*index,SEEK_SET)==0 &&
+			read_le32(file,offset) && read_le32(file,size) &&
+			fseek(file,offset,SEEK_SET)==0);
+
+	String data;
+	if(ok)
+	{
+		data.resize(size);
+		ok=(size==0 || fread(&data[0],1,size,file)==size);
+	}
+	fclose(file);
+	if(!ok)
+		return false;
+
+	// Sections were stored as plain XML before version 2
+	if(version<2)
+	{
+		text.swap(data);
+		return true;
+	}
+
+	const unsigned char *bytes((const unsigned char*)data.data());
+	if(size<4)
+		return false;
+	uLongf length(bytes[0]|(bytes[1]<<8)|(bytes[2]<<16)|((unsigned int)bytes[3]<<24));
+	text.resize(length);
+	return length==0 ||
+		(uncompress((Bytef*)&text[0],&length,bytes+4,size-4)==Z_OK && length==text.size());
+}
+
 bool
 synfig::save_canvas(const String &filename, Canvas::ConstHandle canvas)
 {
@@ -768,43 +1120,202 @@ synfig::save_canvas(const String &filename, Canvas::ConstHandle canvas)
 
 	synfig::String tmp_filename(filename+".TMP");
 
-	if (filename_extension(filename) == ".sifz")
-		xmlSetCompressMode(9);
-	else
-		xmlSetCompressMode(0);
-
 	try
 	{
 		assert(canvas);
-		xmlpp::Document document;
+		if (filename_extension(filename) == CANVAS_SECTIONS_EXTENSION)
+		{
+			std::vector<String> sections;
+			String data;
+			encode_canvas_sections(canvas,sections);
+			return pack_canvas_sections(sections,data) && write_canvas_file(filename,data,0);
+		}
 
-		encode_canvas_toplevel(document.create_root_node("canvas"),canvas);
+		xmlOutputBufferPtr out(xmlOutputBufferCreateFilename(tmp_filename.c_str(),NULL,canvas_compression(filename)));
+		if(!out)
+		{
+			synfig::error("synfig::save_canvas(): Unable to open %s for writing, errno=%d",tmp_filename.c_str(),errno);
+			return false;
+		}
 
-		document.write_to_file_formatted(tmp_filename);
+		try
+		{
+			write_canvas_stream(out,canvas);
+		}
+		catch(...) { xmlOutputBufferClose(out); remove(tmp_filename.c_str()); throw; }
 
-#ifdef _WIN32
-		// On Win32 platforms, rename() has bad behavior. work around it.
-		char old_file[80]="sif.XXXXXXXX";
-		mktemp(old_file);
-		rename(filename.c_str(),old_file);
-		if(rename(tmp_filename.c_str(),filename.c_str())!=0)
+		if(xmlOutputBufferClose(out)<0)
 		{
-			rename(old_file,tmp_filename.c_str());
-			synfig::error("synfig::save_canvas(): Unable to rename file to correct filename, errno=%d",errno);
+			synfig::error("synfig::save_canvas(): Unable to write %s",tmp_filename.c_str());
 			return false;
 		}
-		remove(old_file);
-#else
-		if(rename(tmp_filename.c_str(),filename.c_str())!=0)
+
+		return replace_canvas_file(tmp_filename,filename);
+	}
+	catch(...) { synfig::error("synfig::save_canvas(): Caught unknown exception"); return false; }
+}
+
+#ifdef HAVE_LIBPTHREAD
+//! A canvas which has been encoded, waiting to be written to its file
+struct PendingSave
+{
+	String filename;
+	String data;
+	//! The XML of each section of a CANVAS_SECTIONS_EXTENSION file, still to be compressed into \a data
+	std::vector<String> sections;
+	int compression;
+};
+
+static Mutex save_mutex;
+static std::deque<PendingSave> pending_saves;
+static pthread_t save_thread;
+//! \c true while the thread is taking saves off the queue
+static bool save_thread_running;
+//! \c true if the thread has been started and not joined yet
+static bool save_thread_joinable;
+//! The files which couldn't be written, until wait_for_save() is asked about them
+static std::set<String> failed_saves;
+
+static void *
+write_pending_saves(void *)
+{
+	for(;;)
+	{
+		PendingSave save;
+
 		{
-			synfig::error("synfig::save_canvas(): Unable to rename file to correct filename, errno=%d",errno);
-			return false;
+			Mutex::Lock lock(save_mutex);
+			if(pending_saves.empty())
+			{
+				save_thread_running=false;
+				return NULL;
+			}
+			save.filename.swap(pending_saves.front().filename);
+			save.data.swap(pending_saves.front().data);
+			save.sections.swap(pending_saves.front().sections);
+			save.compression=pending_saves.front().compression;
+			pending_saves.pop_front();
+		}
+
+		if((!save.sections.empty() && !pack_canvas_sections(save.sections,save.data)) ||
+		   !write_canvas_file(save.filename,save.data,save.compression))
+		{
+			Mutex::Lock lock(save_mutex);
+			failed_saves.insert(save.filename);
 		}
+	}
+}
 #endif
+
+bool
+synfig::save_canvas_in_background(const String &filename, Canvas::ConstHandle canvas)
+{
+	ChangeLocale change_locale(LC_NUMERIC, "C");
+
+	String data;
+	std::vector<String> sections;
+	try
+	{
+		assert(canvas);
+		if (filename_extension(filename) == CANVAS_SECTIONS_EXTENSION)
+			encode_canvas_sections(canvas,sections);
+		else
+			data=encode_canvas_stream(canvas);
 	}
-	catch(...) { synfig::error("synfig::save_canvas(): Caught unknown exception"); return false; }
+	catch(...) { synfig::error("synfig::save_canvas_in_background(): Caught unknown exception"); return false; }
+
+	const int compression(canvas_compression(filename));
+
+#ifdef HAVE_LIBPTHREAD
+	// libxml2 must be set up before it is used from another thread
+	xmlInitParser();
 
+	bool started(true);
+	{
+		Mutex::Lock lock(save_mutex);
+		pending_saves.push_back(PendingSave());
+		pending_saves.back().filename=filename;
+		pending_saves.back().data.swap(data);
+		pending_saves.back().sections.swap(sections);
+		pending_saves.back().compression=compression;
+
+		if(!save_thread_running)
+		{
+			// a thread that has run out of saves has finished by now
+			if(save_thread_joinable)
+				pthread_join(save_thread,NULL);
+			save_thread_joinable=save_thread_running=
+				(pthread_create(&save_thread,NULL,&write_pending_saves,NULL)==0);
+			started=save_thread_running;
+		}
+	}
+
+	// without a thread, write the file right here
+	if(!started)
+	{
+		write_pending_saves(NULL);
+		return wait_for_save(filename);
+	}
 	return true;
+#else
+	if(!sections.empty() && !pack_canvas_sections(sections,data))
+		return false;
+	return write_canvas_file(filename,data,compression);
+#endif
+}
+
+#ifdef HAVE_LIBPTHREAD
+//! Waits for the thread to write every pending save
+static void
+join_save_thread()
+{
+	bool joinable;
+	{
+		Mutex::Lock lock(save_mutex);
+		joinable=save_thread_joinable;
+		save_thread_joinable=false;
+	}
+
+	if(joinable)
+		pthread_join(save_thread,NULL);
+}
+#endif
+
+bool
+synfig::saves_pending()
+{
+#ifdef HAVE_LIBPTHREAD
+	Mutex::Lock lock(save_mutex);
+	return save_thread_running;
+#else
+	return false;
+#endif
+}
+
+bool
+synfig::wait_for_save(const String &filename)
+{
+#ifdef HAVE_LIBPTHREAD
+	join_save_thread();
+
+	Mutex::Lock lock(save_mutex);
+	return !failed_saves.erase(filename);
+#else
+	return true;
+#endif
+}
+
+bool
+synfig::wait_for_saves()
+{
+#ifdef HAVE_LIBPTHREAD
+	join_save_thread();
+
+	Mutex::Lock lock(save_mutex);
+	return failed_saves.empty();
+#else
+	return true;
+#endif
 }
 
 String
@@ -34,6 +34,22 @@
 
 /* === M A C R O S ========================================================= */
 
+//! Extension of canvas files which keep every exported canvas in a section of its own
+/*!	The file starts with the four bytes "SIFB", followed by the format
+**	version, the number of sections, and the offset and size of each
+**	section in the file, all as 32 bit little endian integers. Every
+**	section holds the XML of one canvas, the first one being the root,
+**	as its size in the same kind of integer followed by the XML
+**	compressed by zlib. Version 1 files hold the XML as it is.
+**	An exported canvas appears in the \c <defs> of its parent only as
+**	\c <canvas id="..." section="n"/>, so that it can be read when it
+**	is first needed instead of along with the rest of the file.
+**	Inline canvases stay in the section of the canvas holding them:
+**	they share its value nodes and their layer needs them as soon as
+**	it is loaded, so there would be nothing to defer. */
+#define CANVAS_SECTIONS_EXTENSION	".sifb"
+#define CANVAS_SECTIONS_VERSION		2
+
 /* === T Y P E D E F S ===================================================== */
 
 /* === C L A S S E S & S T R U C T S ======================================= */
@@ -46,10 +62,36 @@ namespace synfig {
 /*!	\return	\c true on success, \c false on error. */
 bool save_canvas(const String &filename, Canvas::ConstHandle canvas);
 
+//!	Saves a canvas to \a filename, leaving the writing of the file to a background thread
+/*!	The canvas is encoded before this returns, so it may be changed right
+**	away; only compressing and writing the file are left to the thread.
+**	Files are written in the order their saves were started.
+**	\return	\c false if the canvas couldn't be encoded.
+**	\see wait_for_saves() */
+bool save_canvas_in_background(const String &filename, Canvas::ConstHandle canvas);
+
+//!	Returns \c true while files of save_canvas_in_background() are still being written
+bool saves_pending();
+
+//!	Waits until the files of every save_canvas_in_background() have been written
+/*!	\return	\c false if writing \a filename failed. The failure is
+**	only reported once, later calls return \c true again. */
+bool wait_for_save(const String &filename);
+
+//!	Waits until the files of every save_canvas_in_background() have been written
+/*!	\return	\c false if writing any of them failed without
+**	wait_for_save() having been asked about it yet. */
+bool wait_for_saves();
+
 //! Stores a Canvas in a string in XML format
 /*! \return The string with the XML canvas definition */
 String canvas_to_string(Canvas::ConstHandle canvas);
 
+//! Reads section \a index of a file saved with CANVAS_SECTIONS_EXTENSION into \a text
+/*!	\return	\c true on success, \c false if the file can't be read
+**			or has no such section. */
+bool read_canvas_section(const String &filename, int index, String &text);
+
 void set_file_version(ReleaseVersion version);
 ReleaseVersion get_file_version();
 
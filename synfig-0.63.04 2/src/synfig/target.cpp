@@ -33,6 +33,7 @@
 #include "target_null.h"
 #include "target_null_tile.h"
 #include "targetparam.h"
+#include "module.h"
 
 using namespace synfig;
 using namespace etl;
@@ -114,6 +115,9 @@ Target::Handle
 Target::create(const String &name, const String &filename,
 			   synfig::TargetParam params)
 {
+	if(!book().count(name))
+		Module::request(Module::ENTRY_TARGET,name);
+
 	if(!book().count(name))
 		return handle<Target>();
 
@@ -32,9 +32,11 @@
 #endif
 
 #include "valuenode.h"
+#include <sigc++/bind.h>
 #include "general.h"
 #include "canvas.h"
 #include "releases.h"
+#include "module.h"
 
 #include "valuenode_const.h"
 #include "valuenode_linear.h"
@@ -219,6 +221,9 @@ LinkableValueNode::book()
 LinkableValueNode::Handle
 LinkableValueNode::create(const String &name, const ValueBase& x)
 {
+	if(!book().count(name))
+		Module::request(Module::ENTRY_VALUENODE,name);
+
 	if(!book().count(name))
 		return 0;
 
@@ -238,6 +243,9 @@ LinkableValueNode::create(const String &name, const ValueBase& x)
 bool
 LinkableValueNode::check_type(const String &name, ValueBase::Type x)
 {
+	if(!book().count(name))
+		Module::request(Module::ENTRY_VALUENODE,name);
+
 	if(!book().count(name) || !book()[name].check_type)
 		return false;
 	return book()[name].check_type(x);
@@ -303,6 +311,21 @@ ValueNode::~ValueNode()
 	begin_delete();
 }
 
+void
+ValueNode::get_values(const std::vector<Time> &times, std::vector<ValueBase> &values)const
+{
+	values.resize(times.size());
+	if(!times.empty())
+		get_values_vfunc(times, values);
+}
+
+void
+ValueNode::get_values_vfunc(const std::vector<Time> &times, std::vector<ValueBase> &values)const
+{
+	for(std::vector<Time>::size_type i=0;i<times.size();i++)
+		values[i]=(*this)(times[i]);
+}
+
 void
 ValueNode::on_changed()
 {
@@ -330,6 +353,8 @@ ValueNode::replace(etl::handle<ValueNode> x)
 		//x->parent_set.insert(*parent_set.begin());
 		//parent_set.erase(parent_set.begin());
 	}
+	signal_replaced()(x.get());
+
 	int r(RHandle(this).replace(x));
 	x->changed();
 	return r;
@@ -367,55 +392,163 @@ ValueNodeList::ValueNodeList():
 {
 }
 
-bool
-ValueNodeList::count(const String &id)const
+ValueNodeList::ValueNodeList(const ValueNodeList &x):
+	std::list<ValueNode::RHandle>(x),
+	placeholder_count_(x.placeholder_count_)
+{
+	for(iterator iter=begin();iter!=end();++iter)
+		index_insert(iter->get());
+}
+
+ValueNodeList::~ValueNodeList()
+{
+	index_clear();
+}
+
+ValueNodeList&
+ValueNodeList::operator=(const ValueNodeList &x)
+{
+	if(&x==this)
+		return *this;
+
+	index_clear();
+
+	std::list<ValueNode::RHandle>::operator=(x);
+	placeholder_count_=x.placeholder_count_;
+
+	for(iterator iter=begin();iter!=end();++iter)
+		index_insert(iter->get());
+	return *this;
+}
+
+void
+ValueNodeList::index_insert(ValueNode *value_node)
+{
+	if(!connections_.count(value_node))
+	{
+		connections_.insert(std::make_pair(value_node,value_node->signal_id_changed().connect(
+			sigc::bind(sigc::mem_fun(*this,&ValueNodeList::on_id_changed),value_node))));
+		connections_.insert(std::make_pair(value_node,value_node->signal_replaced().connect(
+			sigc::bind(sigc::mem_fun(*this,&ValueNodeList::on_replaced),value_node))));
+	}
+
+	// The first value node with a given id is the one find() would
+	// return, so a later one with the same id doesn't replace it
+	if(!value_node->get_id().empty())
+		index_.insert(std::make_pair(value_node->get_id(),ValueNode::LooseHandle(value_node)));
+}
+
+void
+ValueNodeList::index_erase(ValueNode *value_node)
+{
+	std::pair<std::multimap<ValueNode*, sigc::connection>::iterator,
+			  std::multimap<ValueNode*, sigc::connection>::iterator> range(connections_.equal_range(value_node));
+	for(std::multimap<ValueNode*, sigc::connection>::iterator citer=range.first;citer!=range.second;++citer)
+		citer->second.disconnect();
+	connections_.erase(range.first,range.second);
+
+	std::map<String, ValueNode::LooseHandle>::iterator iter(index_.find(value_node->get_id()));
+	if(iter!=index_.end() && iter->second==value_node)
+		index_.erase(iter);
+}
+
+void
+ValueNodeList::index_clear()
+{
+	std::multimap<ValueNode*, sigc::connection>::iterator iter;
+	for(iter=connections_.begin();iter!=connections_.end();++iter)
+		iter->second.disconnect();
+	connections_.clear();
+	index_.clear();
+}
+
+void
+ValueNodeList::on_id_changed(ValueNode *value_node)
+{
+	// The old id is gone by now, so look for the entry by value;
+	// renames are rare enough for that not to matter
+	std::map<String, ValueNode::LooseHandle>::iterator iter;
+	for(iter=index_.begin();iter!=index_.end();++iter)
+		if(iter->second==value_node)
+		{
+			index_.erase(iter);
+			break;
+		}
+
+	if(!value_node->get_id().empty())
+		index_.insert(std::make_pair(value_node->get_id(),ValueNode::LooseHandle(value_node)));
+}
+
+void
+ValueNodeList::on_replaced(ValueNode *replacement, ValueNode *value_node)
 {
-	const_iterator iter;
+	// replace() swaps every handle of the list to value_node over to
+	// replacement, so the replacement takes its place in the index too
+	index_erase(value_node);
+	index_insert(replacement);
+}
 
+ValueNode::Handle
+ValueNodeList::lookup(const String &id)
+{
 	if(id.empty())
-		return false;
+		return 0;
 
-	for(iter=begin();iter!=end() && id!=(*iter)->get_id();++iter)
-		;
+	// An entry is only trusted while it still has the id it is filed under
+	std::map<String, ValueNode::LooseHandle>::iterator iter(index_.find(id));
+	if(iter!=index_.end())
+	{
+		if(iter->second->get_id()==id)
+			return iter->second;
+		index_.erase(iter);
+	}
 
-	if(iter==end())
-		return false;
+	// Fall back to searching value nodes which were put into the list
+	// without going through add()
+	if(index_.size()!=size())
+		for(const_iterator iter=begin();iter!=end();++iter)
+			if(id==(*iter)->get_id())
+				return *iter;
 
-	return true;
+	return 0;
+}
+
+ValueNode::ConstHandle
+ValueNodeList::lookup(const String &id)const
+{
+	return const_cast<ValueNodeList*>(this)->lookup(id);
+}
+
+bool
+ValueNodeList::count(const String &id)const
+{
+	return lookup(id)!=0;
 }
 
 ValueNode::Handle
 ValueNodeList::find(const String &id)
 {
-	iterator iter;
-
 	if(id.empty())
 		throw Exception::IDNotFound("Empty ID");
 
-	for(iter=begin();iter!=end() && id!=(*iter)->get_id();++iter)
-		;
-
-	if(iter==end())
+	ValueNode::Handle value_node(lookup(id));
+	if(!value_node)
 		throw Exception::IDNotFound("ValueNode in ValueNodeList: "+id);
 
-	return *iter;
+	return value_node;
 }
 
 ValueNode::ConstHandle
 ValueNodeList::find(const String &id)const
 {
-	const_iterator iter;
-
 	if(id.empty())
 		throw Exception::IDNotFound("Empty ID");
 
-	for(iter=begin();iter!=end() && id!=(*iter)->get_id();++iter)
-		;
-
-	if(iter==end())
+	ValueNode::ConstHandle value_node(lookup(id));
+	if(!value_node)
 		throw Exception::IDNotFound("ValueNode in ValueNodeList: "+id);
 
-	return *iter;
+	return value_node;
 }
 
 ValueNode::Handle
@@ -424,17 +557,14 @@ ValueNodeList::surefind(const String &id)
 	if(id.empty())
 		throw Exception::IDNotFound("Empty ID");
 
-	ValueNode::Handle value_node;
+	ValueNode::Handle value_node(lookup(id));
 
-	try
-	{
-		value_node=find(id);
-	}
-	catch(Exception::IDNotFound)
+	if(!value_node)
 	{
 		value_node=PlaceholderValueNode::create();
 		value_node->set_id(id);
 		push_back(value_node);
+		index_insert(value_node.get());
 		placeholder_count_++;
 	}
 
@@ -451,6 +581,7 @@ ValueNodeList::erase(ValueNode::Handle value_node)
 	for(iter=begin();iter!=end();++iter)
 		if(value_node.get()==iter->get())
 		{
+			index_erase(value_node.get());
 			std::list<ValueNode::RHandle>::erase(iter);
 			if(PlaceholderValueNode::Handle::cast_dynamic(value_node))
 				placeholder_count_--;
@@ -467,25 +598,25 @@ ValueNodeList::add(ValueNode::Handle value_node)
 	if(value_node->get_id().empty())
 		return false;
 
-	try
+	ValueNode::RHandle other_value_node=lookup(value_node->get_id());
+	if(other_value_node)
 	{
-		ValueNode::RHandle other_value_node=find(value_node->get_id());
 		if(PlaceholderValueNode::Handle::cast_dynamic(other_value_node))
 		{
+			// replace() swaps the placeholder out of the list as well
+			index_erase(other_value_node.get());
 			other_value_node->replace(value_node);
+			index_insert(value_node.get());
 			placeholder_count_--;
 			return true;
 		}
 
 		return false;
 	}
-	catch(Exception::IDNotFound)
-	{
-		push_back(value_node);
-		return true;
-	}
 
-	return false;
+	push_back(value_node);
+	index_insert(value_node.get());
+	return true;
 }
 
 void
@@ -495,7 +626,10 @@ ValueNodeList::audit()
 
 	for(next=begin(),iter=next++;iter!=end();iter=next++)
 		if(iter->count()==1)
+		{
+			index_erase(iter->get());
 			std::list<ValueNode::RHandle>::erase(iter);
+		}
 }
 
 
@@ -610,6 +744,20 @@ void LinkableValueNode::get_times_vfunc(Node::time_set &set) const
 	}
 }
 
+bool
+LinkableValueNode::is_time_dependent_vfunc() const
+{
+	int size = link_count();
+
+	for(int i=0; i < size; ++i)
+	{
+		ValueNode::LooseHandle h(get_link(i));
+		if(h && h->is_time_dependent())
+			return true;
+	}
+	return false;
+}
+
 String
 LinkableValueNode::get_description(int index, bool show_exported_name)const
 {
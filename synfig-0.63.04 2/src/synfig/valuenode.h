@@ -38,6 +38,7 @@
 #include "exception.h"
 #include <map>
 #include <sigc++/signal.h>
+#include <sigc++/connection.h>
 #include "guid.h"
 #include <ETL/angle>
 #include "paramdesc.h"
@@ -45,6 +46,7 @@
 #include "node.h"
 
 #include <set>
+#include <vector>
 
 /* === M A C R O S ========================================================= */
 
@@ -148,6 +150,9 @@ private:
 	//!	ID Changed
 	sigc::signal<void> signal_id_changed_;
 
+	//!	Replaced by another ValueNode, see replace()
+	sigc::signal<void,ValueNode*> signal_replaced_;
+
 	/*
  -- ** -- S I G N A L   I N T E R F A C E -------------------------------------
 	*/
@@ -172,6 +177,9 @@ public:
 	//!	ID Changed
 	sigc::signal<void>& signal_id_changed() { return signal_id_changed_; }
 
+	//!	Replaced by another ValueNode, which is passed, just before the handles are swapped over
+	sigc::signal<void,ValueNode*>& signal_replaced() { return signal_replaced_; }
+
 	/*
  --	** -- C O N S T R U C T O R S ---------------------------------------------
 	*/
@@ -194,6 +202,12 @@ public:
 	virtual ValueBase operator()(Time /*t*/)const
 		{ return ValueBase(); }
 
+	//! Returns the values of the ValueNode at each of the times in \a times
+	/*!	\a values is resized to match \a times and filled in the same order.
+	**	Sorted (ascending) times are evaluated fastest.
+	**	\see get_values_vfunc() */
+	void get_values(const std::vector<Time> &times, std::vector<ValueBase> &values)const;
+
 	//! \internal Sets the id of the ValueNode
 	void set_id(const String &x);
 
@@ -247,6 +261,12 @@ protected:
 	//! Sets the type of the ValueNode
 	void set_type(ValueBase::Type t) { type=t; }
 
+	//! Evaluates the ValueNode at several times in one call
+	/*!	The default implementation calls operator()(Time) once per time.
+	**	Derived classes override it to share work between the samples,
+	**	i.e. evaluating their links only once for the whole time vector. */
+	virtual void get_values_vfunc(const std::vector<Time> &times, std::vector<ValueBase> &values)const;
+
 	virtual void on_changed();
 }; // END of class ValueNode
 
@@ -415,6 +435,10 @@ protected:
 	//! Returns the cached times values for all the children (linked Value Nodes)
 	virtual void get_times_vfunc(Node::time_set &set) const;
 
+	//! Returns \c true if any of the linked Value Nodes is time dependent.
+	//! Value Nodes that use the time on their own must override it.
+	virtual bool is_time_dependent_vfunc() const;
+
 	//! Pure Virtual member to get the children vocabulary
 	virtual Vocab get_children_vocab_vfunc()const=0;
 
@@ -431,8 +455,41 @@ protected:
 class ValueNodeList : public std::list<ValueNode::RHandle>
 {
 	int placeholder_count_;
+
+	//! The value nodes of the list by their ids, for lookup()
+	/*!	Kept up to date by add(), erase(), surefind() and audit(), and
+	**	through renames and replace() by watching every listed value node.
+	**	Value nodes put into the list by other means are not indexed. */
+	std::map<String, ValueNode::LooseHandle> index_;
+	//! The connections to signal_id_changed() and signal_replaced() of each indexed value node
+	std::multimap<ValueNode*, sigc::connection> connections_;
+
+	void index_insert(ValueNode *value_node);
+	void index_erase(ValueNode *value_node);
+	void index_clear();
+	void on_id_changed(ValueNode *value_node);
+	void on_replaced(ValueNode *replacement, ValueNode *value_node);
+
 public:
 	ValueNodeList();
+	ValueNodeList(const ValueNodeList &x);
+	~ValueNodeList();
+
+	ValueNodeList& operator=(const ValueNodeList &x);
+
+	//! Finds the ValueNode in the list with the given \a id
+	/*!	\return If found, returns a handle to the ValueNode.
+	**		Otherwise, returns an empty handle.
+	**	Unlike find(), a missing id is not an error, so nothing is thrown.
+	*/
+	ValueNode::Handle lookup(const String &id);
+
+	//! Finds the ValueNode in the list with the given \a id
+	/*!	\return If found, returns a handle to the ValueNode.
+	**		Otherwise, returns an empty handle.
+	**	Unlike find(), a missing id is not an error, so nothing is thrown.
+	*/
+	ValueNode::ConstHandle lookup(const String &id)const;
 
 	//! Finds the ValueNode in the list with the given \a name
 	/*!	\return If found, returns a handle to the ValueNode.
@@ -150,6 +150,47 @@ synfig::ValueNode_Add::operator()(Time t)const
 	return ValueBase();
 }
 
+void
+synfig::ValueNode_Add::get_values_vfunc(const std::vector<Time> &times, std::vector<ValueBase> &values)const
+{
+	if(!ref_a || !ref_b)
+		throw runtime_error(strprintf("ValueNode_Add: %s",_("One or both of my parameters aren't set!")));
+
+	vector<ValueBase> a, b, s;
+	ref_a->get_values(times, a);
+	ref_b->get_values(times, b);
+	scalar->get_values(times, s);
+
+	vector<Time>::size_type i, n(times.size());
+	switch(get_type())
+	{
+	case ValueBase::TYPE_ANGLE:
+		for(i=0;i<n;i++) values[i]=(a[i].get(Angle())+b[i].get(Angle()))*s[i].get(Real());
+		break;
+	case ValueBase::TYPE_COLOR:
+		for(i=0;i<n;i++) values[i]=(a[i].get(Color())+b[i].get(Color()))*s[i].get(Real());
+		break;
+	case ValueBase::TYPE_GRADIENT:
+		for(i=0;i<n;i++) values[i]=(a[i].get(Gradient())+b[i].get(Gradient()))*s[i].get(Real());
+		break;
+	case ValueBase::TYPE_INTEGER:
+		for(i=0;i<n;i++) values[i]=round_to_int((a[i].get(int())+b[i].get(int()))*s[i].get(Real()));
+		break;
+	case ValueBase::TYPE_REAL:
+		for(i=0;i<n;i++) values[i]=(a[i].get(Vector::value_type())+b[i].get(Vector::value_type()))*s[i].get(Real());
+		break;
+	case ValueBase::TYPE_TIME:
+		for(i=0;i<n;i++) values[i]=(a[i].get(Time())+b[i].get(Time()))*s[i].get(Real());
+		break;
+	case ValueBase::TYPE_VECTOR:
+		for(i=0;i<n;i++) values[i]=(a[i].get(Vector())+b[i].get(Vector()))*s[i].get(Real());
+		break;
+	default:
+		assert(0);
+		break;
+	}
+}
+
 bool
 ValueNode_Add::set_link_vfunc(int i,ValueNode::Handle value)
 {
@@ -61,6 +61,9 @@ public:
 	virtual String get_local_name()const;
 	static bool check_type(ValueBase::Type type);
 	virtual Vocab get_children_vocab_vfunc()const;
+
+protected:
+	virtual void get_values_vfunc(const std::vector<Time> &times, std::vector<ValueBase> &values)const;
 }; // END of class ValueNode_Add
 
 }; // END of namespace synfig
@@ -665,6 +665,40 @@ public:
 			return waypoint_list_.back().get_value(t);
 		return iter->resolve(t);
 	}
+
+protected:
+	virtual void get_values_vfunc(const std::vector<Time> &times, std::vector<ValueBase> &values)const
+	{
+		if(waypoint_list_.size()<=1)
+		{
+			ValueNode_Animated::get_values_vfunc(times, values);
+			return;
+		}
+
+		// Walk the curve list along with the times instead of searching
+		// it from the start for each one. The search only restarts when
+		// the times are not in ascending order.
+		typename curve_list_type::const_iterator iter(curve_list.begin());
+		for(std::vector<Time>::size_type i=0;i<times.size();i++)
+		{
+			const Time &t(times[i]);
+			if(t<=r)
+				values[i]=waypoint_list_.front().get_value(t);
+			else if(t>=s)
+				values[i]=waypoint_list_.back().get_value(t);
+			else
+			{
+				if(iter!=curve_list.begin() && i && t<times[i-1])
+					iter=curve_list.begin();
+				while(iter<curve_list.end() && t>=iter->first.get_s())
+					++iter;
+				if(iter==curve_list.end())
+					values[i]=waypoint_list_.back().get_value(t);
+				else
+					values[i]=iter->resolve(t);
+			}
+		}
+	}
 }; // END of class _Hermite
 
 
@@ -765,6 +799,37 @@ public:
 
 		return iter->get_value(t);
 	}
+
+protected:
+	virtual void get_values_vfunc(const std::vector<Time> &times, std::vector<ValueBase> &values)const
+	{
+		if(waypoint_list_.size()<=1)
+		{
+			ValueNode_Animated::get_values_vfunc(times, values);
+			return;
+		}
+
+		// As in operator(), but the waypoint search carries on from the
+		// previous time unless the times go backwards.
+		typename WaypointList::const_iterator iter(waypoint_list_.begin());
+		typename WaypointList::const_iterator next(iter+1);
+		for(std::vector<Time>::size_type i=0;i<times.size();i++)
+		{
+			const Time &t(times[i]);
+			if(t<=r)
+				values[i]=waypoint_list_.front().get_value(t);
+			else if(t>=s)
+				values[i]=waypoint_list_.back().get_value(t);
+			else
+			{
+				if(i && t<times[i-1])
+					next=(iter=waypoint_list_.begin())+1;
+				for(;next!=waypoint_list_.end() && t>=next->get_time();iter=next++)
+					continue;
+				values[i]=iter->get_value(t);
+			}
+		}
+	}
 }; // END of class _Constant
 
 class _AnimBool : public synfig::ValueNode_Animated
@@ -1186,6 +1251,13 @@ void ValueNode_Animated::get_times_vfunc(Node::time_set &set) const
 		set.insert(t);
 	}
 }
+
+bool
+ValueNode_Animated::is_time_dependent_vfunc() const
+{
+	return !waypoint_list().empty();
+}
+
 struct timecmp
  {
  	Time t;
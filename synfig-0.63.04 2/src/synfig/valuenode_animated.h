@@ -146,6 +146,9 @@ protected:
 	//! all the children Time Points. Time Point is like Waypoint but
 	//! without value node
 	virtual void get_times_vfunc(Node::time_set &set) const;
+
+	//! Any waypoint makes the Value Node time dependent
+	virtual bool is_time_dependent_vfunc() const;
 };
 
 }; // END of namespace synfig
@@ -170,6 +170,27 @@ synfig::convert_bline_to_width_list(const ValueBase& bline)
 	return ValueBase(ret,bline.get_loop());
 }
 
+bool
+synfig::bline_is_equal_to(const ValueBase &a, const ValueBase &b)
+{
+	if(a.get_type()!=ValueBase::TYPE_LIST || b.get_type()!=ValueBase::TYPE_LIST ||
+	   a.get_loop()!=b.get_loop())
+		return false;
+
+	const std::vector<ValueBase> &list_a(a.get_list()), &list_b(b.get_list());
+	if(list_a.size()!=list_b.size())
+		return false;
+
+	for(std::vector<ValueBase>::const_iterator iter_a=list_a.begin(),iter_b=list_b.begin();iter_a!=list_a.end();++iter_a,++iter_b)
+	{
+		if(iter_a->get_type()!=ValueBase::TYPE_BLINEPOINT || iter_b->get_type()!=ValueBase::TYPE_BLINEPOINT)
+			return false;
+		if(!iter_a->get(BLinePoint()).is_equal_to(iter_b->get(BLinePoint())))
+			return false;
+	}
+	return true;
+}
+
 Real
 synfig::find_closest_point(const ValueBase &bline, const Point &pos, Real &radius, bool loop, Point *out_point)
 {
@@ -63,6 +63,11 @@ Real hom_to_std(const ValueBase &bline, Real pos, bool index_loop, bool bline_lo
 //! Returns the length of the bline
 Real bline_length(const ValueBase &bline, bool bline_loop, std::vector<Real> *lengths);
 
+//! Returns true if two lists of bline points have the same geometry
+/*!	ValueBase::operator==() never takes bline points as equal, so this
+**	compares them with BLinePoint::is_equal_to() instead. */
+bool bline_is_equal_to(const ValueBase &a, const ValueBase &b);
+
 
 /*! \class ValueNode_BLine
 **	\brief \writeme
@@ -222,6 +222,114 @@ synfig::ValueNode_Composite::operator()(Time t)const
 	}
 }
 
+void
+synfig::ValueNode_Composite::get_values_vfunc(const std::vector<Time> &times, std::vector<ValueBase> &values)const
+{
+	int count;
+	switch(get_type())
+	{
+		case ValueBase::TYPE_VECTOR:
+			count=2;
+			break;
+		case ValueBase::TYPE_COLOR:
+		case ValueBase::TYPE_SEGMENT:
+		case ValueBase::TYPE_DASHITEM:
+			count=4;
+			break;
+		case ValueBase::TYPE_BLINEPOINT:
+		case ValueBase::TYPE_WIDTHPOINT:
+			count=6;
+			break;
+		default:
+			LinkableValueNode::get_values_vfunc(times, values);
+			return;
+	}
+
+	// Evaluate every component over the whole time vector first,
+	// then assemble the composite values from them
+	vector<ValueBase> c[6];
+	for(int j=0;j<count;j++)
+	{
+		assert(components[j]);
+		components[j]->get_values(times, c[j]);
+	}
+
+	vector<Time>::size_type i, n(times.size());
+	switch(get_type())
+	{
+		case ValueBase::TYPE_VECTOR:
+			for(i=0;i<n;i++)
+				values[i]=Vector(c[0][i].get(Vector::value_type()), c[1][i].get(Vector::value_type()));
+			break;
+		case ValueBase::TYPE_COLOR:
+			for(i=0;i<n;i++)
+			{
+				Color color;
+				color.set_r(c[0][i].get(Vector::value_type()));
+				color.set_g(c[1][i].get(Vector::value_type()));
+				color.set_b(c[2][i].get(Vector::value_type()));
+				color.set_a(c[3][i].get(Vector::value_type()));
+				values[i]=color;
+			}
+			break;
+		case ValueBase::TYPE_SEGMENT:
+			for(i=0;i<n;i++)
+			{
+				Segment seg;
+				seg.p1=c[0][i].get(Point());
+				seg.t1=c[1][i].get(Vector());
+				seg.p2=c[2][i].get(Point());
+				seg.t2=c[3][i].get(Vector());
+				values[i]=seg;
+			}
+			break;
+		case ValueBase::TYPE_BLINEPOINT:
+			for(i=0;i<n;i++)
+			{
+				BLinePoint ret;
+				ret.set_vertex(c[0][i].get(Point()));
+				ret.set_width(c[1][i].get(Real()));
+				ret.set_origin(c[2][i].get(Real()));
+				ret.set_split_tangent_flag(c[3][i].get(bool()));
+				ret.set_tangent1(c[4][i].get(Vector()));
+				if(ret.get_split_tangent_flag())
+					ret.set_tangent2(c[5][i].get(Vector()));
+				values[i]=ret;
+			}
+			break;
+		case ValueBase::TYPE_WIDTHPOINT:
+			for(i=0;i<n;i++)
+			{
+				WidthPoint ret;
+				ret.set_position(c[0][i].get(Real()));
+				ret.set_width(c[1][i].get(Real()));
+				ret.set_side_type_before(c[2][i].get(int()));
+				ret.set_side_type_after(c[3][i].get(int()));
+				ret.set_lower_bound(c[4][i].get(Real()));
+				ret.set_upper_bound(c[5][i].get(Real()));
+				values[i]=ret;
+			}
+			break;
+		case ValueBase::TYPE_DASHITEM:
+			for(i=0;i<n;i++)
+			{
+				DashItem ret;
+				Real offset(c[0][i].get(Real()));
+				if(offset < 0.0) offset=0.0;
+				Real length(c[1][i].get(Real()));
+				if(length < 0.0) length=0.0;
+				ret.set_offset(offset);
+				ret.set_length(length);
+				ret.set_side_type_before(c[2][i].get(int()));
+				ret.set_side_type_after(c[3][i].get(int()));
+				values[i]=ret;
+			}
+			break;
+		default:
+			break;
+	}
+}
+
 bool
 ValueNode_Composite::set_link_vfunc(int i,ValueNode::Handle x)
 {
@@ -56,6 +56,7 @@ public:
 	virtual int get_link_index_from_name(const String &name)const;
 
 protected:
+	virtual void get_values_vfunc(const std::vector<Time> &times, std::vector<ValueBase> &values)const;
 	virtual bool set_link_vfunc(int i,ValueNode::Handle x);
 
 	LinkableValueNode* create_new()const;
@@ -31,6 +31,7 @@
 
 #include "valuenode_const.h"
 #include "general.h"
+#include <algorithm>
 
 #endif
 
@@ -91,6 +92,12 @@ ValueNode_Const::operator()(Time /*t*/)const
 	return value;
 }
 
+void
+ValueNode_Const::get_values_vfunc(const std::vector<Time> &/*times*/, std::vector<ValueBase> &values)const
+{
+	std::fill(values.begin(),values.end(),value);
+}
+
 
 const ValueBase &
 ValueNode_Const::get_value()const
@@ -130,3 +137,8 @@ ValueNode_Const::get_local_name()const
 void ValueNode_Const::get_times_vfunc(Node::time_set &/*set*/) const
 {
 }
+
+bool ValueNode_Const::is_time_dependent_vfunc() const
+{
+	return false;
+}
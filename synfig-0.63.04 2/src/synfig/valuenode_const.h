@@ -68,6 +68,8 @@ public:
 
 protected:
 	virtual void get_times_vfunc(Node::time_set &set) const;
+	virtual bool is_time_dependent_vfunc() const;
+	virtual void get_values_vfunc(const std::vector<Time> &times, std::vector<ValueBase> &values)const;
 };
 
 }; // END of namespace synfig
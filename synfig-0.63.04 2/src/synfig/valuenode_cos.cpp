@@ -96,6 +96,17 @@ ValueNode_Cos::operator()(Time t)const
 		).get() * (*amp_)(t).get(Real());
 }
 
+void
+ValueNode_Cos::get_values_vfunc(const std::vector<Time> &times, std::vector<ValueBase> &values)const
+{
+	vector<ValueBase> angle, amp;
+	angle_->get_values(times, angle);
+	amp_->get_values(times, amp);
+
+	for(vector<Time>::size_type i=0;i<times.size();i++)
+		values[i]=Angle::cos(angle[i].get(Angle())).get() * amp[i].get(Real());
+}
+
 
 String
 ValueNode_Cos::get_name()const
@@ -60,6 +60,7 @@ public:
 	virtual ValueNode::LooseHandle get_link_vfunc(int i)const;
 
 protected:
+	virtual void get_values_vfunc(const std::vector<Time> &times, std::vector<ValueBase> &values)const;
 	LinkableValueNode* create_new()const;
 	virtual bool set_link_vfunc(int i,ValueNode::Handle x);
 
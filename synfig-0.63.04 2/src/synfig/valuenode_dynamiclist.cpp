@@ -849,6 +849,17 @@ void ValueNode_DynamicList::get_times_vfunc(Node::time_set &set) const
 	}
 }
 
+bool
+ValueNode_DynamicList::is_time_dependent_vfunc() const
+{
+	// entries with activepoints switch on and off over time
+	for(std::vector<ListEntry>::const_iterator iter=list.begin();iter!=list.end();++iter)
+		if(!iter->timing_info.empty())
+			return true;
+
+	return LinkableValueNode::is_time_dependent_vfunc();
+}
+
 
 //new find functions that don't throw
 struct timecmp
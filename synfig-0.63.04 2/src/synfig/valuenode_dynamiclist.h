@@ -229,6 +229,8 @@ protected:
 
 	virtual void get_times_vfunc(Node::time_set &set) const;
 
+	virtual bool is_time_dependent_vfunc() const;
+
 public:
 	/*! \note The construction parameter (\a id) is the type that the list
 	**	contains, rather than the type that it will yield
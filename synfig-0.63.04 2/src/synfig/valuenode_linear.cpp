@@ -133,6 +133,40 @@ ValueNode_Linear::operator()(Time t)const
 	return ValueBase();
 }
 
+void
+ValueNode_Linear::get_values_vfunc(const std::vector<Time> &times, std::vector<ValueBase> &values)const
+{
+	vector<ValueBase> m, b;
+	m_->get_values(times, m);
+	b_->get_values(times, b);
+
+	vector<Time>::size_type i, n(times.size());
+	switch(get_type())
+	{
+	case ValueBase::TYPE_ANGLE:
+		for(i=0;i<n;i++) values[i]=m[i].get( Angle())*times[i]+b[i].get( Angle());
+		break;
+	case ValueBase::TYPE_COLOR:
+		for(i=0;i<n;i++) values[i]=m[i].get( Color())*times[i]+b[i].get( Color());
+		break;
+	case ValueBase::TYPE_INTEGER:
+		for(i=0;i<n;i++) values[i]=round_to_int(m[i].get(int())*times[i]+b[i].get(int()));
+		break;
+	case ValueBase::TYPE_REAL:
+		for(i=0;i<n;i++) values[i]=m[i].get(  Real())*times[i]+b[i].get(  Real());
+		break;
+	case ValueBase::TYPE_TIME:
+		for(i=0;i<n;i++) values[i]=m[i].get(  Time())*times[i]+b[i].get(  Time());
+		break;
+	case ValueBase::TYPE_VECTOR:
+		for(i=0;i<n;i++) values[i]=m[i].get(Vector())*times[i]+b[i].get(Vector());
+		break;
+	default:
+		assert(0);
+		break;
+	}
+}
+
 
 String
 ValueNode_Linear::get_name()const
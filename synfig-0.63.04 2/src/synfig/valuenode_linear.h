@@ -60,6 +60,10 @@ public:
 	virtual ValueNode::LooseHandle get_link_vfunc(int i)const;
 
 protected:
+	//! The result is a function of the time itself
+	virtual bool is_time_dependent_vfunc()const { return true; }
+
+	virtual void get_values_vfunc(const std::vector<Time> &times, std::vector<ValueBase> &values)const;
 	LinkableValueNode* create_new()const;
 	virtual bool set_link_vfunc(int i,ValueNode::Handle x);
 
@@ -144,6 +144,51 @@ synfig::ValueNode_Scale::operator()(Time t)const
 	return ValueBase();
 }
 
+void
+synfig::ValueNode_Scale::get_values_vfunc(const std::vector<Time> &times, std::vector<ValueBase> &values)const
+{
+	if(!value_node || !scalar)
+		throw runtime_error(strprintf("ValueNode_Scale: %s",_("One or both of my parameters aren't set!")));
+
+	vector<ValueBase> v, s;
+	value_node->get_values(times, v);
+	scalar->get_values(times, s);
+
+	vector<Time>::size_type i, n(times.size());
+	switch(get_type())
+	{
+	case ValueBase::TYPE_ANGLE:
+		for(i=0;i<n;i++) values[i]=v[i].get(Angle())*s[i].get(Real());
+		break;
+	case ValueBase::TYPE_COLOR:
+		for(i=0;i<n;i++)
+		{
+			Color ret(v[i].get(Color()));
+			Real x(s[i].get(Real()));
+			ret.set_r(ret.get_r()*x);
+			ret.set_g(ret.get_g()*x);
+			ret.set_b(ret.get_b()*x);
+			values[i]=ret;
+		}
+		break;
+	case ValueBase::TYPE_INTEGER:
+		for(i=0;i<n;i++) values[i]=round_to_int(v[i].get(int())*s[i].get(Real()));
+		break;
+	case ValueBase::TYPE_REAL:
+		for(i=0;i<n;i++) values[i]=v[i].get(Real())*s[i].get(Real());
+		break;
+	case ValueBase::TYPE_TIME:
+		for(i=0;i<n;i++) values[i]=v[i].get(Time())*s[i].get(Time());
+		break;
+	case ValueBase::TYPE_VECTOR:
+		for(i=0;i<n;i++) values[i]=v[i].get(Vector())*s[i].get(Real());
+		break;
+	default:
+		assert(0);
+		break;
+	}
+}
+
 synfig::ValueBase
 synfig::ValueNode_Scale::get_inverse(Time t, const synfig::Vector &target_value) const
 {
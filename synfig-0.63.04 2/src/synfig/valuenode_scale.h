@@ -71,6 +71,7 @@ public:
 	virtual String get_local_name()const;
 
 protected:
+	virtual void get_values_vfunc(const std::vector<Time> &times, std::vector<ValueBase> &values)const;
 	virtual bool set_link_vfunc(int i,ValueNode::Handle x);
 
 	virtual LinkableValueNode* create_new()const;
@@ -97,6 +97,17 @@ ValueNode_Sine::operator()(Time t)const
 	;
 }
 
+void
+ValueNode_Sine::get_values_vfunc(const std::vector<Time> &times, std::vector<ValueBase> &values)const
+{
+	vector<ValueBase> angle, amp;
+	angle_->get_values(times, angle);
+	amp_->get_values(times, amp);
+
+	for(vector<Time>::size_type i=0;i<times.size();i++)
+		values[i]=Angle::sin(angle[i].get(Angle())).get() * amp[i].get(Real());
+}
+
 
 String
 ValueNode_Sine::get_name()const
@@ -61,6 +61,9 @@ public:
 	virtual ValueNode::LooseHandle get_link_vfunc(int i)const;
 
 protected:
+	//! The steps are laid out in time
+	virtual bool is_time_dependent_vfunc()const { return true; }
+
 	LinkableValueNode* create_new()const;
 	virtual bool set_link_vfunc(int i,ValueNode::Handle x);
 
@@ -71,6 +71,9 @@ public:
 	ValueNode::Handle get_scalar()const { return scalar; }
 
 	virtual Vocab get_children_vocab_vfunc()const;
+
+protected:
+	virtual void get_values_vfunc(const std::vector<Time> &times, std::vector<ValueBase> &values)const;
 }; // END of class ValueNode_Subtract
 
 }; // END of namespace synfig
@@ -67,6 +67,8 @@ public:
 //	static bool check_type(const ValueBase::Type &type);
 
 protected:
+	//! Swaps the links at a given time
+	virtual bool is_time_dependent_vfunc()const { return true; }
 
 	virtual LinkableValueNode* create_new()const;
 
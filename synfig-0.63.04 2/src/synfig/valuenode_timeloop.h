@@ -61,6 +61,9 @@ public:
 	virtual ValueNode::LooseHandle get_link_vfunc(int i)const;
 
 protected:
+	//! Evaluates its link at a shifted, looping time
+	virtual bool is_time_dependent_vfunc()const { return true; }
+
 	LinkableValueNode* create_new()const;
 	virtual bool set_link_vfunc(int i,ValueNode::Handle x);
 
@@ -24,6 +24,10 @@
 #ifndef __SYNFIG_DEFINITIONS_H
 #define __SYNFIG_DEFINITIONS_H
 
+/* === H E A D E R S ======================================================= */
+
+#include <iostream>
+
 /* === M A C R O S ========================================================= */
 
 #ifdef ENABLE_NLS
@@ -67,5 +71,10 @@ extern const char *progname;
 extern int verbosity;
 extern bool be_quiet;
 extern bool print_benchmarks;
+extern bool server_mode;
+
+//! Returns the stream that listings, benchmarks and render messages are printed to
+/*!	In server mode stdout carries nothing but the replies to requests */
+std::ostream &info_out();
 
 #endif
@@ -26,6 +26,8 @@
 
 using namespace synfig;
 
+#include <list>
+#include <vector>
 #include <synfig/string.h>
 #include <synfig/canvas.h>
 #include <synfig/target.h>
@@ -35,6 +37,10 @@ struct Job
 {
 	String filename;
 	String outfilename;
+	String target_name;
+
+	//! The options the job was given, defaults included
+	std::list<String> args;
 
 	RendDesc desc;
 
@@ -42,6 +48,10 @@ struct Job
 	Canvas::Handle canvas;
 	Target::Handle target;
 
+	//! Layers of --append files, put in front of the canvas of a job which saves it
+	/*!	Jobs which render have them put in their own copy of the canvas right away */
+	std::vector<Layer::Handle> composite_layers;
+
 	int quality;
 	bool sifout;
 	bool list_canvases;
@@ -38,6 +38,16 @@
 #include <algorithm>
 #include <cstring>
 #include <errno.h>
+#include <vector>
+#include <deque>
+
+#if defined(HAVE_FORK) && defined(HAVE_PIPE)
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <sys/select.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
 
 #include <synfig/loadcanvas.h>
 #include <synfig/savecanvas.h>
@@ -58,6 +68,7 @@
 #include "progress.h"
 #include "renderprogress.h"
 #include "job.h"
+#include "tiles.h"
 #endif
 
 using namespace std;
@@ -70,6 +81,18 @@ const char *progname;
 int verbosity=0;
 bool be_quiet=false;
 bool print_benchmarks=false;
+bool server_mode=false;
+
+//! Number of worker processes to start on this machine
+int worker_count=0;
+//! Commands starting further worker processes, on other machines for instance
+std::list<String> worker_commands;
+//! Number of frames in each shard, or 0 to choose one
+int shard_frames=0;
+//! Number of times a shard is tried again after failing
+int shard_retries=2;
+//! Size of the tiles single frames are rendered in, or 0 to render them whole
+int tile_size=0;
 
 //! Allowed video codecs
 /*! \warning This variable is linked to allowed_video_codecs_description,
@@ -170,6 +193,13 @@ void display_help(bool full)
 		display_help_option("-o", "<output file>", _("Specify output filename"));
 		display_help_option("-T", "<# of threads>", _("Enable multithreaded renderer using specified # of threads"));
 		display_help_option("-b", NULL, _("Print Benchmarks"));
+		display_help_option("--server", NULL, _("Read jobs from standard input, one line of arguments each, keeping files loaded between them"));
+		display_help_option("--workers", "<count>", _("Split image sequences into ranges of frames rendered by <count> worker processes"));
+		display_help_option("--worker-command", "<command>", _("Also render on a worker started by <command> (such as \"ssh host synfig\")"));
+		display_help_option("--shard-frames", "<count>", _("Set the number of frames handed to a worker at once"));
+		display_help_option("--retries", "<count>", _("Set how many times a failed range of frames is tried again (default=2)"));
+		display_help_option("--tile-size", "<pixels>", _("Render single frames in separate tiles of <pixels> square, stitched together afterwards. Tiles are raw files next to the output, so remote workers must share its directory and be of the same architecture"));
+		display_help_option("--region", "<x,y,w,h>", _("Render only the given rectangle of pixels into a tile file, see --tile-size"));
 		display_help_option("--fps", "<framerate>", _("Set the frame rate"));
 		display_help_option("--time", "<time>", _("Render a single frame at <seconds>"));
 		display_help_option("--begin-time", "<time>", _("Set the starting time"));
@@ -266,6 +296,7 @@ int process_global_flags(arg_list_t &arg_list)
 		{
 			Progress p(PACKAGE);
 			synfig::Main synfig_main(dirname(progname),&p);
+			synfig::Module::load_pending(&p);
 			synfig::Layer::Book::iterator iter=synfig::Layer::book().begin();
 			for(;iter!=synfig::Layer::book().end();iter++)
 				if (iter->second.category != CATEGORY_DO_NOT_USE)
@@ -308,6 +339,7 @@ int process_global_flags(arg_list_t &arg_list)
 		{
 			Progress p(PACKAGE);
 			synfig::Main synfig_main(dirname(progname),&p);
+			synfig::Module::load_pending(&p);
 			synfig::Module::Book::iterator iter=synfig::Module::book().begin();
 			for(;iter!=synfig::Module::book().end();iter++)
 				cout<<iter->first<<endl;
@@ -318,6 +350,7 @@ int process_global_flags(arg_list_t &arg_list)
 		{
 			Progress p(PACKAGE);
 			synfig::Main synfig_main(dirname(progname),&p);
+			synfig::Module::load_pending(&p);
 			synfig::Target::Book::iterator iter=synfig::Target::book().begin();
 			for(;iter!=synfig::Target::book().end();iter++)
 				cout<<iter->first<<endl;
@@ -335,6 +368,7 @@ int process_global_flags(arg_list_t &arg_list)
 		{
 			Progress p(PACKAGE);
 			synfig::Main synfig_main(dirname(progname),&p);
+			synfig::Module::load_pending(&p);
 			synfig::LinkableValueNode::Book::iterator iter=synfig::LinkableValueNode::book().begin();
 			for(;iter!=synfig::LinkableValueNode::book().end();iter++)
 				cout<<iter->first<<endl;
@@ -345,6 +379,7 @@ int process_global_flags(arg_list_t &arg_list)
 		{
 			Progress p(PACKAGE);
 			synfig::Main synfig_main(dirname(progname),&p);
+			synfig::Module::load_pending(&p);
 			synfig::Importer::Book::iterator iter=synfig::Importer::book().begin();
 			for(;iter!=synfig::Importer::book().end();iter++)
 				cout<<iter->first<<endl;
@@ -392,6 +427,38 @@ int process_global_flags(arg_list_t &arg_list)
 			arg_list.erase(iter);
 			continue;
 		}
+
+		if(*iter == "--server")
+		{
+			server_mode=true;
+			arg_list.erase(iter);
+			continue;
+		}
+
+		if(*iter == "--workers" || *iter == "--worker-command" || *iter == "--shard-frames" || *iter == "--retries" ||
+		   *iter == "--tile-size")
+		{
+			const String flag(*iter);
+			if(next==arg_list.end())
+			{
+				error("The `%s' flag requires a value.  Use --help for a list of options.", flag.c_str());
+				return SYNFIGTOOL_MISSINGARGUMENT;
+			}
+			arg_list.erase(iter);
+			iter=next++;
+			if(flag=="--workers")
+				worker_count=atoi(iter->c_str());
+			else if(flag=="--worker-command")
+				worker_commands.push_back(*iter);
+			else if(flag=="--shard-frames")
+				shard_frames=atoi(iter->c_str());
+			else if(flag=="--tile-size")
+				tile_size=atoi(iter->c_str());
+			else
+				shard_retries=atoi(iter->c_str());
+			arg_list.erase(iter);
+			continue;
+		}
 	}
 
 	return SYNFIGTOOL_OK;
@@ -404,7 +471,7 @@ bool flag_requires_value(String flag)
 			flag=="-Q"			|| flag=="-s"			|| flag=="-t"			|| flag=="-T"			|| flag=="-w"			||
 			flag=="--append"	|| flag=="--begin-time"	|| flag=="--canvas-info"|| flag=="--dpi"		|| flag=="--dpi-x"		||
 			flag=="--dpi-y"		|| flag=="--end-time"	|| flag=="--fps"		|| flag=="--layer-info"	|| flag=="--start-time"	||
-			flag=="--time"		|| flag=="-vc"			|| flag=="-vb");
+			flag=="--time"		|| flag=="-vc"			|| flag=="-vb"			|| flag=="--region");
 }
 
 int extract_arg_cluster(arg_list_t &arg_list,arg_list_t &cluster)
@@ -716,6 +783,23 @@ int extract_canvasid(arg_list_t &arg_list,string &canvasid)
 	return SYNFIGTOOL_OK;
 }
 
+int extract_region(arg_list_t &arg_list,string &region)
+{
+	arg_list_t::iterator iter, next;
+
+	for(next=arg_list.begin(),iter=next++;iter!=arg_list.end();iter=next++)
+	{
+		if(*iter=="--region")
+		{
+			region = extract_parameter(arg_list, iter, next);
+		}
+		else if (flag_requires_value(*iter))
+			iter++;
+	}
+
+	return SYNFIGTOOL_OK;
+}
+
 int extract_list_canvases(arg_list_t &arg_list,bool &list_canvases)
 {
 	arg_list_t::iterator iter, next;
@@ -802,12 +886,18 @@ void extract_canvas_info(arg_list_t &arg_list, Job &job)
 		}
 }
 
+std::ostream &info_out()
+{
+	return server_mode ? cerr : cout;
+}
+
 void list_child_canvases(string prefix, Canvas::Handle canvas)
 {
 	Canvas::Children children(canvas->children());
 	for (Canvas::Children::iterator iter = children.begin(); iter != children.end(); iter++)
 	{
-		cout << prefix << ":" << (*iter)->get_id() << endl;
+		info_out() << prefix << ":" << (*iter)->get_id() << endl;
+		(*iter)->load_deferred();
 		list_child_canvases(prefix + ":" + (*iter)->get_id(), *iter);
 	}
 }
@@ -819,472 +909,471 @@ void list_canvas_info(Job job)
 
 	if (job.canvas_info_all || job.canvas_info_time_start)
 	{
-		cout << endl << "# " << _("Start Time") << endl;
-		cout << "time_start"	<< "=" << rend_desc.get_time_start().get_string().c_str() << endl;
+		info_out() << endl << "# " << _("Start Time") << endl;
+		info_out() << "time_start"	<< "=" << rend_desc.get_time_start().get_string().c_str() << endl;
 	}
 
 	if (job.canvas_info_all || job.canvas_info_time_end)
 	{
-		cout << endl << "# " << _("End Time") << endl;
-		cout << "time_end"		<< "=" << rend_desc.get_time_end().get_string().c_str() << endl;
+		info_out() << endl << "# " << _("End Time") << endl;
+		info_out() << "time_end"		<< "=" << rend_desc.get_time_end().get_string().c_str() << endl;
 	}
 
 	if (job.canvas_info_all || job.canvas_info_frame_rate)
 	{
-		cout << endl << "# " << _("Frame Rate") << endl;
-		cout << "frame_rate"	<< "=" << rend_desc.get_frame_rate() << endl;
+		info_out() << endl << "# " << _("Frame Rate") << endl;
+		info_out() << "frame_rate"	<< "=" << rend_desc.get_frame_rate() << endl;
 	}
 
 	if (job.canvas_info_all || job.canvas_info_frame_start)
 	{
-		cout << endl << "# " << _("Start Frame") << endl;
-		cout << "frame_start"	<< "=" << rend_desc.get_frame_start() << endl;
+		info_out() << endl << "# " << _("Start Frame") << endl;
+		info_out() << "frame_start"	<< "=" << rend_desc.get_frame_start() << endl;
 	}
 
 	if (job.canvas_info_all || job.canvas_info_frame_end)
 	{
-		cout << endl << "# " << _("End Frame") << endl;
-		cout << "frame_end"		<< "=" << rend_desc.get_frame_end() << endl;
+		info_out() << endl << "# " << _("End Frame") << endl;
+		info_out() << "frame_end"		<< "=" << rend_desc.get_frame_end() << endl;
 	}
 
 	if (job.canvas_info_all)
-		cout << endl;
+		info_out() << endl;
 
 	if (job.canvas_info_all || job.canvas_info_w)
 	{
-		cout << endl << "# " << _("Width") << endl;
-		cout << "w"				<< "=" << rend_desc.get_w() << endl;
+		info_out() << endl << "# " << _("Width") << endl;
+		info_out() << "w"				<< "=" << rend_desc.get_w() << endl;
 	}
 
 	if (job.canvas_info_all || job.canvas_info_h)
 	{
-		cout << endl << "# " << _("Height") << endl;
-		cout << "h"				<< "=" << rend_desc.get_h() << endl;
+		info_out() << endl << "# " << _("Height") << endl;
+		info_out() << "h"				<< "=" << rend_desc.get_h() << endl;
 	}
 
 	if (job.canvas_info_all || job.canvas_info_image_aspect)
 	{
-		cout << endl << "# " << _("Image Aspect Ratio") << endl;
-		cout << "image_aspect"	<< "=" << rend_desc.get_image_aspect() << endl;
+		info_out() << endl << "# " << _("Image Aspect Ratio") << endl;
+		info_out() << "image_aspect"	<< "=" << rend_desc.get_image_aspect() << endl;
 	}
 
 	if (job.canvas_info_all)
-		cout << endl;
+		info_out() << endl;
 
 	if (job.canvas_info_all || job.canvas_info_pw)
 	{
-		cout << endl << "# " << _("Pixel Width") << endl;
-		cout << "pw"			<< "=" << rend_desc.get_pw() << endl;
+		info_out() << endl << "# " << _("Pixel Width") << endl;
+		info_out() << "pw"			<< "=" << rend_desc.get_pw() << endl;
 	}
 
 	if (job.canvas_info_all || job.canvas_info_ph)
 	{
-		cout << endl << "# " << _("Pixel Height") << endl;
-		cout << "ph"			<< "=" << rend_desc.get_ph() << endl;
+		info_out() << endl << "# " << _("Pixel Height") << endl;
+		info_out() << "ph"			<< "=" << rend_desc.get_ph() << endl;
 	}
 
 	if (job.canvas_info_all || job.canvas_info_pixel_aspect)
 	{
-		cout << endl << "# " << _("Pixel Aspect Ratio") << endl;
-		cout << "pixel_aspect"	<< "=" << rend_desc.get_pixel_aspect() << endl;
+		info_out() << endl << "# " << _("Pixel Aspect Ratio") << endl;
+		info_out() << "pixel_aspect"	<< "=" << rend_desc.get_pixel_aspect() << endl;
 	}
 
 	if (job.canvas_info_all)
-		cout << endl;
+		info_out() << endl;
 
 	if (job.canvas_info_all || job.canvas_info_tl)
 	{
-		cout << endl << "# " << _("Top Left") << endl;
-		cout << "tl"			<< "=" << rend_desc.get_tl()[0]
+		info_out() << endl << "# " << _("Top Left") << endl;
+		info_out() << "tl"			<< "=" << rend_desc.get_tl()[0]
 			 << " " << rend_desc.get_tl()[1] << endl;
 	}
 
 	if (job.canvas_info_all || job.canvas_info_br)
 	{
-		cout << endl << "# " << _("Bottom Right") << endl;
-		cout << "br"			<< "=" << rend_desc.get_br()[0]
+		info_out() << endl << "# " << _("Bottom Right") << endl;
+		info_out() << "br"			<< "=" << rend_desc.get_br()[0]
 			 << " " << rend_desc.get_br()[1] << endl;
 	}
 
 	if (job.canvas_info_all || job.canvas_info_physical_w)
 	{
-		cout << endl << "# " << _("Physical Width") << endl;
-		cout << "physical_w"	<< "=" << rend_desc.get_physical_w() << endl;
+		info_out() << endl << "# " << _("Physical Width") << endl;
+		info_out() << "physical_w"	<< "=" << rend_desc.get_physical_w() << endl;
 	}
 
 	if (job.canvas_info_all || job.canvas_info_physical_h)
 	{
-		cout << endl << "# " << _("Physical Height") << endl;
-		cout << "physical_h"	<< "=" << rend_desc.get_physical_h() << endl;
+		info_out() << endl << "# " << _("Physical Height") << endl;
+		info_out() << "physical_h"	<< "=" << rend_desc.get_physical_h() << endl;
 	}
 
 	if (job.canvas_info_all || job.canvas_info_x_res)
 	{
-		cout << endl << "# " << _("X Resolution") << endl;
-		cout << "x_res"			<< "=" << rend_desc.get_x_res() << endl;
+		info_out() << endl << "# " << _("X Resolution") << endl;
+		info_out() << "x_res"			<< "=" << rend_desc.get_x_res() << endl;
 	}
 
 	if (job.canvas_info_all || job.canvas_info_y_res)
 	{
-		cout << endl << "# " << _("Y Resolution") << endl;
-		cout << "y_res"			<< "=" << rend_desc.get_y_res() << endl;
+		info_out() << endl << "# " << _("Y Resolution") << endl;
+		info_out() << "y_res"			<< "=" << rend_desc.get_y_res() << endl;
 	}
 
 	if (job.canvas_info_all || job.canvas_info_span)
 	{
-		cout << endl << "# " << _("Diagonal Image Span") << endl;
-		cout << "span"			<< "=" << rend_desc.get_span() << endl;
+		info_out() << endl << "# " << _("Diagonal Image Span") << endl;
+		info_out() << "span"			<< "=" << rend_desc.get_span() << endl;
 	}
 
 	if (job.canvas_info_all)
-		cout << endl;
+		info_out() << endl;
 
 	if (job.canvas_info_all || job.canvas_info_interlaced)
 	{
-		cout << endl << "# " << _("Interlaced") << endl;
-		cout << "interlaced"	<< "=" << rend_desc.get_interlaced() << endl;
+		info_out() << endl << "# " << _("Interlaced") << endl;
+		info_out() << "interlaced"	<< "=" << rend_desc.get_interlaced() << endl;
 	}
 
 	if (job.canvas_info_all || job.canvas_info_antialias)
 	{
-		cout << endl << "# " << _("Antialias") << endl;
-		cout << "antialias"		<< "=" << rend_desc.get_antialias() << endl;
+		info_out() << endl << "# " << _("Antialias") << endl;
+		info_out() << "antialias"		<< "=" << rend_desc.get_antialias() << endl;
 	}
 
 	if (job.canvas_info_all || job.canvas_info_clamp)
 	{
-		cout << endl << "# " << _("Clamp") << endl;
-		cout << "clamp"			<< "=" << rend_desc.get_clamp() << endl;
+		info_out() << endl << "# " << _("Clamp") << endl;
+		info_out() << "clamp"			<< "=" << rend_desc.get_clamp() << endl;
 	}
 
 	if (job.canvas_info_all || job.canvas_info_flags)
 	{
-		cout << endl << "# " << _("Flags") << endl;
-		cout << "flags"			<< "=" << rend_desc.get_flags() << endl;
+		info_out() << endl << "# " << _("Flags") << endl;
+		info_out() << "flags"			<< "=" << rend_desc.get_flags() << endl;
 	}
 
 	if (job.canvas_info_all || job.canvas_info_focus)
 	{
-		cout << endl << "# " << _("Focus") << endl;
-		cout << "focus"			<< "=" << rend_desc.get_focus()[0]
+		info_out() << endl << "# " << _("Focus") << endl;
+		info_out() << "focus"			<< "=" << rend_desc.get_focus()[0]
 			 << " " << rend_desc.get_focus()[1] << endl;
 	}
 
 	if (job.canvas_info_all || job.canvas_info_bg_color)
 	{
-		cout << endl << "# " << _("Background Color") << endl;
-		cout << "bg_color"		<< "=" << rend_desc.get_bg_color().get_string().c_str() << endl;
+		info_out() << endl << "# " << _("Background Color") << endl;
+		info_out() << "bg_color"		<< "=" << rend_desc.get_bg_color().get_string().c_str() << endl;
 	}
 
 	if (job.canvas_info_all)
-		cout << endl;
+		info_out() << endl;
 
 	if (job.canvas_info_all || job.canvas_info_metadata)
 	{
 		std::list<String> keys(canvas->get_meta_data_keys());
-		cout << endl << "# " << _("Metadata") << endl;
+		info_out() << endl << "# " << _("Metadata") << endl;
 		for (std::list<String>::iterator iter = keys.begin(); iter != keys.end(); iter++)
-			cout << *iter << "=" << canvas->get_meta_data(*iter) << endl;
+			info_out() << *iter << "=" << canvas->get_meta_data(*iter) << endl;
 	}
 }
 
 /* === M E T H O D S ======================================================= */
 
-/* === E N T R Y P O I N T ================================================= */
-
-int main(int argc, char *argv[])
+//! Sets up a job for every file in \a arg_list, with the options that follow it
+/*!	\a defaults are the options given before the first file, which every
+**	job starts from. Jobs that can't be set up are thrown out with a message. */
+int build_jobs(arg_list_t &arg_list, const arg_list_t &defaults, job_list_t &job_list)
 {
-	int i;
-	arg_list_t arg_list;
-	job_list_t job_list;
-
-	setlocale(LC_ALL, "");
-
-#ifdef ENABLE_NLS
-	bindtextdomain("synfig", LOCALEDIR);
-	bind_textdomain_codeset("synfig", "UTF-8");
-	textdomain("synfig");
-#endif
-
-	progname=argv[0];
-	Progress p(argv[0]);
-
-	if(!SYNFIG_CHECK_VERSION())
-	{
-		cerr<<_("FATAL: Synfig Version Mismatch")<<endl;
-		return SYNFIGTOOL_BADVERSION;
-	}
+	arg_list_t imageargs;
+	int ret;
 
-	if(argc==1)
+	while(arg_list.size())
 	{
-		display_help(false);
-		return SYNFIGTOOL_BLANK;
-	}
-
-	for(i=1;i<argc;i++)
-		arg_list.push_back(argv[i]);
+		string target_name;
+		job_list.push_front(Job());
+		int threads=0;
 
-	if((i=process_global_flags(arg_list)))
-		return i;
-
-	VERBOSE_OUT(1)<<_("verbosity set to ")<<verbosity<<endl;
-	synfig::Main synfig_main(dirname(progname),&p);
-
-	{
-		arg_list_t defaults, imageargs;
-		int ret;
+		imageargs=defaults;
+		job_list.front().filename=arg_list.front();
+		arg_list.pop_front();
 
-		// Grab the defaults before the first file
-		if ((ret = extract_arg_cluster(arg_list,defaults)) != SYNFIGTOOL_OK)
+		if ((ret = extract_arg_cluster(arg_list,imageargs)) != SYNFIGTOOL_OK)
 		  return ret;
+		job_list.front().args=imageargs;
 
-		while(arg_list.size())
+		// Open the composition
+		String errors, warnings;
+		try
 		{
-			string target_name;
-			job_list.push_front(Job());
-			int threads=0;
+			job_list.front().root=open_canvas_cached(job_list.front().filename, errors, warnings);
+		}
+		catch(runtime_error x)
+		{
+			job_list.front().root = 0;
+		}
+
+		if(!job_list.front().root)
+		{
+			cerr<<_("Unable to load '")<<job_list.front().filename<<"'."<<endl;
+			cerr<<_("Throwing out job...")<<endl;
+			job_list.pop_front();
+			continue;
+		}
 
-			imageargs=defaults;
-			job_list.front().filename=arg_list.front();
-			arg_list.pop_front();
+		bool list_canvases = false;
+		extract_list_canvases(imageargs, list_canvases);
+		job_list.front().list_canvases = list_canvases;
 
-			if ((ret = extract_arg_cluster(arg_list,imageargs)) != SYNFIGTOOL_OK)
-			  return ret;
+		extract_canvas_info(imageargs, job_list.front());
 
-			// Open the composition
-			String errors, warnings;
+		job_list.front().root->set_time(0);
+
+		string canvasid;
+		extract_canvasid(imageargs,canvasid);
+		if(!canvasid.empty())
+		{
 			try
 			{
-				job_list.front().root=open_canvas(job_list.front().filename, errors, warnings);
+				String warnings;
+				job_list.front().canvas=job_list.front().root->find_canvas(canvasid, warnings);
 			}
-			catch(runtime_error x)
+			catch(Exception::IDNotFound)
 			{
-				job_list.front().root = 0;
-			}
+				cerr<<_("Unable to find canvas with ID \"")<<canvasid<<_("\" in ")<<job_list.front().filename<<"."<<endl;
+				cerr<<_("Throwing out job...")<<endl;
+				job_list.pop_front();
+				continue;
 
-			if(!job_list.front().root)
+			}
+			catch(Exception::BadLinkName)
 			{
-				cerr<<_("Unable to load '")<<job_list.front().filename<<"'."<<endl;
+				cerr<<_("Invalid canvas name \"")<<canvasid<<_("\" in ")<<job_list.front().filename<<"."<<endl;
 				cerr<<_("Throwing out job...")<<endl;
 				job_list.pop_front();
 				continue;
 			}
-
-			bool list_canvases = false;
-			extract_list_canvases(imageargs, list_canvases);
-			job_list.front().list_canvases = list_canvases;
-
-			extract_canvas_info(imageargs, job_list.front());
-
-			job_list.front().root->set_time(0);
-
-			string canvasid;
-			extract_canvasid(imageargs,canvasid);
-			if(!canvasid.empty())
+		}
+		else
+			job_list.front().canvas=job_list.front().root;
+
+		// The canvas may be shared with other jobs over the same file,
+		// so what this job changes is only applied once it knows
+		// which canvas it will be working on, see below
+		job_list.front().desc=job_list.front().canvas->rend_desc();
+		extract_RendDesc(imageargs,job_list.front().desc);
+		extract_target(imageargs,target_name);
+		extract_threads(imageargs,threads);
+		job_list.front().quality=DEFAULT_QUALITY;
+		extract_quality(imageargs,job_list.front().quality);
+		VERBOSE_OUT(2)<<_("Quality set to ")<<job_list.front().quality<<endl;
+		extract_outfile(imageargs,job_list.front().outfilename);
+		string region;
+		extract_region(imageargs,region);
+
+		// Extract composite
+		std::vector<Layer::Handle> composite_layers;
+		do{
+			string composite_file;
+			extract_append(imageargs,composite_file);
+			if(!composite_file.empty())
 			{
-				try
-				{
-					String warnings;
-					job_list.front().canvas=job_list.front().root->find_canvas(canvasid, warnings);
-				}
-				catch(Exception::IDNotFound)
+				String errors, warnings;
+				Canvas::Handle composite(open_canvas(composite_file, errors, warnings));
+				if(!composite)
 				{
-					cerr<<_("Unable to find canvas with ID \"")<<canvasid<<_("\" in ")<<job_list.front().filename<<"."<<endl;
-					cerr<<_("Throwing out job...")<<endl;
-					job_list.pop_front();
-					continue;
-
+					cerr<<_("Unable to append '")<<composite_file<<"'."<<endl;
+					break;
 				}
-				catch(Exception::BadLinkName)
+				Canvas::reverse_iterator iter;
+				for(iter=composite->rbegin();iter!=composite->rend();++iter)
 				{
-					cerr<<_("Invalid canvas name \"")<<canvasid<<_("\" in ")<<job_list.front().filename<<"."<<endl;
-					cerr<<_("Throwing out job...")<<endl;
-					job_list.pop_front();
-					continue;
+					Layer::Handle layer(*iter);
+					if(layer->active())
+						composite_layers.push_back(layer->clone());
 				}
+				VERBOSE_OUT(2)<<_("Appended contents of ")<<composite_file<<endl;
 			}
-			else
-				job_list.front().canvas=job_list.front().root;
-
-			extract_RendDesc(imageargs,job_list.front().canvas->rend_desc());
-			extract_target(imageargs,target_name);
-			extract_threads(imageargs,threads);
-			job_list.front().quality=DEFAULT_QUALITY;
-			extract_quality(imageargs,job_list.front().quality);
-			VERBOSE_OUT(2)<<_("Quality set to ")<<job_list.front().quality<<endl;
-			job_list.front().desc=job_list.front().canvas->rend_desc();
-			extract_outfile(imageargs,job_list.front().outfilename);
-
-			// Extract composite
-			do{
-				string composite_file;
-				extract_append(imageargs,composite_file);
-				if(!composite_file.empty())
-				{
-					String errors, warnings;
-					Canvas::Handle composite(open_canvas(composite_file, errors, warnings));
-					if(!composite)
-					{
-						cerr<<_("Unable to append '")<<composite_file<<"'."<<endl;
-						break;
-					}
-					Canvas::reverse_iterator iter;
-					for(iter=composite->rbegin();iter!=composite->rend();++iter)
-					{
-						Layer::Handle layer(*iter);
-						if(layer->active())
-							job_list.front().canvas->push_front(layer->clone());
-					}
-					VERBOSE_OUT(2)<<_("Appended contents of ")<<composite_file<<endl;
-				}
-			} while(false);
+		} while(false);
 
-			VERBOSE_OUT(4)<<_("Attempting to determine target/outfile...")<<endl;
+		VERBOSE_OUT(4)<<_("Attempting to determine target/outfile...")<<endl;
 
-			// If the target type is not yet defined,
-			// try to figure it out from the outfile.
-			if(target_name.empty() && !job_list.front().outfilename.empty())
+		// If the target type is not yet defined,
+		// try to figure it out from the outfile.
+		if(target_name.empty() && !job_list.front().outfilename.empty())
+		{
+			VERBOSE_OUT(3)<<_("Target name undefined, attempting to figure it out")<<endl;
+			string ext = filename_extension(job_list.front().outfilename);
+			if (ext.length()) ext = ext.substr(1);
+			Module::request(Module::ENTRY_TARGET_EXT,ext);
+			if(Target::ext_book().count(ext))
 			{
-				VERBOSE_OUT(3)<<_("Target name undefined, attempting to figure it out")<<endl;
-				string ext = filename_extension(job_list.front().outfilename);
-				if (ext.length()) ext = ext.substr(1);
-				if(Target::ext_book().count(ext))
+				target_name=Target::ext_book()[ext];
+				info("target name not specified - using %s", target_name.c_str());
+			}
+			else
+			{
+				string lower_ext(ext);
+
+				for(unsigned int i=0;i<ext.length();i++)
+					lower_ext[i] = tolower(ext[i]);
+
+				Module::request(Module::ENTRY_TARGET_EXT,lower_ext);
+				if(Target::ext_book().count(lower_ext))
 				{
-					target_name=Target::ext_book()[ext];
+					target_name=Target::ext_book()[lower_ext];
 					info("target name not specified - using %s", target_name.c_str());
 				}
 				else
-				{
-					string lower_ext(ext);
-
-					for(unsigned int i=0;i<ext.length();i++)
-						lower_ext[i] = tolower(ext[i]);
-
-					if(Target::ext_book().count(lower_ext))
-					{
-						target_name=Target::ext_book()[lower_ext];
-						info("target name not specified - using %s", target_name.c_str());
-					}
-					else
-						target_name=ext;
-				}
+					target_name=ext;
 			}
+		}
 
-			TargetParam target_parameters;
-			// Extract the extra parameters for the targets that
-			// need them.
-			if (target_name == "ffmpeg")
+		TargetParam target_parameters;
+		// Extract the extra parameters for the targets that
+		// need them.
+		if (target_name == "ffmpeg")
+		{
+			int status;
+			status = extract_target_params(imageargs, target_parameters);
+			if (status == SYNFIGTOOL_UNKNOWNARGUMENT)
 			{
-				int status;
-				status = extract_target_params(imageargs, target_parameters);
-				if (status == SYNFIGTOOL_UNKNOWNARGUMENT)
-				{
-					cerr << strprintf(_("Unknown target video codec: %s."),
-									 target_parameters.video_codec.c_str())
-						 << endl;
-					cerr << _("Available target video codecs are:")
-						 << endl;
-					display_target_video_codecs_help();
-
-					return SYNFIGTOOL_UNKNOWNARGUMENT;
-				}
-				else if (status == SYNFIGTOOL_MISSINGARGUMENT)
-				{
-					cerr << _("Missing argument: \"-vb\".") << endl;
-
-					return SYNFIGTOOL_MISSINGARGUMENT;
-				}
+				cerr << strprintf(_("Unknown target video codec: %s."),
+								 target_parameters.video_codec.c_str())
+					 << endl;
+				cerr << _("Available target video codecs are:")
+					 << endl;
+				display_target_video_codecs_help();
+
+				return SYNFIGTOOL_UNKNOWNARGUMENT;
 			}
-
-			// If the target type is STILL not yet defined, then
-			// set it to a some sort of default
-			if(target_name.empty())
+			else if (status == SYNFIGTOOL_MISSINGARGUMENT)
 			{
-				VERBOSE_OUT(2)<<_("Defaulting to PNG target...")<<endl;
-				target_name="png";
-			}
+				cerr << _("Missing argument: \"-vb\".") << endl;
 
-			// If no output filename was provided, then
-			// create a output filename based on the
-			// given input filename. (ie: change the extension)
-			if(job_list.front().outfilename.empty())
-			{
-				job_list.front().outfilename = filename_sans_extension(job_list.front().filename) + '.';
-				if(Target::book().count(target_name))
-					job_list.front().outfilename+=Target::book()[target_name].filename;
-				else
-					job_list.front().outfilename+=target_name;
+				return SYNFIGTOOL_MISSINGARGUMENT;
 			}
+		}
 
-			VERBOSE_OUT(4)<<"target_name="<<target_name<<endl;
-			VERBOSE_OUT(4)<<"outfile_name="<<job_list.front().outfilename<<endl;
-			if (access(dirname(job_list.front().outfilename).c_str(),W_OK) == -1)
-				{
-					cerr<<(_("Unable to create ouput for ")+job_list.front().outfilename+": "+strerror(errno))<<endl;
-					job_list.pop_front();
-					continue;
-				}
-			VERBOSE_OUT(4)<<_("Creating the target...")<<endl;
-			job_list.front().target =
-				synfig::Target::create(target_name,
-									   job_list.front().outfilename,
-									   target_parameters);
+		// If the target type is STILL not yet defined, then
+		// set it to a some sort of default
+		if(target_name.empty())
+		{
+			VERBOSE_OUT(2)<<_("Defaulting to PNG target...")<<endl;
+			target_name="png";
+		}
 
-			if(target_name=="sif")
-				job_list.front().sifout=true;
+		// If no output filename was provided, then
+		// create a output filename based on the
+		// given input filename. (ie: change the extension)
+		if(job_list.front().outfilename.empty())
+		{
+			job_list.front().outfilename = filename_sans_extension(job_list.front().filename) + '.';
+			Module::request(Module::ENTRY_TARGET,target_name);
+			if(Target::book().count(target_name))
+				job_list.front().outfilename+=Target::book()[target_name].filename;
 			else
+				job_list.front().outfilename+=target_name;
+		}
+
+		job_list.front().target_name=target_name;
+		VERBOSE_OUT(4)<<"target_name="<<target_name<<endl;
+		VERBOSE_OUT(4)<<"outfile_name="<<job_list.front().outfilename<<endl;
+		if (access(dirname(job_list.front().outfilename).c_str(),W_OK) == -1)
 			{
-				if(!job_list.front().target)
-				{
-					cerr<<_("Unknown target for ")<<job_list.front().filename<<": "<<target_name<<endl;
-					cerr<<_("Throwing out job...")<<endl;
-					job_list.pop_front();
-					continue;
-				}
-				job_list.front().sifout=false;
+				cerr<<(_("Unable to create ouput for ")+job_list.front().outfilename+": "+strerror(errno))<<endl;
+				job_list.pop_front();
+				continue;
 			}
-
-			// Set the Canvas on the Target
-			if(job_list.front().target)
+		VERBOSE_OUT(4)<<_("Creating the target...")<<endl;
+		if(!region.empty())
+		{
+			// Render the tile with a margin around it, which the target leaves out
+			RendDesc &desc(job_list.front().desc);
+			int x, y, w, h;
+			if(sscanf(region.c_str(),"%d,%d,%d,%d",&x,&y,&w,&h)!=4 ||
+			   x<0 || y<0 || w<=0 || h<=0 || x+w>desc.get_w() || y+h>desc.get_h())
 			{
-				VERBOSE_OUT(4)<<_("Setting the canvas on the target...")<<endl;
-				job_list.front().target->set_canvas(job_list.front().canvas);
-				VERBOSE_OUT(4)<<_("Setting the quality of the target...")<<endl;
-				job_list.front().target->set_quality(job_list.front().quality);
+				cerr<<_("Invalid region for ")<<job_list.front().filename<<": "<<region<<endl;
+				cerr<<_("Throwing out job...")<<endl;
+				job_list.pop_front();
+				continue;
 			}
 
-			// Set the threads for the target
-			if(job_list.front().target && Target_Scanline::Handle::cast_dynamic(job_list.front().target))
-				Target_Scanline::Handle::cast_dynamic(job_list.front().target)->set_threads(threads);
+			const int margin(tile_margin(job_list.front().canvas,desc));
+			const int left(max(0,x-margin)), top(max(0,y-margin));
+			const int right(min(desc.get_w(),x+w+margin)), bottom(min(desc.get_h(),y+h+margin));
+			VERBOSE_OUT(2)<<strprintf(_("Rendering region with a margin of %d pixels"),margin)<<endl;
+
+			desc.set_subwindow(left,top,right-left,bottom-top);
+			job_list.front().target_name="tile";
+			job_list.front().target=new TileTarget(job_list.front().outfilename,x-left,y-top,w,h);
+		}
+		else
+			job_list.front().target =
+				synfig::Target::create(target_name,
+									   job_list.front().outfilename,
+									   target_parameters);
 
-			if(imageargs.size())
+		if(target_name=="sif")
+			job_list.front().sifout=true;
+		else
+		{
+			if(!job_list.front().target)
 			{
-				cerr<<_("Unidentified arguments for ")<<job_list.front().filename<<": ";
-				for(;imageargs.size();imageargs.pop_front())
-					cerr<<' '<<imageargs.front();
-				cerr<<endl;
+				cerr<<_("Unknown target for ")<<job_list.front().filename<<": "<<target_name<<endl;
 				cerr<<_("Throwing out job...")<<endl;
 				job_list.pop_front();
 				continue;
 			}
+			job_list.front().sifout=false;
 		}
-	}
 
-	if(arg_list.size())
-	{
-		cerr<<_("Unidentified arguments:");
-		for(;arg_list.size();arg_list.pop_front())
-			cerr<<' '<<arg_list.front();
-		cerr<<endl;
-		return SYNFIGTOOL_UNKNOWNARGUMENT;
-	}
+		// Render from a copy of the canvas of our own, which shares the
+		// parsed file with every other job over it. Saving needs the
+		// original canvas, since a copy can't be saved, so that is only
+		// changed for as long as it is being saved, see run_jobs()
+		if(job_list.front().sifout)
+			job_list.front().composite_layers=composite_layers;
+		else
+		{
+			job_list.front().canvas=job_list.front().canvas->render_copy();
+			job_list.front().canvas->rend_desc()=job_list.front().desc;
+			for(std::vector<Layer::Handle>::iterator iter=composite_layers.begin();iter!=composite_layers.end();++iter)
+				job_list.front().canvas->push_front(*iter);
+		}
 
-	if(!job_list.size())
-	{
-		cerr<<_("Nothing to do!")<<endl;
-		return SYNFIGTOOL_BORED;
+		// Set the Canvas on the Target
+		if(job_list.front().target)
+		{
+			VERBOSE_OUT(4)<<_("Setting the canvas on the target...")<<endl;
+			job_list.front().target->set_canvas(job_list.front().canvas);
+			VERBOSE_OUT(4)<<_("Setting the quality of the target...")<<endl;
+			job_list.front().target->set_quality(job_list.front().quality);
+		}
+
+		// Set the threads for the target
+		if(job_list.front().target && Target_Scanline::Handle::cast_dynamic(job_list.front().target))
+			Target_Scanline::Handle::cast_dynamic(job_list.front().target)->set_threads(threads);
+
+		if(imageargs.size())
+		{
+			cerr<<_("Unidentified arguments for ")<<job_list.front().filename<<": ";
+			for(;imageargs.size();imageargs.pop_front())
+				cerr<<' '<<imageargs.front();
+			cerr<<endl;
+			cerr<<_("Throwing out job...")<<endl;
+			job_list.pop_front();
+			continue;
+		}
 	}
 
+	return SYNFIGTOOL_OK;
+}
+
+//! Renders, saves or lists each job in turn
+int run_jobs(job_list_t &job_list)
+{
 	for(;job_list.size();job_list.pop_front())
 	{
 		VERBOSE_OUT(3)<<job_list.front().filename<<" -- "<<endl<<'\t'<<
@@ -1306,7 +1395,28 @@ int main(int argc, char *argv[])
 		p.task(job_list.front().filename+" ==> "+job_list.front().outfilename);
 		if(job_list.front().sifout)
 		{
-			if(!save_canvas(job_list.front().outfilename,job_list.front().canvas))
+			// Other jobs, and later requests of a server, share the
+			// canvas, so it is put back the way it was once it is saved
+			Canvas::Handle canvas(job_list.front().canvas);
+			const RendDesc desc(canvas->rend_desc());
+			std::vector<Layer::Handle> &composite_layers(job_list.front().composite_layers);
+			std::vector<Layer::Handle>::iterator iter;
+
+			canvas->rend_desc()=job_list.front().desc;
+			for(iter=composite_layers.begin();iter!=composite_layers.end();++iter)
+				canvas->push_front(*iter);
+
+			const bool saved(save_canvas(job_list.front().outfilename,canvas));
+
+			for(iter=composite_layers.begin();iter!=composite_layers.end();++iter)
+			{
+				Canvas::iterator layer(std::find(canvas->begin(),canvas->end(),*iter));
+				if(layer!=canvas->end())
+					canvas->erase(layer);
+			}
+			canvas->rend_desc()=desc;
+
+			if(!saved)
 			{
 				cerr<<"Render Failure."<<endl;
 				return SYNFIGTOOL_RENDERFAILURE;
@@ -1334,11 +1444,647 @@ int main(int argc, char *argv[])
 				return SYNFIGTOOL_RENDERFAILURE;
 			}
 			if(print_benchmarks)
-				cout<<job_list.front().filename+": Rendered in "<<timer()<<" seconds."<<endl;
+				info_out()<<job_list.front().filename+": Rendered in "<<timer()<<" seconds."<<endl;
+		}
+	}
+
+	return SYNFIGTOOL_OK;
+}
+
+//! Splits a line into arguments at whitespace, honoring quotes and backslashes
+bool split_arguments(const String &line, arg_list_t &arg_list)
+{
+	String arg;
+	bool in_arg(false);
+	char quote(0);
+
+	for(String::const_iterator iter=line.begin();iter!=line.end();++iter)
+	{
+		if(*iter=='\\' && quote!='\'' && iter+1!=line.end())
+		{
+			arg+=*++iter;
+			in_arg=true;
+		}
+		else if(quote)
+		{
+			if(*iter==quote)
+				quote=0;
+			else
+				arg+=*iter;
+		}
+		else if(*iter=='"' || *iter=='\'')
+		{
+			quote=*iter;
+			in_arg=true;
+		}
+		else if(isspace((unsigned char)*iter))
+		{
+			if(in_arg)
+				arg_list.push_back(arg);
+			arg.clear();
+			in_arg=false;
+		}
+		else
+		{
+			arg+=*iter;
+			in_arg=true;
+		}
+	}
+	if(in_arg)
+		arg_list.push_back(arg);
+
+	return !quote;
+}
+
+//! Sets up and runs the jobs of \a arg_list, with \a defaults, returning the exit code
+int run_arguments(arg_list_t &arg_list, const arg_list_t &defaults)
+{
+	job_list_t job_list;
+
+	int ret(build_jobs(arg_list,defaults,job_list));
+	if(ret==SYNFIGTOOL_OK && arg_list.size())
+		ret=SYNFIGTOOL_UNKNOWNARGUMENT;
+	if(ret==SYNFIGTOOL_OK && !job_list.size())
+		ret=SYNFIGTOOL_BORED;
+	if(ret==SYNFIGTOOL_OK)
+		ret=run_jobs(job_list);
+	return ret;
+}
+
+//! Runs jobs read from the standard input, one line at a time, until it ends
+/*!	Each line holds the same arguments as the command line would, without
+**	the defaults, which are taken from the command line. Modules stay loaded
+**	and canvases stay parsed (see open_canvas_cached()) from one line to the
+**	next. Progress is written to the standard error as usual, and for every
+**	line a single line is written to the standard output: "ok", or "error"
+**	followed by the exit code the same jobs would have given. */
+int serve(const arg_list_t &defaults)
+{
+	String line;
+	while(getline(cin,line))
+	{
+		arg_list_t arg_list;
+
+		if(!split_arguments(line,arg_list))
+		{
+			cout<<"error "<<SYNFIGTOOL_UNKNOWNARGUMENT<<endl;
+			continue;
+		}
+		if(arg_list.empty() || arg_list.front()[0]=='#')
+			continue;
+		if(arg_list.front()=="quit")
+			break;
+
+		const int ret(run_arguments(arg_list,defaults));
+		if(ret==SYNFIGTOOL_OK)
+			cout<<"ok"<<endl;
+		else
+			cout<<"error "<<ret<<endl;
+	}
+
+	clear_canvas_cache();
+	return SYNFIGTOOL_OK;
+}
+
+//! Targets writing a file of their own for each frame, whose frames can be rendered apart
+const char* sequence_targets[] =
+{
+	"png", "jpeg", "bmp", "ppm", "openexr", "imagemagick", NULL
+};
+
+//! A range of frames of a job, handed to a worker as a line of arguments
+struct Shard
+{
+	String line;
+	String description;
+	int failures;
+};
+
+//! Quotes \a arg so that both split_arguments() and the shell read it back unchanged
+String quote_argument(const String &arg)
+{
+	String ret("'");
+	for(String::const_iterator iter=arg.begin();iter!=arg.end();++iter)
+		if(*iter=='\'')
+			ret+="'\\''";
+		else
+			ret+=*iter;
+	return ret+'\'';
+}
+
+//! Returns the options of \a job for its shards, but for those every shard sets for itself
+String shard_arguments(const Job &job)
+{
+	String args;
+	arg_list_t::const_iterator iter(job.args.begin());
+	while(iter!=job.args.end())
+	{
+		const String flag(*iter++);
+		String value;
+		const bool has_value(flag_requires_value(flag) && iter!=job.args.end());
+		if(has_value)
+			value=*iter++;
+
+		if(flag=="-o" || flag=="-t" || flag=="--time" || flag=="--start-time" || flag=="--begin-time" ||
+		   flag=="--end-time" || flag=="--region")
+			continue;
+
+		args+=' '+quote_argument(flag);
+		if(has_value)
+			args+=' '+quote_argument(value);
+	}
+	return args;
+}
+
+//! Splits \a job into ranges of frames for \a workers workers, adding them to \a shards
+/*!	\return \c false if the job can't be split, and is to be run here instead */
+bool split_frames(const Job &job, int workers, std::vector<Shard> &shards)
+{
+	if(job.sifout || job.list_canvases || job.canvas_info || job.outfilename=="-")
+		return false;
+
+	int i;
+	for(i=0;sequence_targets[i] && job.target_name!=sequence_targets[i];i++);
+	if(!sequence_targets[i])
+		return false;
+
+	const int first(job.desc.get_frame_start()), last(job.desc.get_frame_end());
+	if(last<=first)
+		return false;
+
+	// Small shards even out slow frames against fast ones, and cost
+	// little since the workers keep the file loaded between them
+	int size(shard_frames);
+	if(size<=0)
+		size=std::max(1,(last-first+1)/(workers*4));
+
+	const String args(shard_arguments(job));
+
+	for(int start=first;start<=last;start+=size)
+	{
+		const int end(std::min(start+size-1,last));
+
+		// A single frame isn't numbered by the target, so number it here
+		String outfilename(job.outfilename);
+		if(start==end)
+			outfilename=filename_sans_extension(outfilename)+strprintf(".%04d",start)+filename_extension(outfilename);
+
+		Shard shard;
+		shard.line=quote_argument(job.filename)+args+
+			" -t "+quote_argument(job.target_name)+
+			strprintf(" --start-time %df --end-time %df",start,end)+
+			" -o "+quote_argument(outfilename);
+		shard.description=strprintf(_("%s, frames %d to %d"),job.filename.c_str(),start,end);
+		shard.failures=0;
+		shards.push_back(shard);
+	}
+
+	return true;
+}
+
+//! A frame rendered in tiles, to be put together once they are all rendered
+struct Stitch
+{
+	Job job;
+	std::vector<Tile> tiles;
+};
+
+//! Splits the single frame of \a job into tiles of tile_size, adding them to \a shards
+/*!	Every tile is rendered with --region into a file of its own, and the
+**	tiles are put together by stitch_frames() into the target of the job.
+**	\return \c false if the job can't be split, and is to be run here instead */
+bool split_tiles(const Job &job, std::vector<Shard> &shards, std::list<Stitch> &stitches)
+{
+	if(tile_size<=0 || job.sifout || job.list_canvases || job.canvas_info || job.outfilename=="-" ||
+	   job.target_name=="tile")
+		return false;
+
+	if(job.desc.get_frame_end()>job.desc.get_frame_start() || !Target_Scanline::Handle::cast_dynamic(job.target))
+		return false;
+
+	const String args(shard_arguments(job));
+	const int w(job.desc.get_w()), h(job.desc.get_h());
+
+	stitches.push_back(Stitch());
+	stitches.back().job=job;
+
+	for(int y=0;y<h;y+=tile_size)
+		for(int x=0;x<w;x+=tile_size)
+		{
+			Tile tile;
+			tile.x=x;
+			tile.y=y;
+			tile.w=std::min(tile_size,w-x);
+			tile.h=std::min(tile_size,h-y);
+			tile.filename=job.outfilename+strprintf(".tile-%d-%d",x,y);
+			stitches.back().tiles.push_back(tile);
+
+			Shard shard;
+			shard.line=quote_argument(job.filename)+args+
+				strprintf(" --time %df --region %d,%d,%d,%d",job.desc.get_frame_start(),x,y,tile.w,tile.h)+
+				" -o "+quote_argument(tile.filename);
+			shard.description=strprintf(_("%s, tile at %d,%d"),job.filename.c_str(),x,y);
+			shard.failures=0;
+			shards.push_back(shard);
+		}
+
+	return true;
+}
+
+//! Puts together the frames rendered in tiles, if \a render is set, and removes the tiles
+int stitch_frames(std::list<Stitch> &stitches, bool render)
+{
+	int ret(SYNFIGTOOL_OK);
+
+	for(std::list<Stitch>::iterator iter=stitches.begin();iter!=stitches.end();++iter)
+	{
+		if(render && ret==SYNFIGTOOL_OK)
+		{
+			RenderProgress p;
+			p.task(iter->job.filename+" ==> "+iter->job.outfilename);
+			if(!stitch_tiles(Target_Scanline::Handle::cast_dynamic(iter->job.target),iter->tiles,&p))
+			{
+				cerr<<"Render Failure."<<endl;
+				ret=SYNFIGTOOL_RENDERFAILURE;
+			}
+		}
+
+		for(std::vector<Tile>::iterator tile=iter->tiles.begin();tile!=iter->tiles.end();++tile)
+			remove(tile->filename.c_str());
+	}
+
+	return ret;
+}
+
+//! Puts shard \a index back in \a queue after it failed, unless it has failed too often
+/*!	\return \c false if the shard was given up on */
+bool retry_shard(std::vector<Shard> &shards, int index, std::deque<int> &queue)
+{
+	if(++shards[index].failures>shard_retries)
+	{
+		cerr<<_("Giving up on ")<<shards[index].description<<endl;
+		return false;
+	}
+	queue.push_back(index);
+	return true;
+}
+
+//! Renders \a shards one after another in this process
+int run_shards_here(std::vector<Shard> &shards)
+{
+	for(unsigned int i=0;i<shards.size();i++)
+	{
+		arg_list_t arg_list;
+		split_arguments(shards[i].line,arg_list);
+		VERBOSE_OUT(2)<<_("Rendering ")<<shards[i].description<<endl;
+		const int ret(run_arguments(arg_list,arg_list_t()));
+		if(ret!=SYNFIGTOOL_OK)
+		{
+			cerr<<_("Failed to render ")<<shards[i].description<<endl;
+			return ret;
+		}
+	}
+	return SYNFIGTOOL_OK;
+}
+
+#if defined(HAVE_FORK) && defined(HAVE_PIPE)
+
+//! A process running the jobs it is handed on its standard input, see serve()
+struct Worker
+{
+	String command;
+	pid_t pid;
+	FILE *to;		//!< standard input of the worker, or 0 once it is stopped
+	int from;		//!< standard output of the worker
+	String output;	//!< what the worker has written since the end of its last line
+	int shard;		//!< the shard being rendered, or -1 if idle
+};
+
+//! Returns \c true if \a line is a reply of serve(), \c "ok" or \c "error <n>", setting \a ok
+bool parse_reply(const String &line, bool &ok)
+{
+	if(line=="ok")
+	{
+		ok=true;
+		return true;
+	}
+	if(line.size()>6 && line.compare(0,6,"error ")==0 &&
+	   line.find_first_not_of("0123456789",6)==String::npos)
+	{
+		ok=false;
+		return true;
+	}
+	return false;
+}
+
+//! Starts the command of \a worker through the shell, with pipes to its standard input and output
+bool start_worker(Worker &worker)
+{
+	int to[2], from[2];
+	if(pipe(to))
+		return false;
+	if(pipe(from))
+	{
+		close(to[0]);
+		close(to[1]);
+		return false;
+	}
+
+	// Keep the ends of the pipes that are ours from the workers started later
+	fcntl(to[1],F_SETFD,FD_CLOEXEC);
+	fcntl(from[0],F_SETFD,FD_CLOEXEC);
+
+	worker.pid=fork();
+	if(worker.pid==0)
+	{
+		dup2(to[0],STDIN_FILENO);
+		dup2(from[1],STDOUT_FILENO);
+		close(to[0]);
+		close(from[1]);
+		execl("/bin/sh","sh","-c",worker.command.c_str(),(char*)NULL);
+		_exit(127);
+	}
+
+	close(to[0]);
+	close(from[1]);
+	if(worker.pid<0)
+	{
+		close(to[1]);
+		close(from[0]);
+		return false;
+	}
+
+	worker.to=fdopen(to[1],"w");
+	worker.from=from[0];
+	worker.output.clear();
+	worker.shard=-1;
+	return true;
+}
+
+//! Tells \a worker to quit and waits for it
+void stop_worker(Worker &worker)
+{
+	if(!worker.to)
+		return;
+	fputs("quit\n",worker.to);
+	fclose(worker.to);
+	close(worker.from);
+	waitpid(worker.pid,NULL,0);
+	worker.to=0;
+	worker.from=-1;
+	worker.shard=-1;
+}
+
+//! Renders \a shards on the workers, handing each the next one as soon as it is done
+/*!	Shards that fail, or whose worker quits on them, are tried again
+**	(see retry_shard()) on whichever worker is free first. */
+int run_shards(std::vector<Shard> &shards)
+{
+	std::list<String> commands(worker_commands);
+	for(int i=0;i<worker_count;i++)
+		commands.push_back(quote_argument(progname));
+
+	std::vector<Worker> workers;
+	for(std::list<String>::iterator iter=commands.begin();iter!=commands.end();++iter)
+	{
+		Worker worker;
+		worker.command=*iter+" --server -q";
+		if(start_worker(worker))
+			workers.push_back(worker);
+		else
+			cerr<<_("Unable to start worker: ")<<*iter<<endl;
+	}
+
+	std::deque<int> queue;
+	for(unsigned int i=0;i<shards.size();i++)
+		queue.push_back(i);
+
+	int left(shards.size()), done(0), failed(0);
+	std::vector<Worker>::iterator iter;
+
+	while(left)
+	{
+		// Hand the idle workers something to do
+		int busy(0), max_fd(-1);
+		fd_set fds;
+		FD_ZERO(&fds);
+		for(iter=workers.begin();iter!=workers.end();++iter)
+		{
+			if(!iter->to)
+				continue;
+			if(iter->shard<0 && !queue.empty())
+			{
+				iter->shard=queue.front();
+				queue.pop_front();
+				VERBOSE_OUT(2)<<_("Rendering ")<<shards[iter->shard].description<<endl;
+				if(fprintf(iter->to,"%s\n",shards[iter->shard].line.c_str())<0 || fflush(iter->to))
+				{
+					cerr<<_("Lost worker: ")<<iter->command<<endl;
+					if(!retry_shard(shards,iter->shard,queue))
+						left--, failed++;
+					stop_worker(*iter);
+					continue;
+				}
+			}
+			if(iter->shard>=0)
+			{
+				busy++;
+				FD_SET(iter->from,&fds);
+				max_fd=std::max(max_fd,iter->from);
+			}
 		}
+
+		// Every shard not yet finished is either queued or being rendered,
+		// so with nobody busy there's nobody left to render the queue
+		if(!busy)
+		{
+			cerr<<_("No workers left to render on")<<endl;
+			break;
+		}
+
+		if(select(max_fd+1,&fds,NULL,NULL,NULL)<0)
+		{
+			if(errno==EINTR)
+				continue;
+			cerr<<"select(): "<<strerror(errno)<<endl;
+			break;
+		}
+
+		for(iter=workers.begin();iter!=workers.end();++iter)
+		{
+			if(!iter->to || iter->shard<0 || !FD_ISSET(iter->from,&fds))
+				continue;
+
+			char buffer[256];
+			const ssize_t size(read(iter->from,buffer,sizeof(buffer)));
+			if(size<0 && errno==EINTR)
+				continue;
+			if(size<=0)
+			{
+				const int index(iter->shard);
+				cerr<<_("Worker quit while rendering ")<<shards[index].description<<": "<<iter->command<<endl;
+				stop_worker(*iter);
+				if(!retry_shard(shards,index,queue))
+					left--, failed++;
+				continue;
+			}
+			iter->output.append(buffer,size);
+
+			// Anything but a reply, such as a message a library printed
+			// to stdout, is passed on and doesn't count as the reply
+			String::size_type end;
+			while(iter->to && (end=iter->output.find('\n'))!=String::npos)
+			{
+				const String line(iter->output,0,end);
+				iter->output.erase(0,end+1);
+
+				bool ok;
+				if(iter->shard<0 || !parse_reply(line,ok))
+				{
+					cerr<<iter->command<<": "<<line<<endl;
+					continue;
+				}
+
+				const int index(iter->shard);
+				iter->shard=-1;
+				if(ok)
+				{
+					left--, done++;
+					if(!be_quiet)
+						cerr<<strprintf(_("Rendered %s (%d of %d)"),shards[index].description.c_str(),done,(int)shards.size())<<endl;
+				}
+				else
+				{
+					cerr<<_("Failed to render ")<<shards[index].description<<": "<<line<<endl;
+					if(!retry_shard(shards,index,queue))
+						left--, failed++;
+				}
+			}
+		}
+	}
+
+	for(iter=workers.begin();iter!=workers.end();++iter)
+		stop_worker(*iter);
+
+	if(left || failed)
+	{
+		cerr<<"Render Failure."<<endl;
+		return SYNFIGTOOL_RENDERFAILURE;
+	}
+	return SYNFIGTOOL_OK;
+}
+
+#else
+
+int run_shards(std::vector<Shard> &shards)
+{
+	synfig::warning("Worker processes aren't supported on this platform, rendering here");
+	return run_shards_here(shards);
+}
+
+#endif // HAVE_FORK && HAVE_PIPE
+
+//! Renders the jobs that can be split into shards on the workers, and the rest here
+/*!	Single frames are split into tiles when a tile size is given, and
+**	sequences of images into ranges of frames when there are workers.
+**	Without workers the shards are rendered here, one after another. */
+int coordinate(job_list_t &job_list)
+{
+	const int workers(worker_count+worker_commands.size());
+	std::vector<Shard> shards;
+	std::list<Stitch> stitches;
+	job_list_t local;
+
+	for(;job_list.size();job_list.pop_front())
+		if(!split_tiles(job_list.front(),shards,stitches) &&
+		   !(workers && split_frames(job_list.front(),workers,shards)))
+			local.push_back(job_list.front());
+
+	int ret(run_jobs(local));
+	if(ret==SYNFIGTOOL_OK && shards.size())
+		ret=workers ? run_shards(shards) : run_shards_here(shards);
+
+	const int stitched(stitch_frames(stitches,ret==SYNFIGTOOL_OK));
+	return ret==SYNFIGTOOL_OK ? stitched : ret;
+}
+
+/* === E N T R Y P O I N T ================================================= */
+
+int main(int argc, char *argv[])
+{
+	int i;
+	arg_list_t arg_list;
+	job_list_t job_list;
+
+	setlocale(LC_ALL, "");
+
+#ifdef ENABLE_NLS
+	bindtextdomain("synfig", LOCALEDIR);
+	bind_textdomain_codeset("synfig", "UTF-8");
+	textdomain("synfig");
+#endif
+
+	progname=argv[0];
+	Progress p(argv[0]);
+
+	if(!SYNFIG_CHECK_VERSION())
+	{
+		cerr<<_("FATAL: Synfig Version Mismatch")<<endl;
+		return SYNFIGTOOL_BADVERSION;
+	}
+
+	if(argc==1)
+	{
+		display_help(false);
+		return SYNFIGTOOL_BLANK;
 	}
 
+	for(i=1;i<argc;i++)
+		arg_list.push_back(argv[i]);
+
+	if((i=process_global_flags(arg_list)))
+		return i;
+
+	VERBOSE_OUT(1)<<_("verbosity set to ")<<verbosity<<endl;
+	synfig::Main synfig_main(dirname(progname),&p);
+
+	arg_list_t defaults;
+	int ret;
+
+	// Grab the defaults before the first file
+	if ((ret = extract_arg_cluster(arg_list,defaults)) != SYNFIGTOOL_OK)
+	  return ret;
+
+	if(server_mode)
+		return serve(defaults);
+
+	if ((ret = build_jobs(arg_list,defaults,job_list)) != SYNFIGTOOL_OK)
+		return ret;
+
+	if(arg_list.size())
+	{
+		cerr<<_("Unidentified arguments:");
+		for(;arg_list.size();arg_list.pop_front())
+			cerr<<' '<<arg_list.front();
+		cerr<<endl;
+		return SYNFIGTOOL_UNKNOWNARGUMENT;
+	}
+
+	if(!job_list.size())
+	{
+		cerr<<_("Nothing to do!")<<endl;
+		return SYNFIGTOOL_BORED;
+	}
+
+	if(worker_count>0 || worker_commands.size() || tile_size>0)
+		ret=coordinate(job_list);
+	else
+		ret=run_jobs(job_list);
+	if (ret != SYNFIGTOOL_OK)
+		return ret;
+
 	job_list.clear();
+	clear_canvas_cache();
 
 	VERBOSE_OUT(1)<<_("Done.")<<endl;
 
@@ -54,14 +54,14 @@ public:
 	virtual bool
 	error(const String &task)
 	{
-		std::cout<<_("error")<<": "<<task<<std::endl;
+		info_out()<<_("error")<<": "<<task<<std::endl;
 		return true;
 	}
 
 	virtual bool
 	warning(const String &task)
 	{
-		std::cout<<_("warning")<<": "<<task<<std::endl;
+		info_out()<<_("warning")<<": "<<task<<std::endl;
 		return true;
 	}
 
@@ -0,0 +1,245 @@
+/* === S Y N F I G ========================================================= */
+/*!	\file tool/tiles.cpp
+**	\brief Rendering of single frames in separate tiles
+**
+**	$Id$
+**
+**	\legal
+**	This package is free software; you can redistribute it and/or
+**	modify it under the terms of the GNU General Public License as
+**	published by the Free Software Foundation; either version 2 of
+**	the License, or (at your option) any later version.
+**
+**	This package is distributed in the hope that it will be useful,
+**	but WITHOUT ANY WARRANTY; without even the implied warranty of
+**	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+**	General Public License for more details.
+**	\endlegal
+*/
+/* ========================================================================= */
+
+/* === H E A D E R S ======================================================= */
+
+#ifdef USING_PCH
+#	include "pch.h"
+#else
+#ifdef HAVE_CONFIG_H
+#	include <config.h>
+#endif
+
+#include <cmath>
+#include <algorithm>
+#include <synfig/general.h>
+#include <synfig/layer.h>
+#include <synfig/layer_pastecanvas.h>
+#include <synfig/value.h>
+#include "definitions.h"
+#include "tiles.h"
+#endif
+
+using namespace std;
+using namespace etl;
+using namespace synfig;
+
+/* === M A C R O S ========================================================= */
+
+//! Pixels added to every margin, for the kernels that sample around a pixel
+#define TILE_MARGIN_PIXELS	3
+
+//! First int of a tile file, which only reads back the same on a machine
+//! with the same byte order and the same Color, since tiles are raw memory
+#define TILE_FILE_MARK		(0x53590000|(int)sizeof(Color))
+
+/* === G L O B A L S ======================================================= */
+
+//! Parameters of the layers whose effect spreads out from where it is drawn
+static const char *spread_params[][2]=
+{
+	{ "blur",			"size" },
+	{ "shade",			"size" },
+	{ "shade",			"origin" },
+	{ "bevel",			"softness" },
+	{ "bevel",			"depth" },
+	{ "noise_distort",	"displacement" },
+	{ NULL, NULL }
+};
+
+/* === P R O C E D U R E S ================================================= */
+
+//! Adds up how far the layers of \a canvas spread out, in units
+static Real
+canvas_spread(etl::handle<Canvas> canvas)
+{
+	Real spread(0);
+
+	for(Canvas::const_iterator iter=canvas->begin();iter!=canvas->end();++iter)
+	{
+		const Layer::Handle layer(*iter);
+		if(!layer->active())
+			continue;
+
+		etl::handle<Layer_PasteCanvas> paste(etl::handle<Layer_PasteCanvas>::cast_dynamic(layer));
+		if(paste && paste->get_sub_canvas())
+			spread+=canvas_spread(paste->get_sub_canvas())*exp(paste->get_zoom());
+
+		for(int i=0;spread_params[i][0];i++)
+		{
+			if(layer->get_name()!=spread_params[i][0])
+				continue;
+
+			const ValueBase value(layer->get_param(spread_params[i][1]));
+			if(value.get_type()==ValueBase::TYPE_VECTOR)
+			{
+				const Vector vector(value.get(Vector()));
+				spread+=max(fabs(vector[0]),fabs(vector[1]));
+			}
+			else if(value.get_type()==ValueBase::TYPE_REAL)
+				spread+=fabs(value.get(Real()));
+		}
+	}
+
+	return spread;
+}
+
+int
+tile_margin(Canvas::Handle canvas, const RendDesc &desc)
+{
+	canvas->set_time(desc.get_time_start());
+
+	const Real pixel(min(fabs(desc.get_pw()),fabs(desc.get_ph())));
+	const Real spread(canvas_spread(canvas)/pixel);
+
+	// Nothing spreads further than across the whole frame
+	return min((int)ceil(spread),max(desc.get_w(),desc.get_h()))+TILE_MARGIN_PIXELS;
+}
+
+bool
+stitch_tiles(Target_Scanline::Handle target, const vector<Tile> &tiles, ProgressCallback *cb)
+{
+	const RendDesc &desc(target->rend_desc());
+
+	if(!target->init() || !target->start_frame(cb))
+		return false;
+
+	// Tiles come in rows of the same height, from the top row down
+	vector<Tile>::const_iterator row(tiles.begin());
+	while(row!=tiles.end())
+	{
+		vector<Tile>::const_iterator end(row);
+		vector<FILE*> files;
+		bool ok(true);
+
+		for(;end!=tiles.end() && end->y==row->y;++end)
+		{
+			FILE *file(fopen(end->filename.c_str(),"rb"));
+			int header[3];
+			if(!file || fread(header,sizeof(int),3,file)!=3 || header[1]!=end->w || header[2]!=end->h)
+			{
+				synfig::error(_("Unable to read tile %s"),end->filename.c_str());
+				ok=false;
+			}
+			else if(header[0]!=TILE_FILE_MARK)
+			{
+				synfig::error(_("Tile %s was rendered on a machine of another architecture"),end->filename.c_str());
+				ok=false;
+			}
+			files.push_back(file);
+		}
+
+		for(int y=row->y;ok && y<row->y+row->h;y++)
+		{
+			Color *colordata(target->start_scanline(y));
+			if(!colordata)
+				ok=false;
+
+			vector<Tile>::const_iterator tile(row);
+			for(int i=0;ok && tile!=end;++tile,i++)
+				if(fread(colordata+tile->x,sizeof(Color),tile->w,files[i])!=(size_t)tile->w)
+				{
+					synfig::error(_("Unable to read tile %s"),tile->filename.c_str());
+					ok=false;
+				}
+
+			if(ok && target->get_remove_alpha())
+				for(int x=0;x<desc.get_w();x++)
+					colordata[x]=Color::blend(colordata[x],desc.get_bg_color(),1.0f);
+
+			if(ok && !target->end_scanline())
+				ok=false;
+
+			if(ok && cb && !cb->amount_complete(y,desc.get_h()))
+				ok=false;
+		}
+
+		for(vector<FILE*>::iterator iter=files.begin();iter!=files.end();++iter)
+			if(*iter)
+				fclose(*iter);
+
+		if(!ok)
+			return false;
+		row=end;
+	}
+
+	target->end_frame();
+	return true;
+}
+
+/* === M E T H O D S ======================================================= */
+
+TileTarget::TileTarget(const String &filename, int x, int y, int w, int h):
+	filename(filename),
+	x(x),
+	y(y),
+	w(w),
+	h(h),
+	file(0),
+	scanline(0)
+{
+}
+
+TileTarget::~TileTarget()
+{
+	if(file)
+		fclose(file);
+}
+
+bool
+TileTarget::start_frame(ProgressCallback */*cb*/)
+{
+	if(file)
+		fclose(file);
+
+	file=fopen(filename.c_str(),"wb");
+	if(!file)
+	{
+		synfig::error(_("Unable to open %s"),filename.c_str());
+		return false;
+	}
+
+	const int header[3]={ TILE_FILE_MARK, w, h };
+	buffer.resize(desc.get_w());
+	return fwrite(header,sizeof(int),3,file)==3;
+}
+
+void
+TileTarget::end_frame()
+{
+	if(file)
+		fclose(file);
+	file=0;
+}
+
+Color *
+TileTarget::start_scanline(int scanline)
+{
+	this->scanline=scanline;
+	return &buffer[0];
+}
+
+bool
+TileTarget::end_scanline()
+{
+	if(scanline<y || scanline>=y+h)
+		return true;
+	return fwrite(&buffer[x],sizeof(Color),w,file)==(size_t)w;
+}
@@ -0,0 +1,76 @@
+/* === S Y N F I G ========================================================= */
+/*!	\file tool/tiles.h
+**	\brief Rendering of single frames in separate tiles
+**
+**	$Id$
+**
+**	\legal
+**	This package is free software; you can redistribute it and/or
+**	modify it under the terms of the GNU General Public License as
+**	published by the Free Software Foundation; either version 2 of
+**	the License, or (at your option) any later version.
+**
+**	This package is distributed in the hope that it will be useful,
+**	but WITHOUT ANY WARRANTY; without even the implied warranty of
+**	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+**	General Public License for more details.
+**	\endlegal
+*/
+/* ========================================================================= */
+
+#ifndef __SYNFIG_TILES_H
+#define __SYNFIG_TILES_H
+
+#include <cstdio>
+#include <vector>
+#include <synfig/string.h>
+#include <synfig/canvas.h>
+#include <synfig/renddesc.h>
+#include <synfig/target_scanline.h>
+
+//! A rectangle of a frame, in pixels, rendered apart into a file of its own
+struct Tile
+{
+	int x, y, w, h;
+	synfig::String filename;
+};
+
+//! Returns how many pixels around a tile have to be rendered along with it
+/*!	Filters such as blurs and shades spread what is drawn over the
+**	neighbouring pixels, so a tile rendered apart would miss what spreads
+**	into it from the pixels around it. The margin adds up the spread of
+**	every such layer of \a canvas at the time of \a desc. */
+int tile_margin(synfig::Canvas::Handle canvas, const synfig::RendDesc &desc);
+
+//! Target writing a tile to a file of raw colors, leaving out the margin rendered around it
+/*!	The colors are written as they are in memory, so the tiles can only
+**	be stitched on a machine of the same architecture, which
+**	stitch_tiles() checks. Workers started with --worker-command on
+**	other machines write their tiles to their own filesystem, so they
+**	need to share the directory of the output file with this one. */
+class TileTarget : public synfig::Target_Scanline
+{
+	synfig::String filename;
+	//! Position of the tile within the rendered window, and its size
+	int x, y, w, h;
+
+	FILE *file;
+	std::vector<synfig::Color> buffer;
+	int scanline;
+
+public:
+	TileTarget(const synfig::String &filename, int x, int y, int w, int h);
+	virtual ~TileTarget();
+
+	virtual bool start_frame(synfig::ProgressCallback *cb=NULL);
+	virtual void end_frame();
+	virtual synfig::Color *start_scanline(int scanline);
+	virtual bool end_scanline();
+};
+
+//! Writes the frame made up of \a tiles to \a target
+/*!	The tiles are read back one scanline at a time, so no more than a
+**	scanline of the frame is ever held in memory. */
+bool stitch_tiles(synfig::Target_Scanline::Handle target, const std::vector<Tile> &tiles, synfig::ProgressCallback *cb=NULL);
+
+#endif
@@ -64,6 +64,7 @@
 
 #include <synfig/loadcanvas.h>
 #include <synfig/savecanvas.h>
+#include <synfig/module.h>
 
 #include "app.h"
 #include "dialogs/about.h"
@@ -1198,6 +1199,9 @@ App::App(int *argc, char ***argv):
 		throw;
 	}
 
+	// The menus and dialogs list whole books, so every module is needed here
+	synfig::Module::load_pending(&synfig_init_cb);
+
 	// add the preferences to the settings
 	synfigapp::Main::settings().add_domain(&_preferences,"pref");
 
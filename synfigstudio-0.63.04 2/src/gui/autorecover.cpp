@@ -220,7 +220,13 @@ AutoRecover::auto_backup()
 
 				Canvas::Handle canvas((*iter)->get_canvas());
 				file<<canvas->get_file_name()<<endl;
+#ifdef HAVE_FORK
 				save_canvas(get_shadow_file_name(canvas->get_file_name()),canvas);
+#else
+				// without a process of our own to save in, at least
+				// leave the compressing and writing to another thread
+				save_canvas_in_background(get_shadow_file_name(canvas->get_file_name()),canvas);
+#endif
 				savecount++;
 			}
 
@@ -317,6 +323,9 @@ AutoRecover::normal_shutdown()
 	// Turn off the timer
 	auto_backup_connect.disconnect();
 
+	// Let any backup still being written finish first
+	wait_for_saves();
+
 	std::string filename=App::get_config_file("autorecovery");
 	remove(filename.c_str());
 }
@@ -325,5 +334,8 @@ void
 AutoRecover::clear_backup(synfig::Canvas::Handle canvas)
 {
 	if(canvas)
+	{
+		wait_for_saves();
 		remove(get_shadow_file_name(canvas->get_file_name()).c_str());
+	}
 }
@@ -197,6 +197,7 @@ studio::Instance::save_as(const synfig::String &file_name)
 		for(iter=canvas_view_list().begin();iter!=canvas_view_list().end();iter++)
 			(*iter)->render_settings.set_entry_filename();
 		App::add_recent_file(etl::handle<Instance>(this));
+		watch_save();
 		return true;
 	}
 	return false;
@@ -223,6 +224,7 @@ studio::Instance::save()
 	if (synfigapp::Instance::save())
 	{
 		App::add_recent_file(etl::handle<Instance>(this));
+		watch_save();
 		return STATUS_OK;
 	}
 	string msg(strprintf(_("Unable to save to '%s'"), get_file_name().c_str()));
@@ -230,6 +232,40 @@ studio::Instance::save()
 	return STATUS_ERROR;
 }
 
+bool
+studio::Instance::finish_save()
+{
+	if (synfigapp::Instance::wait_for_save())
+		return true;
+
+	string msg(strprintf(_("Unable to save to '%s'"), get_file_name().c_str()));
+	App::dialog_error_blocking(_("Save - Error"), msg.c_str());
+	return false;
+}
+
+void
+studio::Instance::watch_save()
+{
+	// the file is written in the background, so check back on it
+	Glib::signal_timeout().connect(
+		sigc::bind(
+			sigc::ptr_fun(&Instance::_check_save),
+			etl::handle<Instance>(this)
+		)
+		,250
+	);
+}
+
+bool
+studio::Instance::_check_save(etl::handle<Instance> instance)
+{
+	if (saves_pending())
+		return true;
+
+	instance->finish_save();
+	return false;
+}
+
 // the filename will be set to "Synfig Animation 1" or some such when first created
 // and will be changed to an absolute path once it has been saved
 // so if it still begins with "Synfig Animation " then we don't have a real filename yet
@@ -293,7 +329,7 @@ studio::Instance::dialog_save_as()
 		try
 		{
 			String ext(filename_extension(filename));
-			if(ext!=".sif" && ext!=".sifz" && !App::dialog_yes_no(_("Unknown extension"),
+			if(ext!=".sif" && ext!=".sifz" && ext!=CANVAS_SECTIONS_EXTENSION && !App::dialog_yes_no(_("Unknown extension"),
 				_("You have given the file name an extension\nwhich I do not recognize. Are you sure this is what you want?")))
 				continue;
 		}
@@ -450,6 +486,8 @@ Instance::dialog_cvs_commit()
 			if(!App::dialog_yes_no(_("CVS Commit"), _("This will save any changes you have made. Are you sure?")))
 				return;
 			save();
+			if(!finish_save())
+				return;
 		}
 
 		if(!is_modified())
@@ -519,6 +557,8 @@ Instance::dialog_cvs_update()
 			if(!App::dialog_yes_no(_("CVS Update"), _("This will save any changes you have made. Are you sure?")))
 				return;
 			save();
+			if(!finish_save())
+				return;
 		}
 		OneMoment one_moment;
 		time_t oldtime=get_original_timestamp();
@@ -580,6 +620,9 @@ Instance::_revert(Instance *instance)
 
 	String filename(instance->get_file_name());
 
+	// what is reopened has to be on disk first
+	instance->finish_save();
+
 	Canvas::Handle canvas(instance->get_canvas());
 
 	instance->close();
@@ -643,7 +686,7 @@ Instance::safe_close()
 			if(answer==synfigapp::UIInterface::RESPONSE_YES)
 			{
 				enum Status status = save();
-				if (status == STATUS_OK) break;
+				if (status == STATUS_OK && finish_save()) break;
 				else if (status == STATUS_CANCEL) return false;
 			}
 			if(answer==synfigapp::UIInterface::RESPONSE_NO)
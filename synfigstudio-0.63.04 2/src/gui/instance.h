@@ -134,6 +134,10 @@ private:
 	void set_redo_status(bool x);
 
 	static void _revert(Instance *);
+	static bool _check_save(etl::handle<Instance>);
+
+	//! Reports on the file being saved in the background once it is written
+	void watch_save();
 
 protected:
 
@@ -189,6 +193,11 @@ public:
 
 	Status save();
 
+	//! Waits for the file being saved in the background to be written
+	/*!	Tells the user if it couldn't be.
+	**	\return \c true if it was written */
+	bool finish_save();
+
 	void dialog_cvs_commit();
 
 	void dialog_cvs_add();
@@ -262,7 +262,35 @@ struct studio::Widget_Curves::CurveStruct : sigc::trackable
 		// Since that didn't work, we now need
 		// to go ahead and figure out what the
 		// actual value is at that time.
-		ValueBase value(value_desc.get_value(time));
+		if(!store_value(time, value_desc.get_value(time)))
+			return 0;
+
+		return -channels[chan].values[time];
+	}
+
+	//! Evaluates the value at all the times not yet cached in one call
+	void fill_values(const std::vector<synfig::Real> &time_list, synfig::Real tolerance)
+	{
+		std::map<synfig::Real,synfig::Real>::iterator iter;
+		std::vector<Time> times;
+		std::vector<ValueBase> values;
+
+		for(std::vector<synfig::Real>::const_iterator t=time_list.begin();t!=time_list.end();++t)
+		{
+			iter=channels[0].values.lower_bound(*t);
+			if(iter==channels[0].values.end() || iter->first-*t>tolerance)
+				times.push_back(*t);
+		}
+		if(times.empty())
+			return;
+
+		value_desc.get_values(times, values);
+		for(std::vector<Time>::size_type i=0;i<times.size();i++)
+			store_value(times[i], values[i]);
+	}
+
+	bool store_value(synfig::Real time, const ValueBase &value)
+	{
 		switch(value.get_type())
 		{
 			case ValueBase::TYPE_REAL:
@@ -306,10 +334,10 @@ struct studio::Widget_Curves::CurveStruct : sigc::trackable
 				channels[1].values[time]=value.get(WidthPoint()).get_width();
 				break;
 			default:
-				return 0;
+				return false;
 		}
 
-		return -channels[chan].values[time];
+		return true;
 	}
 
 	static bool is_not_supported(const synfigapp::ValueDesc& x)
@@ -564,6 +592,11 @@ Widget_Curves::redraw(GdkEventExpose */*bleh*/)
 		for(i=0;i<channels;i++)
 			points[i].clear();
 
+		std::vector<Real> times;
+		for(i=0,t=t_begin;i<w;i++,t+=dt)
+			times.push_back(t);
+		curve_iter->fill_values(times,dt);
+
 		for(i=0,t=t_begin;i<w;i++,t+=dt)
 		{
 			for(int chan=0;chan<channels;chan++)
@@ -88,9 +88,12 @@ using namespace synfigapp;
 CanvasInterface::CanvasInterface(etl::loose_handle<Instance> instance,etl::handle<synfig::Canvas> canvas):
 	instance_(instance),
 	canvas_(canvas),
-	cur_time_(canvas->rend_desc().get_frame_start()),
 	mode_(MODE_NORMAL|MODE_ANIMATE_PAST|MODE_ANIMATE_FUTURE)
 {
+	// A child canvas gets its contents, rend_desc included, once it is worked on
+	canvas->load_deferred();
+	cur_time_=canvas->rend_desc().get_frame_start();
+
 	set_selection_manager(get_instance()->get_selection_manager());
 	set_ui_interface(get_instance()->get_ui_interface());
 }
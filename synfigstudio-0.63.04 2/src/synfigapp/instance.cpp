@@ -156,7 +156,7 @@ Instance::find_canvas_interface(synfig::Canvas::Handle canvas)
 bool
 Instance::save()const
 {
-	bool ret=save_canvas(get_file_name(),canvas_);
+	bool ret=save_canvas_in_background(get_file_name(),canvas_);
 	if(ret)
 	{
 		reset_action_count();
@@ -174,7 +174,7 @@ Instance::save_as(const synfig::String &file_name)
 
 	set_file_name(file_name);
 
-	ret=save_canvas(file_name,canvas_);
+	ret=save_canvas_in_background(file_name,canvas_);
 
 	if(ret)
 	{
@@ -188,3 +188,14 @@ Instance::save_as(const synfig::String &file_name)
 
 	return ret;
 }
+
+bool
+Instance::wait_for_save()const
+{
+	if(synfig::wait_for_save(get_file_name()))
+		return true;
+
+	// the file on disk isn't what we have, so we aren't saved after all
+	inc_action_count();
+	return false;
+}
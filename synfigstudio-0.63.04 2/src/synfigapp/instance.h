@@ -106,10 +106,19 @@ public:
 	synfig::Canvas::Handle get_canvas()const { return canvas_; }
 
 	//! Saves the instance to filename_
+	/*!	The canvas is encoded before this returns, but the file is
+	**	written in the background. \see wait_for_save() */
 	bool save()const;
 
+	//! Saves the instance to \a filename, which becomes its filename
+	/*!	\see save(), wait_for_save() */
 	bool save_as(const synfig::String &filename);
 
+	//! Waits for the file of the last save() or save_as() to be written
+	/*!	\return \c false if it couldn't be, in which case the
+	**	instance is marked as having unsaved changes again */
+	bool wait_for_save()const;
+
 public:	// Interfaces to internal information
 	sigc::signal<void>& signal_filename_changed() { return signal_filename_changed_; }
 	sigc::signal<void>& signal_saved() { return signal_saved_; }
@@ -184,6 +184,17 @@ public:
 		return synfig::ValueBase();
 	}
 
+	//! Returns the values at each of the times in \a times, in one call
+	/*!	\see get_value(), synfig::ValueNode::get_values() */
+	void
+	get_values(const std::vector<synfig::Time> &times, std::vector<synfig::ValueBase> &values)const
+	{
+		if(is_value_node() && get_value_node() && !parent_is_value_node_const())
+			get_value_node()->get_values(times, values);
+		else
+			values.assign(times.size(), get_value(times.empty() ? synfig::Time(0) : times.front()));
+	}
+
 	synfig::ValueBase::Type
 	get_value_type()const
 	{